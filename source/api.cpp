@@ -0,0 +1,356 @@
+#include "api.h"
+
+// Standard includes
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <utility>
+
+// Boost includes
+// HACK: Need to define this macro to tell Boost not to use deprecated
+// Boost.System constructs which result in unused-variable errors.
+#ifndef BOOST_SYSTEM_NO_DEPRECATED
+#define BOOST_SYSTEM_NO_DEPRECATED 1
+#endif
+#include <boost/any.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+// ROOT includes
+#include <TROOT.h>
+#include <TSystem.h>
+#include <TFile.h>
+
+// HDF5 includes
+#include <hdf5.h>
+
+// root2hdf5 includes
+#include "options.h"
+#include "convert.h"
+#include "plugin.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// Boost namespace aliases
+namespace fs = boost::filesystem;
+namespace po = boost::program_options;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::api;
+using namespace root2hdf5::convert;
+using namespace root2hdf5::tree;
+
+
+// Private namespace members
+namespace root2hdf5
+{
+    namespace api
+    {
+        // Sets an option in the global options map
+        void set_option(const string & name, const boost::any & value);
+
+        // Converts an already-open input file into an in-memory HDF5 file
+        // which is discarded afterwards
+        bool convert_to_memory(const string & input_url,
+                               const block_sink & sink);
+
+        // A stream buffer which hands each complete line written to it to a
+        // message handler
+        class message_buffer : public streambuf
+        {
+        public:
+            message_buffer(const message_handler & handler)
+                : _handler(handler)
+            {
+            }
+            ~message_buffer()
+            {
+                if(!_line.empty())
+                {
+                    _handler(_line);
+                }
+            }
+
+        protected:
+            int overflow(int c)
+            {
+                if(c == '\n')
+                {
+                    _handler(_line);
+                    _line.clear();
+                }
+                else if(c != EOF)
+                {
+                    _line.push_back((char)c);
+                }
+
+                return c == EOF ? 0 : c;
+            }
+
+        private:
+            message_handler _handler;
+            string _line;
+        };
+
+        // Redirects the standard streams for the duration of a conversion,
+        // collecting stderr (or handing it to the handler, if there is one)
+        // and passing stdout through only if requested
+        struct stream_capture
+        {
+            stream_capture(bool pass_output, const message_handler & handler)
+                : forwarded(handler ? new message_buffer(handler) : NULL),
+                  errors(cerr.rdbuf(forwarded
+                                    ? (streambuf *)forwarded.get()
+                                    : (streambuf *)captured.rdbuf())),
+                  output(pass_output ? NULL : cout.rdbuf(NULL))
+            {
+            }
+            ~stream_capture()
+            {
+                cerr.rdbuf(errors);
+                if(output != NULL)
+                {
+                    cout.rdbuf(output);
+                    cout.clear();
+                }
+            }
+
+            stringstream captured;
+            std::unique_ptr<message_buffer> forwarded;
+            streambuf *errors;
+            streambuf *output;
+        };
+    }
+}
+
+
+root2hdf5::api::converter_config::converter_config()
+    : ignore_friends(false),
+      statistics(false),
+      no_cache(false),
+      progress(false),
+      profile_branches(0),
+      split_by_prefix(false),
+      split_row_bytes(0),
+      no_bulk_read(false),
+      big_endian(false),
+      pack_booleans(false),
+      read_threads(0),
+      max_output_size(0),
+      overwrite(false),
+      verbose(false)
+{
+}
+
+
+void root2hdf5::api::set_option(const string & name,
+                                const boost::any & value)
+{
+    root2hdf5::options::options.insert(
+        make_pair(name, po::variable_value(value, false))
+    );
+}
+
+
+root2hdf5::api::converter::converter(const converter_config & config)
+    : _config(config)
+{
+    // Do the same one-time ROOT setup as the command line tool
+    static bool root_ready = false;
+    if(!root_ready)
+    {
+        gROOT->SetBatch(kTRUE);
+        gSystem->SetBuildDir(fs::temp_directory_path().native().c_str());
+        root_ready = true;
+    }
+}
+
+
+const converter_config & root2hdf5::api::converter::config() const
+{
+    return _config;
+}
+
+
+void root2hdf5::api::converter::apply_config() const
+{
+    // Flags are stored without a value, just like the command line parser
+    // stores them
+    root2hdf5::options::options.clear();
+    if(!_config.index_columns.empty())
+    {
+        set_option("index", _config.index_columns);
+    }
+    if(_config.ignore_friends)
+    {
+        set_option("ignore-friends", boost::any());
+    }
+    if(!_config.entry_list.empty())
+    {
+        set_option("entry-list", _config.entry_list);
+    }
+    if(!_config.entry_list_file.empty())
+    {
+        set_option("entry-list-file", _config.entry_list_file);
+    }
+    if(_config.statistics)
+    {
+        set_option("statistics", boost::any());
+    }
+    if(!_config.bloom_filter_columns.empty())
+    {
+        set_option("bloom-filter", _config.bloom_filter_columns);
+    }
+    if(!_config.cache_dir.empty())
+    {
+        set_option("cache-dir", _config.cache_dir);
+    }
+    if(_config.no_cache)
+    {
+        set_option("no-cache", boost::any());
+    }
+    if(!_config.status_file.empty())
+    {
+        set_option("status-file", _config.status_file);
+    }
+    if(_config.profile_branches > 0)
+    {
+        set_option("profile-branches", _config.profile_branches);
+    }
+    if(_config.split_by_prefix)
+    {
+        set_option("split-by-prefix", boost::any());
+    }
+    if(_config.split_row_bytes > 0)
+    {
+        set_option("split-row-bytes", _config.split_row_bytes);
+    }
+    if(_config.no_bulk_read)
+    {
+        set_option("no-bulk-read", boost::any());
+    }
+    if(_config.big_endian)
+    {
+        set_option("big-endian", boost::any());
+    }
+    if(_config.pack_booleans)
+    {
+        set_option("pack-booleans", boost::any());
+    }
+    if(_config.read_threads > 0)
+    {
+        set_option("read-threads", _config.read_threads);
+    }
+    if(_config.max_output_size > 0)
+    {
+        set_option("max-output-size", _config.max_output_size);
+    }
+    if(!_config.converter_plugin_dir.empty())
+    {
+        set_option("converter-plugin-dir", _config.converter_plugin_dir);
+    }
+    if(_config.overwrite)
+    {
+        set_option("overwrite", boost::any());
+    }
+
+    // Always print diagnostics, since they are collected into the result
+    root2hdf5::options::verbose = true;
+}
+
+
+bool root2hdf5::api::convert_to_memory(const string & input_url,
+                                       const block_sink & sink)
+{
+    TFile *input_file = TFile::Open(input_url.c_str(), "READ");
+    if(input_file == NULL)
+    {
+        cerr << "Unable to open input file: " << input_url << endl;
+        return false;
+    }
+
+    // Create a core file without a backing store, so nothing touches disk
+    hid_t access = H5Pcreate(H5P_FILE_ACCESS);
+    hid_t output_file = -1;
+    if(access >= 0 && H5Pset_fapl_core(access, 1024 * 1024, 0) >= 0)
+    {
+        output_file = H5Fcreate("root2hdf5-sink",
+                                H5F_ACC_TRUNC,
+                                H5P_DEFAULT,
+                                access);
+    }
+    if(access >= 0)
+    {
+        H5Pclose(access);
+    }
+    if(output_file < 0)
+    {
+        cerr << "ERROR: Unable to create in-memory HDF5 file" << endl;
+        input_file->Close();
+        delete input_file;
+        return false;
+    }
+
+    bool success = root2hdf5::convert::convert(input_file,
+                                               output_file,
+                                               sink);
+
+    if(H5Fclose(output_file) < 0)
+    {
+        cerr << "ERROR: Closing in-memory HDF5 file failed" << endl;
+        success = false;
+    }
+    input_file->Close();
+    delete input_file;
+
+    return success;
+}
+
+
+conversion_result
+root2hdf5::api::converter::convert_file(const string & input_url,
+                                        const string & output_url)
+{
+    return convert_file(input_url, output_url, block_sink());
+}
+
+
+conversion_result
+root2hdf5::api::converter::convert_file(const string & input_url,
+                                        const string & output_url,
+                                        const block_sink & sink)
+{
+    apply_config();
+
+    conversion_result result;
+    {
+        stream_capture capture(_config.verbose, _config.on_message);
+        if(_config.progress)
+        {
+            cerr << "ERROR: Terminal progress isn't supported through the "
+                 << "API - use a status file instead" << endl;
+            result.success = false;
+        }
+        else if(!root2hdf5::plugin::load_converter_plugins())
+        {
+            result.success = false;
+        }
+        else if(output_url.empty())
+        {
+            block_sink memory_sink(sink);
+            memory_sink.write_dataset = false;
+            result.success = convert_to_memory(input_url, memory_sink);
+        }
+        else
+        {
+            result.success = root2hdf5::convert::convert_file(input_url,
+                                                              output_url,
+                                                              sink);
+        }
+        result.messages = capture.captured.str();
+    }
+
+    return result;
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+// Standard includes
+#include <functional>
+#include <string>
+
+// root2hdf5 includes
+#include "tree.h"
+
+
+namespace root2hdf5
+{
+    namespace api
+    {
+        // Callback type which receives each error or warning message line
+        typedef std::function<void(const std::string &)> message_handler;
+
+        // Settings for a converter, mirroring the command line options
+        struct converter_config
+        {
+            // Comma-separated leaves to index each tree by (--index)
+            std::string index_columns;
+
+            // Don't merge friend trees (--ignore-friends)
+            bool ignore_friends;
+
+            // Only convert the entries in this TEntryList (--entry-list),
+            // optionally looked up in a side file (--entry-list-file)
+            std::string entry_list;
+            std::string entry_list_file;
+
+            // Write per-chunk statistics (--statistics), with bloom filters
+            // for the comma-separated columns (--bloom-filter)
+            bool statistics;
+            std::string bloom_filter_columns;
+
+            // Persistent cache location (--cache-dir), or disable it
+            // entirely (--no-cache)
+            std::string cache_dir;
+            bool no_cache;
+
+            // Progress reporting (--progress and --status-file).  Terminal
+            // progress redraws a line on stderr, which the API captures, so
+            // conversions with progress set are refused; use the status file
+            // instead.
+            bool progress;
+            std::string status_file;
+
+            // Number of branches to profile, or 0 not to (--profile-branches)
+            unsigned profile_branches;
+
+            // Split each tree's columns into datasets by name prefix
+            // (--split-by-prefix), or into datasets of about this many bytes
+            // per row, if non-zero (--split-row-bytes)
+            bool split_by_prefix;
+            unsigned split_row_bytes;
+
+            // Read every branch entry by entry (--no-bulk-read)
+            bool no_bulk_read;
+
+            // Keep bulk-read scalars in ROOT's big-endian byte order
+            // (--big-endian)
+            bool big_endian;
+
+            // Store boolean leaves as bits of one bitfield column
+            // (--pack-booleans)
+            bool pack_booleans;
+
+            // Number of threads to read and unzip branches with, or 0 to
+            // read on the calling thread (--read-threads)
+            unsigned read_threads;
+
+            // Roll tree data over into part files of at most this many MB,
+            // or 0 for a single output file (--max-output-size)
+            unsigned max_output_size;
+
+            // Directory of leaf converter plugins to load before converting
+            // (--converter-plugin-dir)
+            std::string converter_plugin_dir;
+
+            // Overwrite existing output files (--overwrite)
+            bool overwrite;
+
+            // Pass informational messages through to stdout (--verbose).
+            // Error and warning messages are always collected in the result.
+            bool verbose;
+
+            // If set, error and warning messages are handed to this callback
+            // a line at a time as they are printed, rather than collected in
+            // the result
+            message_handler on_message;
+
+            converter_config();
+        };
+
+        // The outcome of a conversion.  The messages hold any errors and
+        // warnings which were printed while converting.
+        struct conversion_result
+        {
+            bool success;
+            std::string messages;
+        };
+
+        // The sink which receives the rows of each tree as they are
+        // converted
+        typedef root2hdf5::tree::tree_sink block_sink;
+
+        // A reusable converter for embedding root2hdf5 in other programs.
+        // ROOT is set up once, when the first converter is created, and
+        // every conversion reports failure through its result rather than
+        // exiting.  The conversion code keeps its settings and caches in
+        // process-wide state, so only one conversion may run at a time.
+        // Its diagnostics are printed to the standard streams, so while a
+        // conversion runs, std::cerr (and std::cout, unless verbose) are
+        // redirected for the whole process.
+        class converter
+        {
+        public:
+            converter(const converter_config & config = converter_config());
+
+            // Returns the configuration
+            const converter_config & config() const;
+
+            // Converts the ROOT file at input_url into a new HDF5 file at
+            // output_url
+            conversion_result convert_file(const std::string & input_url,
+                                           const std::string & output_url);
+
+            // Converts the ROOT file at input_url, handing the rows of each
+            // tree to the sink as well as writing them to a new HDF5 file at
+            // output_url.  If output_url is empty, no file is written: the
+            // trees' datasets are skipped, and the side datasets (index,
+            // statistics and string dictionaries) are only kept in memory for
+            // the duration of the conversion.
+            conversion_result convert_file(const std::string & input_url,
+                                           const std::string & output_url,
+                                           const block_sink & sink);
+
+        private:
+            // Installs the configuration as the global options
+            void apply_config() const;
+
+            converter_config _config;
+        };
+    }
+}
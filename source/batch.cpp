@@ -0,0 +1,341 @@
+#include "batch.h"
+
+// C Standard includes
+#include <cerrno>
+#include <cstdlib>
+
+// POSIX includes
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Standard includes
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+// Boost includes
+// HACK: Need to define this macro to tell Boost not to use deprecated
+// Boost.System constructs which result in unused-variable errors.
+#ifndef BOOST_SYSTEM_NO_DEPRECATED
+#define BOOST_SYSTEM_NO_DEPRECATED 1
+#endif
+#include <boost/filesystem.hpp>
+
+// ROOT includes
+#include <TFile.h>
+
+// root2hdf5 includes
+#include "options.h"
+#include "convert.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// Boost namespace aliases
+namespace fs = boost::filesystem;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::batch;
+using namespace root2hdf5::options;
+using namespace root2hdf5::convert;
+
+
+// Private namespace members
+namespace root2hdf5
+{
+    namespace batch
+    {
+        // The record a worker sends back to the parent for each finished job.
+        // It is small enough that writes of it to a pipe are atomic, so
+        // workers can share a single result pipe.
+        struct job_result
+        {
+            size_t index;
+            bool success;
+            double seconds;
+            unsigned long long input_bytes;
+            unsigned long long output_bytes;
+        };
+
+        // Returns the size of a local file, or 0 if it isn't a local file
+        unsigned long long local_file_size(const string & url);
+
+        // The loop run by each worker process.  Never returns.
+        void run_worker(const vector<job> & jobs,
+                        size_t *next_job,
+                        int result_descriptor);
+
+        // Reads a complete job_result from the descriptor, retrying on
+        // interruption.  Returns false at end-of-file.
+        bool read_result(int descriptor, job_result & result);
+    }
+}
+
+
+bool root2hdf5::batch::read_manifest(const string & path, vector<job> & jobs)
+{
+    ifstream manifest(path.c_str());
+    if(!manifest)
+    {
+        cerr << "ERROR: Unable to open batch manifest \"" << path << "\""
+             << endl;
+        return false;
+    }
+
+    string line;
+    unsigned line_number = 0;
+    while(getline(manifest, line))
+    {
+        line_number++;
+
+        // Parse out the paths, skipping blank and comment lines
+        stringstream parser(line);
+        job new_job;
+        if(!(parser >> new_job.input_url) || new_job.input_url[0] == '#')
+        {
+            continue;
+        }
+        string extra;
+        if(!(parser >> new_job.output_url) || (parser >> extra))
+        {
+            cerr << "ERROR: Malformed line " << line_number
+                 << " in batch manifest \"" << path << "\"" << endl;
+            return false;
+        }
+
+        jobs.push_back(new_job);
+    }
+
+    return true;
+}
+
+
+unsigned long long root2hdf5::batch::local_file_size(const string & url)
+{
+    boost::system::error_code error;
+    unsigned long long size = fs::file_size(fs::path(url), error);
+    return error ? 0 : size;
+}
+
+
+void root2hdf5::batch::run_worker(const vector<job> & jobs,
+                                  size_t *next_job,
+                                  int result_descriptor)
+{
+    while(true)
+    {
+        // Claim the next job from the shared queue
+        size_t index = __sync_fetch_and_add(next_job, 1);
+        if(index >= jobs.size())
+        {
+            break;
+        }
+
+        // Convert it and time it
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        bool success = convert_file(jobs[index].input_url,
+                                    jobs[index].output_url);
+        chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+
+        // Report back
+        job_result result;
+        result.index = index;
+        result.success = success;
+        result.seconds = elapsed.count();
+        result.input_bytes = local_file_size(jobs[index].input_url);
+        result.output_bytes = success
+                              ? local_file_size(jobs[index].output_url)
+                              : 0;
+        if(write(result_descriptor, &result, sizeof(result))
+           != (ssize_t)sizeof(result))
+        {
+            break;
+        }
+    }
+
+    // Skip static destructors and ROOT's exit handlers, which belong to the
+    // parent
+    cout.flush();
+    cerr.flush();
+    _exit(EXIT_SUCCESS);
+}
+
+
+bool root2hdf5::batch::read_result(int descriptor, job_result & result)
+{
+    size_t received = 0;
+    while(received < sizeof(result))
+    {
+        ssize_t count = read(descriptor,
+                             ((char *)&result) + received,
+                             sizeof(result) - received);
+        if(count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if(count <= 0)
+        {
+            return false;
+        }
+        received += count;
+    }
+
+    return true;
+}
+
+
+bool root2hdf5::batch::run_batch(const vector<job> & jobs, unsigned n_workers)
+{
+    if(jobs.empty())
+    {
+        return true;
+    }
+
+    // Warm the caches in the parent so every worker inherits them.  Failure
+    // here isn't fatal, since the workers will report any real problems.
+    TFile *warm_file = TFile::Open(jobs[0].input_url.c_str(), "READ");
+    if(warm_file != NULL)
+    {
+        if(!prepare(warm_file) && verbose)
+        {
+            cerr << "WARNING: Unable to prepare conversion of \""
+                 << jobs[0].input_url << "\"" << endl;
+        }
+        warm_file->Close();
+        delete warm_file;
+        warm_file = NULL;
+    }
+
+    // Create the shared queue, which is just the index of the next job to be
+    // claimed, living in memory shared with the workers
+    size_t *next_job = (size_t *)mmap(NULL,
+                                      sizeof(size_t),
+                                      PROT_READ | PROT_WRITE,
+                                      MAP_SHARED | MAP_ANONYMOUS,
+                                      -1,
+                                      0);
+    if(next_job == MAP_FAILED)
+    {
+        cerr << "ERROR: Unable to create batch job queue" << endl;
+        return false;
+    }
+    *next_job = 0;
+
+    // Create the pipe which workers report results on
+    int result_pipe[2];
+    if(pipe(result_pipe) != 0)
+    {
+        cerr << "ERROR: Unable to create batch result pipe" << endl;
+        munmap(next_job, sizeof(size_t));
+        return false;
+    }
+
+    // Fork the workers, flushing first so buffered output isn't duplicated
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    if(n_workers == 0)
+    {
+        n_workers = 1;
+    }
+    if(n_workers > jobs.size())
+    {
+        n_workers = jobs.size();
+    }
+    cout.flush();
+    cerr.flush();
+    vector<pid_t> workers;
+    for(unsigned i = 0; i < n_workers; i++)
+    {
+        pid_t pid = fork();
+        if(pid == 0)
+        {
+            close(result_pipe[0]);
+            run_worker(jobs, next_job, result_pipe[1]);
+        }
+        else if(pid < 0)
+        {
+            cerr << "WARNING: Unable to fork batch worker" << endl;
+            break;
+        }
+
+        workers.push_back(pid);
+    }
+    close(result_pipe[1]);
+
+    // Report results as they arrive.  The read will hit end-of-file once every
+    // worker has exited and closed its end of the pipe.
+    vector<bool> finished(jobs.size(), false);
+    size_t n_finished = 0;
+    size_t n_failed = 0;
+    unsigned long long total_input_bytes = 0;
+    job_result result;
+    while(!workers.empty() && read_result(result_pipe[0], result))
+    {
+        n_finished++;
+        finished[result.index] = true;
+        total_input_bytes += result.input_bytes;
+        if(!result.success)
+        {
+            n_failed++;
+        }
+
+        double rate = result.seconds > 0.0
+                      ? result.input_bytes / result.seconds / 1048576.0
+                      : 0.0;
+        cout << "[" << n_finished << "/" << jobs.size() << "] "
+             << (result.success ? "ok     " : "FAILED ")
+             << jobs[result.index].input_url << " -> "
+             << jobs[result.index].output_url << " ("
+             << fixed << setprecision(1) << result.seconds << " s, "
+             << setprecision(1) << rate << " MB/s)" << endl;
+    }
+    close(result_pipe[0]);
+
+    // Reap the workers
+    bool workers_ok = true;
+    for(auto it = workers.begin(); it != workers.end(); it++)
+    {
+        int status = 0;
+        while(waitpid(*it, &status, 0) < 0 && errno == EINTR)
+        {
+        }
+        if(!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+        {
+            workers_ok = false;
+        }
+    }
+    munmap(next_job, sizeof(size_t));
+
+    // Anything without a result was lost with a crashed worker (or never
+    // claimed, if no worker could be forked)
+    for(size_t i = 0; i < jobs.size(); i++)
+    {
+        if(!finished[i])
+        {
+            n_failed++;
+            cout << "FAILED " << jobs[i].input_url << " -> "
+                 << jobs[i].output_url << " (worker exited abnormally)"
+                 << endl;
+        }
+    }
+    if(!workers_ok && verbose)
+    {
+        cerr << "WARNING: One or more batch workers exited abnormally" << endl;
+    }
+
+    // Print a summary
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    cout << "Converted " << (jobs.size() - n_failed) << "/" << jobs.size()
+         << " files in " << fixed << setprecision(1) << elapsed.count()
+         << " s (" << setprecision(1)
+         << (elapsed.count() > 0.0
+             ? total_input_bytes / elapsed.count() / 1048576.0
+             : 0.0)
+         << " MB/s)" << endl;
+
+    return n_failed == 0;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+// Standard includes
+#include <string>
+#include <vector>
+
+
+namespace root2hdf5
+{
+    namespace batch
+    {
+        // A single conversion in a batch
+        struct job
+        {
+            std::string input_url;
+            std::string output_url;
+        };
+
+        // Reads a batch manifest into the jobs vector.  The manifest contains
+        // one "<input-url> <output-url>" pair per line, separated by
+        // whitespace.  Blank lines and lines starting with "#" are ignored.
+        // Returns true on success, false if the manifest can't be read or has
+        // a malformed line.
+        bool read_manifest(const std::string & path, std::vector<job> & jobs);
+
+        // Runs the jobs in a pool of n_workers forked worker processes.  The
+        // parent process first warms the conversion caches by preparing (but
+        // not converting) the first input file, so that struct declarations
+        // and dictionaries are inherited by every worker rather than being
+        // rebuilt per file.  Workers pull jobs from a shared queue, and the
+        // parent reports the status and throughput of each file as it
+        // finishes.  Returns true if every job succeeded, false otherwise.
+        bool run_batch(const std::vector<job> & jobs, unsigned n_workers);
+    }
+}
@@ -0,0 +1,203 @@
+#include "cache.h"
+
+// C Standard includes
+#include <cstdlib>
+
+// Standard includes
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+// ROOT includes
+#include <TROOT.h>
+
+// root2hdf5 includes
+#include "options.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// Boost namespace aliases
+namespace fs = boost::filesystem;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::cache;
+using namespace root2hdf5::options;
+
+
+// Private namespace members
+namespace root2hdf5
+{
+    namespace cache
+    {
+        // In-memory copy of the layouts loaded so far, keyed by layout name
+        // and then by value key
+        map<string, map<string, size_t> > _layouts;
+
+        // Returns the path of the file backing the named layout
+        fs::path layout_path(const string & layout_name);
+
+        // Loads the named layout from disk into _layouts if it hasn't already
+        // been loaded, and returns a reference to it
+        map<string, size_t> & load_layout(const string & layout_name);
+    }
+}
+
+
+fs::path root2hdf5::cache::cache_directory()
+{
+    // Figure out the base directory, preferring an explicit option and then
+    // following the XDG convention, unless caching has been disabled
+    fs::path base;
+    bool disabled = root2hdf5::options::options.count("no-cache");
+    if(!disabled && root2hdf5::options::options.count("cache-dir"))
+    {
+        base = root2hdf5::options::options["cache-dir"].as<string>();
+    }
+    else if(!disabled && getenv("XDG_CACHE_HOME") != NULL)
+    {
+        base = fs::path(getenv("XDG_CACHE_HOME")) / "root2hdf5";
+    }
+    else if(!disabled && getenv("HOME") != NULL)
+    {
+        base = fs::path(getenv("HOME")) / ".cache" / "root2hdf5";
+    }
+
+    // Only compute the directory again if the base has changed, e.g. because
+    // the API was used with different options
+    static bool directory_computed = false;
+    static fs::path computed_base;
+    static fs::path directory;
+    if(directory_computed && base == computed_base)
+    {
+        return directory;
+    }
+    directory_computed = true;
+    computed_base = base;
+    directory.clear();
+    if(base.empty())
+    {
+        return directory;
+    }
+
+    // Separate out anything which depends on the ROOT version or the pointer
+    // width of the platform
+    stringstream subdirectory;
+    subdirectory << "root-" << gROOT->GetVersionCode()
+                 << "-" << (sizeof(void *) * 8) << "bit";
+    fs::path candidate = base / subdirectory.str();
+
+    // Create it.  If we can't, just run without a cache.
+    boost::system::error_code error;
+    fs::create_directories(candidate, error);
+    if(error || !fs::is_directory(candidate))
+    {
+        if(verbose)
+        {
+            cerr << "WARNING: Unable to create cache directory \""
+                 << candidate.native() << "\" - caching disabled" << endl;
+        }
+
+        return directory;
+    }
+
+    directory = candidate;
+    return directory;
+}
+
+
+string root2hdf5::cache::hash_string(const string & data)
+{
+    // FNV-1a, 64-bit variant
+    unsigned long long hash = 14695981039346656037ULL;
+    for(string::const_iterator it = data.begin(); it != data.end(); it++)
+    {
+        hash ^= (unsigned char)(*it);
+        hash *= 1099511628211ULL;
+    }
+
+    stringstream result;
+    result << hex << setw(16) << setfill('0') << hash;
+    return result.str();
+}
+
+
+fs::path root2hdf5::cache::layout_path(const string & layout_name)
+{
+    // Type names can contain characters which don't belong in file names, so
+    // key the file by a hash of the name
+    return cache_directory() / (hash_string(layout_name) + ".layout");
+}
+
+
+map<string, size_t> &
+root2hdf5::cache::load_layout(const string & layout_name)
+{
+    // Check if we've already loaded it (or tried to)
+    auto existing = _layouts.find(layout_name);
+    if(existing != _layouts.end())
+    {
+        return existing->second;
+    }
+
+    // Create the in-memory layout
+    map<string, size_t> & layout = _layouts[layout_name];
+
+    // If we're caching, read in anything from disk.  Each line is of the form
+    // "<key> <value>".  Lines which don't parse are ignored, since a partial
+    // write can at worst cost us a recomputation.
+    if(!cache_directory().empty())
+    {
+        ifstream input(layout_path(layout_name).c_str());
+        string line;
+        while(getline(input, line))
+        {
+            stringstream parser(line);
+            string key;
+            size_t value = 0;
+            if(parser >> key >> value)
+            {
+                layout[key] = value;
+            }
+        }
+    }
+
+    return layout;
+}
+
+
+bool root2hdf5::cache::lookup_layout_value(const string & layout_name,
+                                           const string & key,
+                                           size_t & value)
+{
+    map<string, size_t> & layout = load_layout(layout_name);
+    auto it = layout.find(key);
+    if(it == layout.end())
+    {
+        return false;
+    }
+
+    value = it->second;
+    return true;
+}
+
+
+void root2hdf5::cache::store_layout_value(const string & layout_name,
+                                          const string & key,
+                                          size_t value)
+{
+    // Record it in memory
+    load_layout(layout_name)[key] = value;
+
+    // Append it to the on-disk layout.  Each record is a single short line
+    // written in append mode, so concurrent writers don't corrupt each other.
+    if(!cache_directory().empty())
+    {
+        ofstream output(layout_path(layout_name).c_str(),
+                        ofstream::out | ofstream::app);
+        output << key << " " << value << "\n";
+    }
+}
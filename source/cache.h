@@ -0,0 +1,46 @@
+#pragma once
+
+// Standard includes
+#include <string>
+
+// Boost includes
+// HACK: Need to define this macro to tell Boost not to use deprecated
+// Boost.System constructs which result in unused-variable errors.
+#ifndef BOOST_SYSTEM_NO_DEPRECATED
+#define BOOST_SYSTEM_NO_DEPRECATED 1
+#endif
+#include <boost/filesystem.hpp>
+
+
+namespace root2hdf5
+{
+    namespace cache
+    {
+        // Returns the directory in which persistent conversion plans and
+        // compiled dictionaries are stored, creating it if necessary.  The
+        // directory is specific to the ROOT version and pointer width, because
+        // both compiled libraries and struct layouts depend on them.  If
+        // caching is disabled or the directory can't be created, an empty path
+        // is returned.
+        boost::filesystem::path cache_directory();
+
+        // Computes a stable 64-bit FNV-1a hash of the data, formatted as 16
+        // lowercase hexadecimal digits.  This is used to build cache keys and
+        // must never change between runs or platforms.
+        std::string hash_string(const std::string & data);
+
+        // Looks up a cached layout value (an offset or a size) for the key
+        // within the named layout.  Layouts are loaded from the cache directory
+        // the first time they are accessed.  Returns true if the value was
+        // found, false if not.
+        bool lookup_layout_value(const std::string & layout_name,
+                                 const std::string & key,
+                                 size_t & value);
+
+        // Records a layout value both in memory and in the cache directory so
+        // that subsequent runs don't need to recompute it.
+        void store_layout_value(const std::string & layout_name,
+                                const std::string & key,
+                                size_t value);
+    }
+}
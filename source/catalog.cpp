@@ -0,0 +1,91 @@
+#include "catalog.h"
+
+// Standard includes
+#include <map>
+#include <string>
+
+// ROOT includes
+#include <TH1.h>
+#include <THnBase.h>
+#include <TTree.h>
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::catalog;
+
+
+vector<catalog_entry>
+root2hdf5::catalog::catalog_directory(TDirectory *directory)
+{
+    vector<catalog_entry> result;
+
+    // Map from key name to its position in the result
+    map<string, size_t> positions;
+
+    // Go through the keys, classifying them by their class name
+    TIter next_key(directory->GetListOfKeys());
+    TKey *key = NULL;
+    while((key = (TKey *)next_key()))
+    {
+        // ROOT uses this stupid concept called a "cycle number" to save
+        // multiple header-like objects for the same object.  For example, a
+        // TTree named "bob" might appear as "bob;1" and "bob;2".  Both point to
+        // the same object, but "bob;2" is the later, complete revision.  This
+        // happens in the TTree case because TTree's auto-save to their file
+        // every 100 MB.  Everytime an autosave happens, the previous autosave
+        // cycle numbers are removed, but when TFile::Write is called, the last
+        // autosave cycle number remains (who knows why...) and a new biggest
+        // cycle number is created.  Thus, we only keep the highest cycle
+        // number for each name.
+        // TODO: This may not be the correct procedure for every data-type, so
+        // we may need to reevaluate this filtering procedure in the future.
+        auto existing = positions.find(key->GetName());
+        if(existing != positions.end())
+        {
+            if(key->GetCycle() > result[existing->second].key->GetCycle())
+            {
+                result[existing->second].key = key;
+            }
+            continue;
+        }
+
+        // Classify the key by its class name, which doesn't require reading
+        // the object.  Look the class up silently, since unknown classes are
+        // just unhandled.
+        catalog_entry entry;
+        entry.key = key;
+        entry.type = TClass::GetClass(key->GetClassName(), kTRUE, kTRUE);
+        if(entry.type == NULL)
+        {
+            entry.kind = unhandled_object;
+        }
+        else if(entry.type->InheritsFrom(TDirectory::Class()))
+        {
+            entry.kind = directory_object;
+        }
+        else if(entry.type->InheritsFrom(TTree::Class()))
+        {
+            entry.kind = tree_object;
+        }
+        else if(entry.type->InheritsFrom(TH1::Class()))
+        {
+            entry.kind = histogram_object;
+        }
+        else if(entry.type->InheritsFrom(THnBase::Class()))
+        {
+            entry.kind = multidimensional_histogram_object;
+        }
+        else
+        {
+            entry.kind = unhandled_object;
+        }
+
+        positions[key->GetName()] = result.size();
+        result.push_back(entry);
+    }
+
+    return result;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+// Standard includes
+#include <vector>
+
+// ROOT includes
+#include <TClass.h>
+#include <TDirectory.h>
+#include <TKey.h>
+
+
+namespace root2hdf5
+{
+    namespace catalog
+    {
+        // The kinds of objects which root2hdf5 knows how to handle
+        enum object_kind
+        {
+            directory_object,
+            tree_object,
+            histogram_object,
+            multidimensional_histogram_object,
+            unhandled_object
+        };
+
+        // A single cataloged key.  The type may be NULL if ROOT doesn't know
+        // the class named by the key, in which case the kind is always
+        // unhandled_object.
+        struct catalog_entry
+        {
+            TKey *key;
+            TClass *type;
+            object_kind kind;
+        };
+
+        // Builds a catalog of the keys in a directory without reading any of
+        // the objects they point to.  Each key is classified from the class
+        // name stored in the key itself, and only the highest cycle of each
+        // name is kept.  Entries are returned in the directory's key order.
+        std::vector<catalog_entry> catalog_directory(TDirectory *directory);
+    }
+}
@@ -3,6 +3,7 @@
 // Standard includes
 #include <iostream>
 #include <fstream>
+#include <set>
 
 // Boost includes
 // HACK: Need to define this macro to tell Boost not to use deprecated
@@ -18,6 +19,7 @@
 
 // root2hdf5 includes
 #include "options.h"
+#include "cache.h"
 
 
 // Standard namespaces
@@ -29,6 +31,7 @@ namespace fs = boost::filesystem;
 // root2hdf5 namespaces
 using namespace root2hdf5::cint;
 using namespace root2hdf5::options;
+using namespace root2hdf5::cache;
 
 
 bool root2hdf5::cint::process_long_line(const string & long_line,
@@ -47,6 +50,34 @@ bool root2hdf5::cint::process_long_line(const string & long_line,
         gSystem->SetBuildDir(build_directory.native().c_str());
     }
 
+    // Compiling is expensive, so check whether an identical macro has already
+    // been compiled in this process, or into the persistent cache by a
+    // previous run, and if so just make sure its library is loaded
+    static set<string> compiled_macros;
+    string macro_hash = hash_string(long_line);
+    fs::path cached_library;
+    if(compile)
+    {
+        if(compiled_macros.count(macro_hash))
+        {
+            return true;
+        }
+
+        if(!cache_directory().empty())
+        {
+            cached_library = cache_directory() / ("macro_" + macro_hash);
+            fs::path library_file(
+                cached_library.native() + "." + gSystem->GetSoExt()
+            );
+            if(fs::exists(library_file)
+               && gSystem->Load(library_file.native().c_str()) >= 0)
+            {
+                compiled_macros.insert(macro_hash);
+                return true;
+            }
+        }
+    }
+
     // TODO: It might be better to add some more stringent error checking in
     // here, but most of these things are such robust, low-level OS things that
     // if they fail, the user's environment is probably already melting around
@@ -70,10 +101,22 @@ bool root2hdf5::cint::process_long_line(const string & long_line,
     bool success = true;
     if(compile)
     {
-        if(gSystem->CompileMacro(temp_path.native().c_str()) != 1)
+        // If we have a cache, keep the library there under a name derived
+        // from the code so the next run can load it directly
+        int compile_result = cached_library.empty()
+            ? gSystem->CompileMacro(temp_path.native().c_str())
+            : gSystem->CompileMacro(temp_path.native().c_str(),
+                                    "k",
+                                    cached_library.native().c_str(),
+                                    cache_directory().native().c_str());
+        if(compile_result != 1)
         {
             success = false;
         }
+        else
+        {
+            compiled_macros.insert(macro_hash);
+        }
     }
     else
     {
@@ -19,8 +19,10 @@ namespace root2hdf5
         // because the output directory of the compiled code can be controlled.
         // If the "compile" argument is false, this method will use the
         // TROOT::LoadMacro method, and will process the code without compiling
-        // it, but cannot do things like generating dictionaries.  This method 
-        // returns true on success and false on failure.
+        // it, but cannot do things like generating dictionaries.  Compiled
+        // libraries are kept in the persistent cache directory (if enabled)
+        // keyed by a hash of the code, so identical code is only ever compiled
+        // once.  This method returns true on success and false on failure.
         bool process_long_line(const std::string & long_line,
                                bool compile = false);
     }
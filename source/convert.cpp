@@ -1,65 +1,288 @@
 #include "convert.h"
 
 // C Standard includes
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 
 // Standard includes
 #include <iostream>
+#include <vector>
+
+// Boost includes
+// HACK: Need to define this macro to tell Boost not to use deprecated
+// Boost.System constructs which result in unused-variable errors.
+#ifndef BOOST_SYSTEM_NO_DEPRECATED
+#define BOOST_SYSTEM_NO_DEPRECATED 1
+#endif
+#include <boost/filesystem.hpp>
 
 // ROOT includes
-#include <TClass.h>
+#include <TFile.h>
+#include <TH1.h>
+#include <THnBase.h>
 #include <TKey.h>
 #include <TTree.h>
 
 // root2hdf5 includes
 #include "options.h"
+#include "catalog.h"
+#include "histogram.h"
 #include "tree.h"
+#include "rollover.h"
 
 
 // Standard namespaces
 using namespace std;
 
+// Boost namespace aliases
+namespace fs = boost::filesystem;
+
 // root2hdf5 namespaces
 using namespace root2hdf5::options;
+using namespace root2hdf5::catalog;
 using namespace root2hdf5::tree;
+using namespace root2hdf5::rollover;
+
+
+// Private namespace members
+namespace root2hdf5
+{
+    namespace convert
+    {
+        // The output URL which streams the HDF5 file to stdout
+        const string stdout_url = "-";
+
+        // In-memory files grow by this much at a time
+        const size_t memory_file_increment = 16 * 1024 * 1024;
+
+        // Returns the --memory-limit in bytes, or 0 if there is none
+        hsize_t memory_limit();
+
+        // Returns false, printing an error, if an in-memory file has grown
+        // beyond the limit
+        bool within_memory_limit(hid_t file, hsize_t limit);
+
+        // The buffer backing the in-memory output file.  The core driver
+        // allocates it through the file image callbacks below, so that the
+        // finished file can be streamed straight from it rather than from a
+        // copy, which would double the peak memory use.
+        void *_image_buffer = NULL;
+        size_t _image_size = 0;
+
+        // File image callbacks which track the buffer of the in-memory file.
+        // Only the file's own buffer is tracked, not the copies HDF5 makes
+        // of initial images for property lists.
+        void * image_malloc(size_t size,
+                            H5FD_file_image_op_t operation,
+                            void *user_data);
+        void * image_memcpy(void *destination,
+                            const void *source,
+                            size_t size,
+                            H5FD_file_image_op_t operation,
+                            void *user_data);
+        void * image_realloc(void *buffer,
+                             size_t size,
+                             H5FD_file_image_op_t operation,
+                             void *user_data);
+        herr_t image_free(void *buffer,
+                          H5FD_file_image_op_t operation,
+                          void *user_data);
+
+        // Creates a file access property list for an in-memory file whose
+        // buffer is tracked by the callbacks above.  Returns -1 on failure.
+        hid_t create_memory_file_access();
+
+        // Writes the image of the in-memory file to stdout
+        bool write_file_image_to_stdout(hid_t file);
+    }
+}
+
+
+hsize_t root2hdf5::convert::memory_limit()
+{
+    if(root2hdf5::options::options.count("memory-limit") == 0)
+    {
+        return 0;
+    }
+
+    return (hsize_t)root2hdf5::options::options["memory-limit"]
+        .as<unsigned>() * 1024 * 1024;
+}
+
+
+bool root2hdf5::convert::within_memory_limit(hid_t file, hsize_t limit)
+{
+    // The buffer the core driver has allocated may run ahead of the file's
+    // size by up to one increment, and it is what actually takes up memory
+    hsize_t size = 0;
+    bool size_known = H5Fget_filesize(file, &size) >= 0;
+    if(_image_size > size)
+    {
+        size = _image_size;
+    }
+    if(!size_known || size > limit)
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: In-memory output exceeded the memory limit of "
+                 << limit / (1024 * 1024) << " MB" << endl;
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+
+void * root2hdf5::convert::image_malloc(size_t size,
+                                        H5FD_file_image_op_t operation,
+                                        void *user_data)
+{
+    // Hide unused variable warning
+    (void)user_data;
+
+    void *result = malloc(size);
+    if(result != NULL
+       && (operation == H5FD_FILE_IMAGE_OP_FILE_OPEN
+           || operation == H5FD_FILE_IMAGE_OP_FILE_RESIZE))
+    {
+        _image_buffer = result;
+        _image_size = size;
+    }
+
+    return result;
+}
+
+
+void * root2hdf5::convert::image_memcpy(void *destination,
+                                        const void *source,
+                                        size_t size,
+                                        H5FD_file_image_op_t operation,
+                                        void *user_data)
+{
+    // Hide unused variable warnings
+    (void)operation;
+    (void)user_data;
+
+    return memcpy(destination, source, size);
+}
+
+
+void * root2hdf5::convert::image_realloc(void *buffer,
+                                         size_t size,
+                                         H5FD_file_image_op_t operation,
+                                         void *user_data)
+{
+    // Hide unused variable warning
+    (void)user_data;
+
+    void *result = realloc(buffer, size);
+    if(result != NULL
+       && (operation == H5FD_FILE_IMAGE_OP_FILE_OPEN
+           || operation == H5FD_FILE_IMAGE_OP_FILE_RESIZE))
+    {
+        _image_buffer = result;
+        _image_size = size;
+    }
+
+    return result;
+}
+
+
+herr_t root2hdf5::convert::image_free(void *buffer,
+                                      H5FD_file_image_op_t operation,
+                                      void *user_data)
+{
+    // Hide unused variable warnings
+    (void)operation;
+    (void)user_data;
+
+    if(buffer == _image_buffer)
+    {
+        _image_buffer = NULL;
+        _image_size = 0;
+    }
+    free(buffer);
+
+    return 0;
+}
+
+
+hid_t root2hdf5::convert::create_memory_file_access()
+{
+    H5FD_file_image_callbacks_t callbacks = {
+        image_malloc,
+        image_memcpy,
+        image_realloc,
+        image_free,
+        NULL,
+        NULL,
+        NULL
+    };
+    hid_t access = H5Pcreate(H5P_FILE_ACCESS);
+    if(access >= 0
+       && (H5Pset_fapl_core(access, memory_file_increment, 0) < 0
+           || H5Pset_file_image_callbacks(access, &callbacks) < 0))
+    {
+        H5Pclose(access);
+        access = -1;
+    }
+
+    return access;
+}
+
+
+bool root2hdf5::convert::write_file_image_to_stdout(hid_t file)
+{
+    // Flush everything into the image first
+    ssize_t size = -1;
+    if(H5Fflush(file, H5F_SCOPE_GLOBAL) >= 0)
+    {
+        size = H5Fget_file_image(file, NULL, 0);
+    }
+    if(size < 0)
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Unable to get in-memory output file image" << endl;
+        }
+
+        return false;
+    }
+
+    // Stream it straight from the file's own buffer
+    if(_image_buffer == NULL
+       || (size_t)size > _image_size
+       || fwrite(_image_buffer, 1, size, stdout) != (size_t)size
+       || fflush(stdout) != 0)
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Unable to write output file image to stdout"
+                 << endl;
+        }
+
+        return false;
+    }
+
+    return true;
+}
 
 
 bool root2hdf5::convert::convert(TDirectory *directory,
-                                 hid_t parent_destination)
+                                 hid_t parent_destination,
+                                 const tree_sink & sink)
 {
-    // Generate a list of keys in the directory
-    TIter next_key(directory->GetListOfKeys());
+    // Catalog the keys in the directory, which classifies them without
+    // reading any objects
+    vector<catalog_entry> entries = catalog_directory(directory);
 
     // Go through the keys, handling them by their type
-    TKey *key = NULL;
-    TKey *previous = NULL;
-    while((key = (TKey *)next_key()))
-    {
-        // ROOT uses this stupid concept called a "cycle number" to save
-        // multiple header-like objects for the same object.  For example, a
-        // TTree named "bob" might appear as "bob;1" and "bob;2".  Both point to
-        // the same object, but "bob;2" is the later, complete revision.  This
-        // happens in the TTree case because TTree's auto-save to their file
-        // every 100 MB.  Everytime an autosave happens, the previous autosave
-        // cycle numbers are removed, but when TFile::Write is called, the last
-        // autosave cycle number remains (who knows why...) and a new biggest
-        // cycle number is created.  Thus, we only convert the highest cycle
-        // number for each key (TIter will go from highest cycle number to
-        // lowest number, so if we've already processed a key with this name, we
-        // can skip any duplicately named ones).
-        // TODO: This may not be the correct procedure for every data-type, so
-        // we may need to reevaluate this filtering procedure in the future.
-        if(previous != NULL && strcmp(key->GetName(), previous->GetName()) == 0)
-        {
-            continue;
-        }
-
-        // Record the previously processed key
-        previous = key;
-
-        // Grab the object and its type
-        TObject *object = key->ReadObj();
-        TClass *object_type = object->IsA();
+    for(auto it = entries.begin(); it != entries.end(); it++)
+    {
+        TKey *key = it->key;
 
         // Print information if requested
         if(verbose)
@@ -72,7 +295,7 @@ bool root2hdf5::convert::convert(TDirectory *directory,
         }
 
         // Switch based on type
-        if(object_type->InheritsFrom(TDirectory::Class()))
+        if(it->kind == directory_object)
         {
             // This is a ROOT directory, so first create a corresponding HDF5
             // group and then recurse into it
@@ -81,7 +304,7 @@ bool root2hdf5::convert::convert(TDirectory *directory,
                                          H5P_DEFAULT,
                                          H5P_DEFAULT,
                                          H5P_DEFAULT);
-            if(!convert((TDirectory *)key->ReadObj(), new_group))
+            if(!convert((TDirectory *)key->ReadObj(), new_group, sink))
             {
                 return false;
             }
@@ -97,20 +320,50 @@ bool root2hdf5::convert::convert(TDirectory *directory,
                 return false;
             }
         }
-        else if(object_type->InheritsFrom(TTree::Class()))
+        else if(it->kind == tree_object)
         {
             // This is a ROOT tree, so we need to create a new HDF5 dataset with
             // custom type matching the TTree branches, and then copy all the
             // data into it
-            root2hdf5::tree::convert((TTree *)object, parent_destination);
+            if(!root2hdf5::tree::convert((TTree *)key->ReadObj(),
+                                         parent_destination,
+                                         sink))
+            {
+                return false;
+            }
+        }
+        else if(it->kind == histogram_object)
+        {
+            // This is a 1-, 2- or 3-D histogram.  Histograms tend to be
+            // numerous, so free each one as soon as it has been written.
+            TH1 *histogram = (TH1 *)key->ReadObj();
+            bool success = root2hdf5::histogram::convert(histogram,
+                                                         parent_destination);
+            delete histogram;
+            if(!success)
+            {
+                return false;
+            }
+        }
+        else if(it->kind == multidimensional_histogram_object)
+        {
+            // This is a THn or THnSparse
+            THnBase *histogram = (THnBase *)key->ReadObj();
+            bool success = root2hdf5::histogram::convert(histogram,
+                                                         parent_destination);
+            delete histogram;
+            if(!success)
+            {
+                return false;
+            }
         }
         else
         {
-            // This type is currently unhandled
+            // This type is currently unhandled, so don't bother reading it
             if(verbose)
             {
                 cerr << "WARNING: Unhandled object type \""
-                     << object_type->GetName() 
+                     << key->GetClassName() 
                      << "\" - skipping"
                      << endl;
             }
@@ -120,3 +373,175 @@ bool root2hdf5::convert::convert(TDirectory *directory,
     // All done
     return true;
 }
+
+
+bool root2hdf5::convert::prepare(TDirectory *directory)
+{
+    // Only read directories and trees
+    vector<catalog_entry> entries = catalog_directory(directory);
+    for(auto it = entries.begin(); it != entries.end(); it++)
+    {
+        if(it->kind == directory_object)
+        {
+            if(!prepare((TDirectory *)it->key->ReadObj()))
+            {
+                return false;
+            }
+        }
+        else if(it->kind == tree_object)
+        {
+            if(!root2hdf5::tree::prepare((TTree *)it->key->ReadObj()))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+bool root2hdf5::convert::convert_file(const string & input_url,
+                                      const string & output_url,
+                                      const tree_sink & sink)
+{
+    // Check if the output path exists.  If it does, and it is a directory, then
+    // the user has likely made a mistake, so bail.  If it does and it is a
+    // file, then check if the user has specified the overwrite option, and in
+    // that case, proceed.  Streaming to stdout skips all of this.
+    bool to_stdout = output_url == stdout_url;
+    hsize_t max_size = max_output_size();
+    if(to_stdout && max_size > 0)
+    {
+        cerr << "The \"--max-output-size\" option can't be used when "
+             << "streaming to stdout" << endl;
+        return false;
+    }
+    fs::path output_path(output_url);
+    bool exists = !to_stdout && fs::exists(output_path);
+    bool is_dir = exists && fs::is_directory(output_path);
+    if(exists)
+    {
+        if(is_dir)
+        {
+            cerr << "Output path is a directory, manually delete if you would "
+                 << "like to overwrite it" << endl;
+            return false;
+        }
+        else if(root2hdf5::options::options.count("overwrite") == 0)
+        {
+            cerr << "Output path exists.  Specify the \"--overwrite\" option "
+                 << "if you would like to overwrite it" << endl;
+            return false;
+        }
+    }
+
+    // Print path information if requested, keeping stdout clean when the
+    // file goes there
+    if(verbose)
+    {
+        (to_stdout ? cerr : cout) << "Converting " << input_url << " -> "
+                                  << output_url << endl;
+    }
+
+    // Open the input file
+    TFile *input_file = TFile::Open(input_url.c_str(), "READ");
+    if(input_file == NULL)
+    {
+        if(verbose)
+        {
+            cerr << "Unable to open input file: " << input_url << endl;
+        }
+        return false;
+    }
+
+    // Open the output file.  When streaming to stdout, the file is built in
+    // memory with the core driver and never touches disk.
+    hid_t output_access = to_stdout
+                          ? create_memory_file_access()
+                          : H5P_DEFAULT;
+    hid_t output_file = -1;
+    if(output_access >= 0)
+    {
+        output_file = H5Fcreate(output_url.c_str(),
+                                H5F_ACC_TRUNC,
+                                H5P_DEFAULT,
+                                output_access);
+    }
+    if(to_stdout && output_access >= 0)
+    {
+        H5Pclose(output_access);
+    }
+    if(output_file < 0)
+    {
+        if(verbose)
+        {
+            cerr << "Unable to create output file: " << output_url << endl;
+        }
+        input_file->Close();
+        delete input_file;
+        return false;
+    }
+
+    // Enforce the memory limit for in-memory files after every block, so
+    // that conversion fails fast rather than swapping
+    tree_sink output_sink(sink);
+    hsize_t limit = to_stdout ? memory_limit() : 0;
+    if(limit > 0)
+    {
+        output_sink.block = [sink, output_file, limit]
+                            (const char *rows, hsize_t n_rows) -> bool {
+            return within_memory_limit(output_file, limit)
+                   && (!sink.block || sink.block(rows, n_rows));
+        };
+    }
+
+    // Past the size limit, tree data rolls over into numbered part files,
+    // leaving the output itself as an index of virtual datasets
+    rollover_closer closer;
+    if(max_size > 0)
+    {
+        boost::tie(output_sink, closer) = build_rollover_sink(output_url,
+                                                              output_file,
+                                                              max_size,
+                                                              output_sink);
+    }
+
+    // Walk the input file and convert everything
+    // Informational output is sent to stderr while the file goes to stdout
+    streambuf *output = to_stdout ? cout.rdbuf(cerr.rdbuf()) : NULL;
+    bool success = convert(input_file, output_file, output_sink);
+    if(output != NULL)
+    {
+        cout.rdbuf(output);
+    }
+
+    if(closer && !closer())
+    {
+        success = false;
+    }
+
+    // Stream the finished in-memory file
+    if(success && to_stdout)
+    {
+        success = (limit == 0 || within_memory_limit(output_file, limit))
+                  && write_file_image_to_stdout(output_file);
+    }
+
+    // Cleanup output resources
+    if(H5Fclose(output_file) < 0)
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Closing output file failed" << endl;
+        }
+        success = false;
+    }
+
+    // Cleanup input resources
+    input_file->Close();
+    delete input_file;
+    input_file = NULL;
+
+    return success;
+}
@@ -1,18 +1,41 @@
 #pragma once
 
+// Standard includes
+#include <string>
+
 // ROOT includes
 #include <TDirectory.h>
 
 // HDF5 includes
 #include <hdf5.h>
 
+// root2hdf5 includes
+#include "tree.h"
+
 
 namespace root2hdf5
 {
     namespace convert
     {
-        // Primary conversion method
+        // Primary conversion method.  The rows of every tree are also handed
+        // to the sink as they are converted.
         bool convert(TDirectory *directory,
-                     hid_t parent_destination);
+                     hid_t parent_destination,
+                     const root2hdf5::tree::tree_sink & sink
+                         = root2hdf5::tree::tree_sink());
+
+        // Walks the directory like convert, but only calls
+        // root2hdf5::tree::prepare on each tree, warming the caches without
+        // converting anything
+        bool prepare(TDirectory *directory);
+
+        // Converts the ROOT file at input_url into a new HDF5 file at
+        // output_url, honoring the "overwrite" option if the output already
+        // exists, and handing the rows of every tree to the sink.  Returns
+        // true on success, false on failure.
+        bool convert_file(const std::string & input_url,
+                          const std::string & output_url,
+                          const root2hdf5::tree::tree_sink & sink
+                              = root2hdf5::tree::tree_sink());
     }
 }
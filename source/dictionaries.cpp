@@ -0,0 +1,17 @@
+#include "dictionaries.h"
+
+// ROOT includes
+#include <TClass.h>
+
+
+// Standard namespaces
+using namespace std;
+
+
+bool root2hdf5::dictionaries::has_compiled_dictionary(const string & class_name)
+{
+    // Look up the class without printing any warnings if it is unknown.
+    // Emulated classes (built only from streamer info) aren't "loaded".
+    TClass *type = TClass::GetClass(class_name.c_str(), kTRUE, kTRUE);
+    return type != NULL && type->IsLoaded();
+}
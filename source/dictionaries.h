@@ -0,0 +1,20 @@
+#pragma once
+
+// Standard includes
+#include <string>
+
+
+namespace root2hdf5
+{
+    namespace dictionaries
+    {
+        // This method returns true if ROOT has a compiled (i.e. not emulated)
+        // dictionary for the named class, either because it is one of the
+        // nested vector types prebuilt into the root2hdf5_dictionaries library
+        // (see dictionaries/vector_dictionaries_LinkDef.h) or because it has
+        // been compiled or loaded by some other means.  This method lives in
+        // the dictionary library itself, so calling it also guarantees that
+        // the library is linked into anything using it.
+        bool has_compiled_dictionary(const std::string & class_name);
+    }
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+// This header is only processed by rootcint to generate the prebuilt
+// dictionaries for nested STL vector types listed in
+// vector_dictionaries_LinkDef.h.
+
+// Standard includes
+#include <vector>
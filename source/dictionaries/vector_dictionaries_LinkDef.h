@@ -0,0 +1,79 @@
+// This LinkDef file lists the nested STL vector types for which root2hdf5
+// ships prebuilt dictionaries.  It covers one, two and three levels of nesting
+// over every scalar type in type.cpp's conversion table (using the underlying
+// C++ names, since ROOT's typedefs like Float_t resolve to the same classes).
+// Any vector type not listed here falls back to being compiled at runtime by
+// vector_converter.
+
+#ifdef __CINT__
+
+#pragma link off all globals;
+#pragma link off all classes;
+#pragma link off all functions;
+
+// bool
+#pragma link C++ class vector<bool>+;
+#pragma link C++ class vector<vector<bool> >+;
+#pragma link C++ class vector<vector<vector<bool> > >+;
+
+// char
+#pragma link C++ class vector<char>+;
+#pragma link C++ class vector<vector<char> >+;
+#pragma link C++ class vector<vector<vector<char> > >+;
+
+// unsigned char
+#pragma link C++ class vector<unsigned char>+;
+#pragma link C++ class vector<vector<unsigned char> >+;
+#pragma link C++ class vector<vector<vector<unsigned char> > >+;
+
+// short
+#pragma link C++ class vector<short>+;
+#pragma link C++ class vector<vector<short> >+;
+#pragma link C++ class vector<vector<vector<short> > >+;
+
+// unsigned short
+#pragma link C++ class vector<unsigned short>+;
+#pragma link C++ class vector<vector<unsigned short> >+;
+#pragma link C++ class vector<vector<vector<unsigned short> > >+;
+
+// int
+#pragma link C++ class vector<int>+;
+#pragma link C++ class vector<vector<int> >+;
+#pragma link C++ class vector<vector<vector<int> > >+;
+
+// unsigned int
+#pragma link C++ class vector<unsigned int>+;
+#pragma link C++ class vector<vector<unsigned int> >+;
+#pragma link C++ class vector<vector<vector<unsigned int> > >+;
+
+// long
+#pragma link C++ class vector<long>+;
+#pragma link C++ class vector<vector<long> >+;
+#pragma link C++ class vector<vector<vector<long> > >+;
+
+// unsigned long
+#pragma link C++ class vector<unsigned long>+;
+#pragma link C++ class vector<vector<unsigned long> >+;
+#pragma link C++ class vector<vector<vector<unsigned long> > >+;
+
+// long long
+#pragma link C++ class vector<long long>+;
+#pragma link C++ class vector<vector<long long> >+;
+#pragma link C++ class vector<vector<vector<long long> > >+;
+
+// unsigned long long
+#pragma link C++ class vector<unsigned long long>+;
+#pragma link C++ class vector<vector<unsigned long long> >+;
+#pragma link C++ class vector<vector<vector<unsigned long long> > >+;
+
+// float
+#pragma link C++ class vector<float>+;
+#pragma link C++ class vector<vector<float> >+;
+#pragma link C++ class vector<vector<vector<float> > >+;
+
+// double
+#pragma link C++ class vector<double>+;
+#pragma link C++ class vector<vector<double> >+;
+#pragma link C++ class vector<vector<vector<double> > >+;
+
+#endif
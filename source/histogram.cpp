@@ -0,0 +1,487 @@
+#include "histogram.h"
+
+// Standard includes
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ROOT includes
+#include <TArrayC.h>
+#include <TArrayD.h>
+#include <TArrayF.h>
+#include <TArrayI.h>
+#include <TArrayL64.h>
+#include <TArrayS.h>
+#include <TAxis.h>
+#include <THnSparse.h>
+#include <TProfile.h>
+#include <TProfile2D.h>
+#include <TProfile3D.h>
+
+// root2hdf5 includes
+#include "options.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::histogram;
+using namespace root2hdf5::options;
+
+
+// Private namespace members
+namespace root2hdf5
+{
+    namespace histogram
+    {
+        // Datasets smaller than this are stored with the compact layout, i.e.
+        // directly in their object header, which avoids a separate raw data
+        // allocation and write for each of the (usually small) datasets of a
+        // histogram.  HDF5 limits compact datasets to 64 KB.
+        const hsize_t compact_dataset_limit = 32 * 1024;
+
+        // Writes a complete array to a new dataset in the parent
+        bool write_dataset(hid_t parent,
+                           const string & name,
+                           hid_t type,
+                           int rank,
+                           const hsize_t *dimensions,
+                           const void *data);
+
+        // Writes the bin edges of an axis to a new dataset in the parent
+        bool write_axis_edges(hid_t parent, const string & name, TAxis *axis);
+
+        // Creates the group for a histogram
+        hid_t create_histogram_group(hid_t parent, const char *name);
+
+        // Closes the group for a histogram
+        bool close_histogram_group(hid_t group, const char *name);
+
+        // Returns true if the histogram is a TProfile, TProfile2D or
+        // TProfile3D
+        bool is_profile(TH1 *histogram);
+
+        // Writes the per-bin means, sums of weights and (if stored) sums of
+        // squared weights of a profile
+        bool write_profile_datasets(hid_t group,
+                                    TH1 *histogram,
+                                    int rank,
+                                    const hsize_t *dimensions);
+    }
+}
+
+
+bool root2hdf5::histogram::write_dataset(hid_t parent,
+                                         const string & name,
+                                         hid_t type,
+                                         int rank,
+                                         const hsize_t *dimensions,
+                                         const void *data)
+{
+    // Create the data space
+    hid_t space = H5Screate_simple(rank, dimensions, NULL);
+    if(space < 0)
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Unable to create data space for histogram dataset "
+                 << "\"" << name << "\"" << endl;
+        }
+
+        return false;
+    }
+
+    // Use the compact layout for small datasets
+    hid_t properties = H5Pcreate(H5P_DATASET_CREATE);
+    hsize_t n_bytes = H5Sget_simple_extent_npoints(space) * H5Tget_size(type);
+    if(n_bytes < compact_dataset_limit)
+    {
+        H5Pset_layout(properties, H5D_COMPACT);
+    }
+
+    // Create and write the dataset
+    hid_t dataset = H5Dcreate2(parent,
+                               name.c_str(),
+                               type,
+                               space,
+                               H5P_DEFAULT,
+                               properties,
+                               H5P_DEFAULT);
+    bool success = dataset >= 0
+                   && H5Dwrite(dataset,
+                               type,
+                               H5S_ALL,
+                               H5S_ALL,
+                               H5P_DEFAULT,
+                               data) >= 0;
+    if(dataset >= 0 && H5Dclose(dataset) < 0)
+    {
+        success = false;
+    }
+    H5Pclose(properties);
+    H5Sclose(space);
+
+    if(!success && verbose)
+    {
+        cerr << "ERROR: Unable to write histogram dataset \"" << name << "\""
+             << endl;
+    }
+
+    return success;
+}
+
+
+bool root2hdf5::histogram::write_axis_edges(hid_t parent,
+                                            const string & name,
+                                            TAxis *axis)
+{
+    // Variable-width axes store their edges, so use those directly
+    hsize_t n_edges = axis->GetNbins() + 1;
+    const TArrayD *variable_edges = axis->GetXbins();
+    if(variable_edges->GetSize() == (Int_t)n_edges)
+    {
+        return write_dataset(parent,
+                             name,
+                             H5T_NATIVE_DOUBLE,
+                             1,
+                             &n_edges,
+                             variable_edges->GetArray());
+    }
+
+    // Otherwise compute the uniform edges
+    vector<double> edges(n_edges);
+    double minimum = axis->GetXmin();
+    double width = (axis->GetXmax() - minimum) / axis->GetNbins();
+    for(hsize_t i = 0; i < n_edges; i++)
+    {
+        edges[i] = minimum + i * width;
+    }
+
+    return write_dataset(parent,
+                         name,
+                         H5T_NATIVE_DOUBLE,
+                         1,
+                         &n_edges,
+                         &edges[0]);
+}
+
+
+hid_t root2hdf5::histogram::create_histogram_group(hid_t parent,
+                                                   const char *name)
+{
+    hid_t group = H5Gcreate2(parent,
+                             name,
+                             H5P_DEFAULT,
+                             H5P_DEFAULT,
+                             H5P_DEFAULT);
+    if(group < 0 && verbose)
+    {
+        cerr << "ERROR: Unable to create group for histogram \"" << name
+             << "\"" << endl;
+    }
+
+    return group;
+}
+
+
+bool root2hdf5::histogram::close_histogram_group(hid_t group, const char *name)
+{
+    if(H5Gclose(group) < 0)
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Closing group for histogram \"" << name
+                 << "\" failed" << endl;
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+
+bool root2hdf5::histogram::is_profile(TH1 *histogram)
+{
+    return histogram->InheritsFrom(TProfile::Class())
+           || histogram->InheritsFrom(TProfile2D::Class())
+           || histogram->InheritsFrom(TProfile3D::Class());
+}
+
+
+bool root2hdf5::histogram::write_profile_datasets(hid_t group,
+                                                  TH1 *histogram,
+                                                  int rank,
+                                                  const hsize_t *dimensions)
+{
+    // The three profile classes don't share a base class beyond TH1, so pick
+    // out the sums of weights of whichever one this is
+    hsize_t n_cells = 1;
+    for(int i = 0; i < rank; i++)
+    {
+        n_cells *= dimensions[i];
+    }
+    TProfile *profile_1d = dynamic_cast<TProfile *>(histogram);
+    TProfile2D *profile_2d = dynamic_cast<TProfile2D *>(histogram);
+    TProfile3D *profile_3d = dynamic_cast<TProfile3D *>(histogram);
+    const TArrayD *entries_sumw2 = NULL;
+    if(profile_1d != NULL)
+    {
+        entries_sumw2 = profile_1d->GetBinSumw2();
+    }
+    else if(profile_2d != NULL)
+    {
+        entries_sumw2 = profile_2d->GetBinSumw2();
+    }
+    else if(profile_3d != NULL)
+    {
+        entries_sumw2 = profile_3d->GetBinSumw2();
+    }
+    vector<double> means(n_cells);
+    vector<double> entries(n_cells);
+    for(hsize_t i = 0; i < n_cells; i++)
+    {
+        means[i] = histogram->GetBinContent((Int_t)i);
+        if(profile_1d != NULL)
+        {
+            entries[i] = profile_1d->GetBinEntries((Int_t)i);
+        }
+        else if(profile_2d != NULL)
+        {
+            entries[i] = profile_2d->GetBinEntries((Int_t)i);
+        }
+        else if(profile_3d != NULL)
+        {
+            entries[i] = profile_3d->GetBinEntries((Int_t)i);
+        }
+    }
+
+    bool success = write_dataset(group,
+                                 "contents",
+                                 H5T_NATIVE_DOUBLE,
+                                 rank,
+                                 dimensions,
+                                 &means[0])
+                   && write_dataset(group,
+                                    "entries",
+                                    H5T_NATIVE_DOUBLE,
+                                    rank,
+                                    dimensions,
+                                    &entries[0]);
+    if(success
+       && entries_sumw2 != NULL
+       && entries_sumw2->GetSize() == (Int_t)n_cells)
+    {
+        success = write_dataset(group,
+                                "entries_sumw2",
+                                H5T_NATIVE_DOUBLE,
+                                rank,
+                                dimensions,
+                                entries_sumw2->GetArray());
+    }
+
+    return success;
+}
+
+
+bool root2hdf5::histogram::convert(TH1 *histogram, hid_t parent_destination)
+{
+    // Figure out the storage type of the histogram.  Every concrete TH1 class
+    // also derives from the TArray holding its bin contents.
+    hid_t contents_type = -1;
+    const void *contents = NULL;
+    if(TArrayD *array = dynamic_cast<TArrayD *>(histogram))
+    {
+        contents_type = H5T_NATIVE_DOUBLE;
+        contents = array->GetArray();
+    }
+    else if(TArrayF *array = dynamic_cast<TArrayF *>(histogram))
+    {
+        contents_type = H5T_NATIVE_FLOAT;
+        contents = array->GetArray();
+    }
+    else if(TArrayI *array = dynamic_cast<TArrayI *>(histogram))
+    {
+        contents_type = H5T_NATIVE_INT;
+        contents = array->GetArray();
+    }
+    else if(TArrayS *array = dynamic_cast<TArrayS *>(histogram))
+    {
+        contents_type = H5T_NATIVE_SHORT;
+        contents = array->GetArray();
+    }
+    else if(TArrayC *array = dynamic_cast<TArrayC *>(histogram))
+    {
+        contents_type = H5T_NATIVE_SCHAR;
+        contents = array->GetArray();
+    }
+    else if(TArrayL64 *array = dynamic_cast<TArrayL64 *>(histogram))
+    {
+        contents_type = H5T_NATIVE_LLONG;
+        contents = array->GetArray();
+    }
+    else
+    {
+        if(verbose)
+        {
+            cerr << "WARNING: Histogram \"" << histogram->GetName() << "\" has "
+                 << "unknown storage - skipping" << endl;
+        }
+
+        return true;
+    }
+
+    // Compute the shape, slowest-varying axis first, to match ROOT's global
+    // bin numbering
+    int rank = histogram->GetDimension();
+    hsize_t dimensions[3];
+    TAxis *axes[3] = {
+        histogram->GetXaxis(),
+        histogram->GetYaxis(),
+        histogram->GetZaxis()
+    };
+    for(int i = 0; i < rank; i++)
+    {
+        dimensions[rank - 1 - i] = axes[i]->GetNbins() + 2;
+    }
+
+    // Create the group and write everything
+    hid_t group = create_histogram_group(parent_destination,
+                                         histogram->GetName());
+    if(group < 0)
+    {
+        return false;
+    }
+    // Profiles keep the weighted sums of their values where other
+    // histograms keep their contents.  These only mean something together
+    // with the sum of weights in each bin, so profiles get their raw sums
+    // under their own names, along with the means and sums of weights.
+    bool profile = is_profile(histogram);
+    bool success = write_dataset(group,
+                                 profile ? "sum_wy" : "contents",
+                                 contents_type,
+                                 rank,
+                                 dimensions,
+                                 contents);
+    const TArrayD *sumw2 = histogram->GetSumw2();
+    if(success && sumw2 != NULL && sumw2->GetSize() > 0)
+    {
+        success = write_dataset(group,
+                                profile ? "sum_wy2" : "sumw2",
+                                H5T_NATIVE_DOUBLE,
+                                rank,
+                                dimensions,
+                                sumw2->GetArray());
+    }
+    if(success && profile)
+    {
+        success = write_profile_datasets(group, histogram, rank, dimensions);
+    }
+    static const char *edge_names[3] = {"x_edges", "y_edges", "z_edges"};
+    for(int i = 0; success && i < rank; i++)
+    {
+        success = write_axis_edges(group, edge_names[i], axes[i]);
+    }
+
+    return close_histogram_group(group, histogram->GetName()) && success;
+}
+
+
+bool root2hdf5::histogram::convert(THnBase *histogram, hid_t parent_destination)
+{
+    // Create the group
+    hid_t group = create_histogram_group(parent_destination,
+                                         histogram->GetName());
+    if(group < 0)
+    {
+        return false;
+    }
+
+    // Write the axes, and compute the dense shape while we're at it
+    int rank = histogram->GetNdimensions();
+    vector<hsize_t> dimensions(rank);
+    bool success = true;
+    for(int i = 0; success && i < rank; i++)
+    {
+        dimensions[i] = histogram->GetAxis(i)->GetNbins() + 2;
+
+        stringstream name;
+        name << "axis_" << i << "_edges";
+        success = write_axis_edges(group, name.str(), histogram->GetAxis(i));
+    }
+
+    Long64_t n_bins = histogram->GetNbins();
+    bool has_sumw2 = histogram->GetCalculateErrors();
+    if(success && histogram->InheritsFrom(THnSparse::Class()))
+    {
+        // Write sparse histograms as coordinates and values of the filled
+        // bins only
+        vector<Int_t> coordinates(n_bins * rank);
+        vector<double> values(n_bins);
+        vector<double> sumw2(has_sumw2 ? n_bins : 0);
+        for(Long64_t i = 0; i < n_bins; i++)
+        {
+            values[i] = histogram->GetBinContent(i, &coordinates[i * rank]);
+            if(has_sumw2)
+            {
+                sumw2[i] = histogram->GetBinError2(i);
+            }
+        }
+
+        hsize_t coordinate_dimensions[2] = {(hsize_t)n_bins, (hsize_t)rank};
+        hsize_t value_dimensions = n_bins;
+        success = write_dataset(group,
+                                "coordinates",
+                                H5T_NATIVE_INT,
+                                2,
+                                coordinate_dimensions,
+                                n_bins > 0 ? &coordinates[0] : NULL)
+                  && write_dataset(group,
+                                   "values",
+                                   H5T_NATIVE_DOUBLE,
+                                   1,
+                                   &value_dimensions,
+                                   n_bins > 0 ? &values[0] : NULL)
+                  && (!has_sumw2
+                      || write_dataset(group,
+                                       "sumw2",
+                                       H5T_NATIVE_DOUBLE,
+                                       1,
+                                       &value_dimensions,
+                                       n_bins > 0 ? &sumw2[0] : NULL));
+    }
+    else if(success)
+    {
+        // THn keeps its storage private, so gather the dense contents through
+        // its linear bin index, which follows the same ordering as our
+        // dataset shape
+        vector<double> contents(n_bins);
+        vector<double> sumw2(has_sumw2 ? n_bins : 0);
+        for(Long64_t i = 0; i < n_bins; i++)
+        {
+            contents[i] = histogram->GetBinContent(i);
+            if(has_sumw2)
+            {
+                sumw2[i] = histogram->GetBinError2(i);
+            }
+        }
+
+        success = write_dataset(group,
+                                "contents",
+                                H5T_NATIVE_DOUBLE,
+                                rank,
+                                &dimensions[0],
+                                &contents[0])
+                  && (!has_sumw2
+                      || write_dataset(group,
+                                       "sumw2",
+                                       H5T_NATIVE_DOUBLE,
+                                       rank,
+                                       &dimensions[0],
+                                       &sumw2[0]));
+    }
+
+    return close_histogram_group(group, histogram->GetName()) && success;
+}
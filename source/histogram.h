@@ -0,0 +1,40 @@
+#pragma once
+
+// ROOT includes
+#include <TH1.h>
+#include <THnBase.h>
+
+// HDF5 includes
+#include <hdf5.h>
+
+
+namespace root2hdf5
+{
+    namespace histogram
+    {
+        // This method converts a TH1 (or TH2/TH3, which derive from it) into
+        // an HDF5 group named after the histogram.  The group contains a
+        // "contents" dataset with one dimension per histogram axis (slowest
+        // varying first, i.e. [z][y][x]) including the underflow and overflow
+        // bins, a "sumw2" dataset of the same shape if the histogram stores
+        // squared weights, and an "<axis>_edges" dataset for each axis.  The
+        // contents are written directly from the histogram's contiguous
+        // storage in its native type.  Profiles (TProfile, TProfile2D and
+        // TProfile3D) instead store their weighted sums of values and squared
+        // values as "sum_wy" and "sum_wy2", with the bin means as "contents",
+        // the sums of weights as "entries" and, if the profile keeps them,
+        // the sums of squared weights as "entries_sumw2".  Returns true on
+        // success, false on failure.
+        bool convert(TH1 *histogram, hid_t parent_destination);
+
+        // This method converts a THn or THnSparse into an HDF5 group named
+        // after the histogram, with an "axis_<n>_edges" dataset for each axis.
+        // Dense histograms get "contents" (and optionally "sumw2") datasets
+        // shaped like those of TH1, with axis 0 varying slowest.  Sparse
+        // histograms are written in coordinate (COO) form, with a
+        // "coordinates" dataset holding the bin index along each axis for
+        // every filled bin, and matching "values" (and optionally "sumw2")
+        // datasets.  Returns true on success, false on failure.
+        bool convert(THnBase *histogram, hid_t parent_destination);
+    }
+}
@@ -0,0 +1,397 @@
+#include "inspect.h"
+
+// Standard includes
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// HACK: Use Boost.Tuple instead of std::tuple because at the moment, the LLVM-
+// provided libc++ doesn't support the std::tuple, and Boost.Tuple is
+// effectively the same thing.
+// Boost includes
+#include <boost/tuple/tuple.hpp>
+
+// ROOT includes
+#include <TBranch.h>
+#include <TLeaf.h>
+
+// HDF5 includes
+#include <hdf5.h>
+
+// root2hdf5 includes
+#include "options.h"
+#include "catalog.h"
+#include "tree/walk.h"
+#include "tree/structure.h"
+#include "tree/map_hdf5.h"
+#include "tree/leaf_converters.h"
+#include "tree/pack.h"
+#include "tree/booleans.h"
+#include "tree/leaf_converters/string_converter.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::inspect;
+using namespace root2hdf5::options;
+using namespace root2hdf5::catalog;
+using namespace root2hdf5::tree::walk;
+using namespace root2hdf5::tree::structure;
+using namespace root2hdf5::tree::map_hdf5;
+using namespace root2hdf5::tree::leaf_converters;
+using namespace root2hdf5::tree::pack;
+using namespace root2hdf5::tree::booleans;
+using namespace root2hdf5::tree::leaf_converters::string_converter;
+
+
+// Private namespace members
+namespace root2hdf5
+{
+    namespace inspect
+    {
+        // Formats a byte count in human-readable units
+        string format_bytes(double bytes);
+
+        // Returns a short name for the class of an HDF5 type
+        string hdf5_type_class_name(hid_t type);
+
+        // Prints the members of an HDF5 compound type, recursing into nested
+        // compound types.  The offsets printed are relative to the top-level
+        // type.
+        bool print_compound_layout(hid_t type,
+                                   size_t base_offset,
+                                   unsigned depth);
+
+        // Recursive implementation of inspect which tracks the path of the
+        // directory being inspected
+        bool inspect_directory(TDirectory *directory, const string & path);
+    }
+}
+
+
+string root2hdf5::inspect::format_bytes(double bytes)
+{
+    static const char *units[] = {"B", "KB", "MB", "GB", "TB"};
+    unsigned unit = 0;
+    while(bytes >= 1024.0 && unit < 4)
+    {
+        bytes /= 1024.0;
+        unit++;
+    }
+
+    stringstream result;
+    result << fixed << setprecision(unit == 0 ? 0 : 2) << bytes << " "
+           << units[unit];
+    return result.str();
+}
+
+
+string root2hdf5::inspect::hdf5_type_class_name(hid_t type)
+{
+    switch(H5Tget_class(type))
+    {
+        case H5T_INTEGER:
+            return "integer";
+        case H5T_FLOAT:
+            return "float";
+        case H5T_STRING:
+            return "string";
+        case H5T_BITFIELD:
+            return "bitfield";
+        case H5T_OPAQUE:
+            return "opaque";
+        case H5T_COMPOUND:
+            return "compound";
+        case H5T_ENUM:
+            return "enum";
+        case H5T_VLEN:
+            return "vlen";
+        case H5T_ARRAY:
+            return "array";
+        default:
+            return "unknown";
+    }
+}
+
+
+bool root2hdf5::inspect::print_compound_layout(hid_t type,
+                                               size_t base_offset,
+                                               unsigned depth)
+{
+    int n_members = H5Tget_nmembers(type);
+    if(n_members < 0)
+    {
+        return false;
+    }
+
+    for(unsigned i = 0; i < (unsigned)n_members; i++)
+    {
+        // Grab the member description
+        char *name = H5Tget_member_name(type, i);
+        size_t offset = base_offset + H5Tget_member_offset(type, i);
+        hid_t member_type = H5Tget_member_type(type, i);
+        if(name == NULL || member_type < 0)
+        {
+            H5free_memory(name);
+            return false;
+        }
+
+        // Print it
+        cout << string(2 * depth, ' ')
+             << setw(8) << offset << "  "
+             << setw(6) << H5Tget_size(member_type) << "  "
+             << setw(8) << left << hdf5_type_class_name(member_type) << right
+             << "  " << name << endl;
+        H5free_memory(name);
+
+        // Recurse into nested compounds
+        bool success = true;
+        if(H5Tget_class(member_type) == H5T_COMPOUND)
+        {
+            success = print_compound_layout(member_type, offset, depth + 1);
+        }
+
+        H5Tclose(member_type);
+        if(!success)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+bool root2hdf5::inspect::inspect_tree(TTree *tree)
+{
+    // Print the tree summary
+    Long64_t n_entries = tree->GetEntries();
+    double root_zip_bytes = (double)tree->GetZipBytes();
+    double root_tot_bytes = (double)tree->GetTotBytes();
+    cout << "tree " << tree->GetName() << ": " << n_entries << " entries, "
+         << format_bytes(root_zip_bytes) << " compressed, "
+         << format_bytes(root_tot_bytes) << " uncompressed" << endl;
+
+    // Decide how string leaves are stored, just like conversion does, so that
+    // the converters and layout below are the ones conversion would use
+    if(!choose_string_encodings(tree))
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Unable to choose string encodings for tree \""
+                 << tree->GetName() << "\"" << endl;
+        }
+
+        return false;
+    }
+
+    // Walk the tree, printing each branch and leaf along with the converter
+    // that would be used for it.  We also tally up the uncompressed ROOT size
+    // of any leaves which end up as variable-length HDF5 data, because their
+    // payload lives outside of the fixed-size rows.
+    unsigned depth = 1;
+    double variable_length_bytes = 0.0;
+    unsigned n_skipped = 0;
+    bool success = walk_tree(
+        tree,
+
+        // Branch open
+        [&depth](TBranch *branch) -> bool {
+            cout << string(2 * depth, ' ') << "branch " << branch->GetName()
+                 << " (" << format_bytes((double)branch->GetZipBytes("*"))
+                 << " compressed, "
+                 << format_bytes((double)branch->GetTotBytes("*"))
+                 << " uncompressed)" << endl;
+            depth++;
+            return true;
+        },
+
+        // Leaf process
+        [&depth, &variable_length_bytes, &n_skipped](TLeaf *leaf) -> bool {
+            TBranch *branch = leaf->GetBranch();
+            cout << string(2 * depth, ' ') << "leaf " << leaf->GetName()
+                 << " <" << leaf->GetTypeName() << ">";
+
+            // Find a converter, or explain why the leaf will be skipped
+            leaf_converter *converter = find_converter(leaf);
+            if(converter == NULL)
+            {
+                cout << " -> skipped (no converter for type \""
+                     << leaf->GetTypeName() << "\")" << endl;
+                n_skipped++;
+                return true;
+            }
+            cout << " -> " << converter->name << " converter";
+
+            // Only single-leaf branches have a storage size that can be
+            // attributed to an individual leaf
+            if(branch->GetListOfLeaves()->GetEntries() == 1)
+            {
+                cout << " (" << format_bytes((double)branch->GetZipBytes())
+                     << " compressed, "
+                     << format_bytes((double)branch->GetTotBytes())
+                     << " uncompressed)";
+            }
+            cout << endl;
+
+            // Check whether the leaf will produce variable-length data.
+            // Generating the type doesn't touch any baskets.
+            vector<hdf5_type_deallocator> deallocators;
+            hid_t leaf_type = converter->hdf5_type_for_leaf(leaf, deallocators);
+            if(leaf_type >= 0
+               && (H5Tdetect_class(leaf_type, H5T_VLEN) > 0
+                   || H5Tis_variable_str(leaf_type) > 0))
+            {
+                variable_length_bytes += (double)branch->GetTotBytes()
+                                         / branch->GetListOfLeaves()
+                                           ->GetEntries();
+            }
+            for(auto it = deallocators.rbegin();
+                it != deallocators.rend();
+                it++)
+            {
+                if(!(*it)())
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        },
+
+        // Branch close
+        [&depth](TBranch *branch) -> bool {
+            // Silence unused variable warnings
+            (void)branch;
+
+            depth--;
+            return true;
+        }
+    );
+    if(!success)
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Unable to walk tree \"" << tree->GetName() << "\""
+                 << endl;
+        }
+
+        return false;
+    }
+
+    // Generate the conversion struct and HDF5 type exactly as conversion
+    // would, and print the resulting compound layout
+    if(!create_struct_code_for_tree(tree))
+    {
+        return false;
+    }
+    hid_t hdf5_type = -1;
+    hdf5_type_deallocator hdf5_deallocator;
+    boost::tie(hdf5_type, hdf5_deallocator) = hdf5_type_for_tree(tree);
+    if(hdf5_type == -1)
+    {
+        return false;
+    }
+    size_t row_size = H5Tget_size(hdf5_type);
+    hid_t file_type = packed_type(hdf5_type);
+    if(file_type >= 0 && pack_booleans_requested())
+    {
+        vector<string> bit_paths;
+        hid_t bits_type = boolean_file_type(file_type,
+                                            boolean_leaf_paths(tree),
+                                            bit_paths);
+        H5Tclose(file_type);
+        file_type = bits_type;
+    }
+    size_t file_row_size = file_type >= 0 ? H5Tget_size(file_type) : row_size;
+    if(file_type >= 0)
+    {
+        H5Tclose(file_type);
+    }
+    cout << "  compound layout (" << row_size << " bytes per row in memory, "
+         << file_row_size << " packed on disk):" << endl
+         << "  " << setw(8) << "offset" << "  " << setw(6) << "size" << "  "
+         << setw(8) << left << "class" << right << "  member" << endl;
+    success = print_compound_layout(hdf5_type, 0, 1);
+    if(!hdf5_deallocator() || !success)
+    {
+        return false;
+    }
+
+    // Project the output size from the packed rows.  The fixed-size part is
+    // exact, while the variable-length payload is estimated from the
+    // uncompressed ROOT size of the corresponding branches.  root2hdf5 doesn't
+    // compress its output, so there is no compressed projection.
+    double fixed_bytes = (double)file_row_size * n_entries;
+    double uncompressed_bytes = fixed_bytes + variable_length_bytes;
+    cout << "  projected HDF5 size: " << format_bytes(uncompressed_bytes);
+    if(variable_length_bytes > 0.0)
+    {
+        cout << " (" << format_bytes(fixed_bytes) << " fixed + ~"
+             << format_bytes(variable_length_bytes) << " variable-length)";
+    }
+    cout << endl;
+    if(n_skipped > 0)
+    {
+        cout << "  " << n_skipped << " leaves will be skipped" << endl;
+    }
+
+    return true;
+}
+
+
+bool root2hdf5::inspect::inspect_directory(TDirectory *directory,
+                                           const string & path)
+{
+    // Catalog the keys the same way conversion does, so only directories and
+    // tree headers are ever read
+    vector<catalog_entry> entries = catalog_directory(directory);
+    for(auto it = entries.begin(); it != entries.end(); it++)
+    {
+        string object_path = path + it->key->GetName();
+        if(it->kind == directory_object)
+        {
+            cout << object_path << "/: group" << endl;
+            if(!inspect_directory((TDirectory *)it->key->ReadObj(),
+                                  object_path + "/"))
+            {
+                return false;
+            }
+        }
+        else if(it->kind == tree_object)
+        {
+            // Reading a TTree object only reads its header, not its baskets
+            cout << object_path << ": ";
+            TTree *tree = (TTree *)it->key->ReadObj();
+            bool success = inspect_tree(tree);
+            delete tree;
+            if(!success)
+            {
+                return false;
+            }
+        }
+        else if(it->kind == histogram_object
+                || it->kind == multidimensional_histogram_object)
+        {
+            cout << object_path << ": histogram <" << it->key->GetClassName()
+                 << ">, " << it->key->GetObjlen() << " bytes" << endl;
+        }
+        else
+        {
+            cout << object_path << ": skipped (unhandled object type \""
+                 << it->key->GetClassName() << "\")" << endl;
+        }
+    }
+
+    return true;
+}
+
+
+bool root2hdf5::inspect::inspect(TDirectory *directory)
+{
+    return inspect_directory(directory, "/");
+}
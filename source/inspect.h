@@ -0,0 +1,26 @@
+#pragma once
+
+// ROOT includes
+#include <TDirectory.h>
+#include <TTree.h>
+
+
+namespace root2hdf5
+{
+    namespace inspect
+    {
+        // This method walks a ROOT directory in the same manner as
+        // root2hdf5::convert::convert, but instead of converting anything it
+        // prints the plan that conversion would follow: every tree, branch and
+        // leaf with the leaf converter chosen for it (or the reason it would
+        // be skipped), the compound layout of the resulting HDF5 type, the
+        // ROOT storage sizes, and a projected HDF5 output size.  No baskets
+        // are read and no dictionaries are compiled.  Returns true on success,
+        // false on failure.
+        bool inspect(TDirectory *directory);
+
+        // This method prints the conversion plan for a single TTree.  Returns
+        // true on success, false on failure.
+        bool inspect_tree(TTree *tree);
+    }
+}
@@ -31,16 +31,102 @@ void root2hdf5::options::parse_command_line_options(int argc, char * argv[])
 {
     // Set up named arguments which are visible to the user
     po::options_description options_specification(
-        "usage: root2hdf5 [options] <input-url> <output-url>"
+        "usage: root2hdf5 [options] <input-url> <output-url>\n"
+        "       root2hdf5 [options] --batch <manifest>"
     );
     options_specification.add_options()
         ("input-url,i",
-            po::value<string>()->value_name("<input-url>")->required(),
+            po::value<string>()->value_name("<input-url>"),
             "Input URL")
         ("output-url,o",
-            po::value<string>()->value_name("<output-url>")->required(),
-            "Output URL")
+            po::value<string>()->value_name("<output-url>"),
+            "Output URL, or \"-\" to build the file in memory and write it "
+            "to stdout")
         ("overwrite,O", "Overwrite the output path.")
+        ("inspect",
+            "Print the conversion plan and projected output sizes for the "
+            "input without converting anything.")
+        ("batch",
+            po::value<string>()->value_name("<manifest>"),
+            "Convert every \"<input-url> <output-url>\" pair listed in the "
+            "manifest file, one pair per line.")
+        ("workers",
+            po::value<unsigned>()->value_name("<n>")->default_value(1),
+            "Number of worker processes to use in batch mode.")
+        ("index",
+            po::value<string>()->value_name("<columns>"),
+            "Write a sorted index of each tree by the comma-separated leaves "
+            "(e.g. run,event) next to the tree's dataset, as "
+            "\"<tree>.index\".")
+        ("ignore-friends",
+            "Don't merge the branches of friend trees into the datasets of "
+            "the trees they are attached to.")
+        ("entry-list",
+            po::value<string>()->value_name("<name>"),
+            "Only convert the entries of each tree selected by the named "
+            "TEntryList, which is looked up next to the tree.")
+        ("entry-list-file",
+            po::value<string>()->value_name("<url>"),
+            "Look the --entry-list up in this file instead.")
+        ("statistics",
+            "Write the minimum, maximum and NaN count of every numeric column "
+            "for each chunk of each tree as \"<tree>.statistics\".")
+        ("bloom-filter",
+            po::value<string>()->value_name("<columns>"),
+            "Also write a bloom filter for each chunk of the comma-separated "
+            "integer columns (requires --statistics).")
+        ("progress",
+            "Show a live progress line with throughput and ETA on stderr.")
+        ("status-file",
+            po::value<string>()->value_name("<path>"),
+            "Periodically write machine-readable progress to this file "
+            "(suffixed with the process id in batch mode).")
+        ("profile-branches",
+            po::value<unsigned>()->implicit_value(20)->value_name("<n>"),
+            "Time reading and converting each branch and print the n (by "
+            "default 20) most expensive branches of each tree.")
+        ("memory-limit",
+            po::value<unsigned>()->value_name("<MB>"),
+            "Fail if the in-memory output file for \"-o -\" grows beyond "
+            "this size.")
+        ("max-output-size",
+            po::value<unsigned>()->value_name("<MB>"),
+            "Roll tree data over into numbered part files (out.0001.h5, "
+            "out.0002.h5, ...) of at most this size, and make the output "
+            "an index of virtual datasets exposing each tree as one "
+            "dataset.")
+        ("split-by-prefix",
+            "Split each tree into a dataset per branch name prefix (the part "
+            "before the first underscore), named \"<tree>.<prefix>\", with "
+            "unprefixed branches kept in \"<tree>\".")
+        ("split-row-bytes",
+            po::value<unsigned>()->value_name("<n>"),
+            "Split each tree into datasets \"<tree>.0\", \"<tree>.1\", ... "
+            "of consecutive branches, about n bytes per row each.")
+        ("no-bulk-read",
+            "Read every branch entry by entry, rather than reading flat "
+            "scalar branches a basket at a time with ROOT's bulk I/O API.")
+        ("big-endian",
+            "Write bulk-read scalar branches in the big-endian byte order "
+            "ROOT stores them in, rather than swapping them to native order.")
+        ("pack-booleans",
+            "Store the boolean leaves of each tree as bits of a single "
+            "bitfield column, named in its \"boolean_bits\" attribute, "
+            "rather than as a byte each.")
+        ("read-threads",
+            po::value<unsigned>()->value_name("<n>"),
+            "Read and unzip branches on n threads with ROOT's implicit "
+            "multi-threading, which also unzip upcoming clusters ahead of "
+            "conversion.")
+        ("converter-plugin-dir",
+            po::value<string>()->value_name("<path>"),
+            "Load the leaf converters of every shared library in this "
+            "directory, trying them before the built-in converters.")
+        ("cache-dir",
+            po::value<string>()->value_name("<path>"),
+            "Directory for persistent conversion plans and compiled "
+            "dictionaries (default: ~/.cache/root2hdf5).")
+        ("no-cache", "Don't read or write the persistent cache.")
         ("verbose,v", "Print output of file operations.")
         ("help,h", "Print this message and exit.")
     ;
@@ -69,8 +155,13 @@ void root2hdf5::options::parse_command_line_options(int argc, char * argv[])
             exit(EXIT_SUCCESS);
         }
 
-        // Print help if no (or not enough) paths were specified
-        if(options.count("input-url") == 0 || options.count("output-url") == 0)
+        // Print help if no (or not enough) paths were specified.  Inspection
+        // doesn't produce any output, so it only needs the input path, and
+        // batch mode takes its paths from the manifest.
+        if(options.count("batch") == 0
+           && (options.count("input-url") == 0
+               || (options.count("output-url") == 0
+                   && options.count("inspect") == 0)))
         {
             cout << options_specification << endl;
             exit(EXIT_FAILURE);
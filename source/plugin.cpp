@@ -0,0 +1,229 @@
+#include "plugin.h"
+
+// POSIX includes
+#include <dlfcn.h>
+
+// Standard includes
+#include <algorithm>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+// Boost includes
+// HACK: Need to define this macro to tell Boost not to use deprecated
+// Boost.System constructs which result in unused-variable errors.
+#ifndef BOOST_SYSTEM_NO_DEPRECATED
+#define BOOST_SYSTEM_NO_DEPRECATED 1
+#endif
+#include <boost/filesystem.hpp>
+
+// root2hdf5 includes
+#include "options.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// Boost namespace aliases
+namespace fs = boost::filesystem;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::plugin;
+using namespace root2hdf5::options;
+using namespace root2hdf5::tree::leaf_converters;
+
+
+// Private namespace members
+namespace root2hdf5
+{
+    namespace plugin
+    {
+        // The file extension of loadable shared libraries
+#ifdef __APPLE__
+        const char * const library_extension = ".dylib";
+#else
+        const char * const library_extension = ".so";
+#endif
+
+        // Canonical paths of the libraries loaded so far
+        set<string> _loaded_libraries;
+
+        // Set if the library currently registering handed over a converter
+        // which is missing one of its required callbacks
+        bool _registration_failed = false;
+
+        // The registrar handed to plugins, which checks each converter
+        // before registering it
+        void register_plugin_converter(const leaf_converter & converter);
+
+        // Loads a single library and registers its converters
+        bool load_library(const fs::path & path);
+    }
+}
+
+
+string root2hdf5::plugin::converter_plugin_dir()
+{
+    if(root2hdf5::options::options.count("converter-plugin-dir") == 0)
+    {
+        return string();
+    }
+
+    return root2hdf5::options::options["converter-plugin-dir"].as<string>();
+}
+
+
+void root2hdf5::plugin::register_plugin_converter(
+    const leaf_converter & converter
+)
+{
+    if(converter.name.empty()
+       || !converter.can_handle
+       || !converter.member_for_conversion_struct
+       || !converter.hdf5_type_for_leaf
+       || !converter.map_leaf_and_build_converter)
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Plugin converter \"" << converter.name
+                 << "\" must have a name and every required callback" << endl;
+        }
+
+        _registration_failed = true;
+        return;
+    }
+
+    register_converter(converter);
+}
+
+
+bool root2hdf5::plugin::load_library(const fs::path & path)
+{
+    // Keep the plugin's symbols to itself, and resolve everything up front so
+    // that missing symbols show up here rather than mid-conversion
+    void *library = dlopen(path.native().c_str(), RTLD_NOW | RTLD_LOCAL);
+    if(library == NULL)
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Unable to load converter plugin \""
+                 << path.native() << "\": " << dlerror() << endl;
+        }
+
+        return false;
+    }
+
+    // Check that the plugin was built against this interface
+    abi_version_function abi_version =
+        (abi_version_function)dlsym(library, abi_version_symbol);
+    registration_function registration =
+        (registration_function)dlsym(library, registration_symbol);
+    if(abi_version == NULL || registration == NULL)
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: \"" << path.native() << "\" is not a converter "
+                 << "plugin (missing " << abi_version_symbol << " or "
+                 << registration_symbol << ")" << endl;
+        }
+
+        dlclose(library);
+        return false;
+    }
+    unsigned version = abi_version();
+    if(version != ROOT2HDF5_PLUGIN_ABI_VERSION)
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Converter plugin \"" << path.native()
+                 << "\" was built for plugin ABI version " << version
+                 << ", but this is version " << ROOT2HDF5_PLUGIN_ABI_VERSION
+                 << endl;
+        }
+
+        dlclose(library);
+        return false;
+    }
+
+    // Register the converters.  The library stays loaded from here on, even
+    // if registration fails, since some converters may already refer to it.
+    _registration_failed = false;
+    if(!registration(register_plugin_converter) || _registration_failed)
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Unable to register the converters of plugin \""
+                 << path.native() << "\"" << endl;
+        }
+
+        return false;
+    }
+
+    if(verbose)
+    {
+        cout << "Loaded converter plugin " << path.filename().native()
+             << endl;
+    }
+
+    return true;
+}
+
+
+bool root2hdf5::plugin::load_converter_plugins()
+{
+    string directory = converter_plugin_dir();
+    if(directory.empty())
+    {
+        return true;
+    }
+
+    // Collect the libraries in the directory.  They are loaded in filename
+    // order, so that the priority of their converters is predictable.
+    boost::system::error_code error;
+    vector<fs::path> libraries;
+    fs::directory_iterator it(directory, error), end;
+    for(; !error && it != end; it.increment(error))
+    {
+        if(fs::is_regular_file(it->status())
+           && it->path().extension() == library_extension)
+        {
+            libraries.push_back(it->path());
+        }
+    }
+    if(error)
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Unable to list converter plugin directory \""
+                 << directory << "\": " << error.message() << endl;
+        }
+
+        return false;
+    }
+    sort(libraries.begin(), libraries.end());
+
+    // Load each library that hasn't been loaded yet
+    for(auto library = libraries.begin();
+        library != libraries.end();
+        library++)
+    {
+        string canonical = fs::canonical(*library, error).native();
+        if(error)
+        {
+            canonical = library->native();
+        }
+        if(_loaded_libraries.count(canonical))
+        {
+            continue;
+        }
+        _loaded_libraries.insert(canonical);
+
+        if(!load_library(*library))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+// Standard includes
+#include <string>
+
+// root2hdf5 includes
+#include "tree/leaf_converters.h"
+
+
+// The version of the converter plugin interface.  This must be bumped whenever
+// the leaf_converter struct, or any of the types its callbacks take, changes
+// shape, and the loader refuses plugins built against any other version.
+// Since leaf_converter holds standard library types, plugins must also be
+// built with the same compiler and standard library as root2hdf5 itself.
+#define ROOT2HDF5_PLUGIN_ABI_VERSION 1
+
+// Defines the entry points of a converter plugin.  A plugin is a shared
+// library which includes this header and follows the macro with the body of
+// its registration function, e.g.
+//
+//     ROOT2HDF5_CONVERTER_PLUGIN(registrar)
+//     {
+//         registrar(my_converter);
+//         return true;
+//     }
+//
+// The body hands each of the plugin's leaf converters to the registrar and
+// returns true, or false if the plugin can't be used.  Converters whose
+// members are plain scalars of the leaf's type may set can_bulk_read to have
+// their leaves read a basket at a time, just like the built-in scalar
+// converter.
+#define ROOT2HDF5_CONVERTER_PLUGIN(registrar) \
+    extern "C" unsigned root2hdf5_plugin_abi_version() \
+    { \
+        return ROOT2HDF5_PLUGIN_ABI_VERSION; \
+    } \
+    extern "C" bool root2hdf5_register_converters( \
+        root2hdf5::plugin::converter_registrar registrar \
+    )
+
+
+namespace root2hdf5
+{
+    namespace plugin
+    {
+        // Callback type through which a plugin registers its converters.
+        // Plugins are handed this rather than linking against root2hdf5, so
+        // they don't depend on any of its symbols.
+        typedef void (*converter_registrar)(
+            const root2hdf5::tree::leaf_converters::leaf_converter &
+        );
+
+        // Types and names of the entry points every plugin exports
+        typedef unsigned (*abi_version_function)();
+        typedef bool (*registration_function)(converter_registrar);
+        const char * const abi_version_symbol = "root2hdf5_plugin_abi_version";
+        const char * const registration_symbol =
+            "root2hdf5_register_converters";
+
+        // Returns the --converter-plugin-dir, or an empty string if no
+        // plugins should be loaded
+        std::string converter_plugin_dir();
+
+        // Loads every shared library in the --converter-plugin-dir, in
+        // filename order, and registers their converters ahead of the
+        // built-in ones.  Libraries are only ever loaded once per process,
+        // and are never unloaded, since the converters refer to their code.
+        // Returns false if any library can't be loaded or registered.
+        bool load_converter_plugins();
+    }
+}
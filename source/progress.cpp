@@ -0,0 +1,222 @@
+#include "progress.h"
+
+// POSIX includes
+#include <unistd.h>
+
+// C Standard includes
+#include <cstdio>
+
+// Standard includes
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+// root2hdf5 includes
+#include "options.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::progress;
+
+
+// Global variable declarations
+namespace root2hdf5
+{
+    namespace progress
+    {
+        progress_counters counters;
+    }
+}
+
+
+// Private namespace members
+namespace root2hdf5
+{
+    namespace progress
+    {
+        // How often the reporting thread wakes up
+        const chrono::milliseconds report_interval(1000);
+
+        // Width of the progress bar
+        const unsigned bar_width = 30;
+
+        // The state of the reporting thread
+        struct reporter_state
+        {
+            string tree_name;
+            unsigned long long n_entries;
+            chrono::steady_clock::time_point start;
+            thread reporter;
+            mutex lock;
+            condition_variable wake;
+            bool stop;
+        };
+        reporter_state _reporter;
+
+        // Formats a duration in seconds as h:mm:ss
+        string format_duration(double seconds);
+
+        // Writes a single progress update, which for the final one says
+        // whether the conversion succeeded
+        void report(bool final, bool success = true);
+
+        // The body of the reporting thread
+        void run_reporter();
+    }
+}
+
+
+bool root2hdf5::progress::reporting_requested()
+{
+    return root2hdf5::options::options.count("progress")
+           || root2hdf5::options::options.count("status-file");
+}
+
+
+string root2hdf5::progress::format_duration(double seconds)
+{
+    unsigned long long total = (unsigned long long)(seconds + 0.5);
+    stringstream result;
+    result << total / 3600 << ":" << setfill('0') << setw(2)
+           << (total / 60) % 60 << ":" << setw(2) << total % 60;
+    return result.str();
+}
+
+
+void root2hdf5::progress::report(bool final, bool success)
+{
+    // Take a snapshot of the counters
+    unsigned long long entries
+        = counters.entries.load(memory_order_relaxed);
+    unsigned long long bytes_read
+        = counters.bytes_read.load(memory_order_relaxed);
+    unsigned long long bytes_written
+        = counters.bytes_written.load(memory_order_relaxed);
+    double elapsed = chrono::duration<double>(
+        chrono::steady_clock::now() - _reporter.start
+    ).count();
+
+    // Compute the rates
+    unsigned long long n_entries = _reporter.n_entries;
+    double fraction = n_entries > 0 ? (double)entries / n_entries : 1.0;
+    double entry_rate = elapsed > 0.0 ? entries / elapsed : 0.0;
+    double read_rate = elapsed > 0.0
+                       ? bytes_read / elapsed / (1024.0 * 1024.0)
+                       : 0.0;
+    double write_rate = elapsed > 0.0
+                        ? bytes_written / elapsed / (1024.0 * 1024.0)
+                        : 0.0;
+    double remaining = entry_rate > 0.0
+                       ? (n_entries - entries) / entry_rate
+                       : 0.0;
+
+    // Print the line
+    if(root2hdf5::options::options.count("progress"))
+    {
+        unsigned filled = (unsigned)(fraction * bar_width);
+        cerr << "\r" << _reporter.tree_name << " ["
+             << string(filled, '=') << string(bar_width - filled, ' ')
+             << "] " << fixed << setprecision(1) << 100.0 * fraction << "% "
+             << entries << "/" << n_entries << " entries, "
+             << setprecision(0) << entry_rate << " entries/s, "
+             << setprecision(1) << read_rate << " MB/s read, "
+             << write_rate << " MB/s written, "
+             << (!final ? "ETA " + format_duration(remaining)
+                 : success ? "done in " + format_duration(elapsed)
+                 : "failed after " + format_duration(elapsed))
+             << "   ";
+        if(final)
+        {
+            cerr << endl;
+        }
+        cerr.flush();
+    }
+
+    // Write the status file, replacing the old one atomically so monitors
+    // never see a partial update.  Batch workers each get their own file.
+    if(root2hdf5::options::options.count("status-file"))
+    {
+        string path
+            = root2hdf5::options::options["status-file"].as<string>();
+        if(root2hdf5::options::options.count("batch"))
+        {
+            stringstream worker_path;
+            worker_path << path << "." << getpid();
+            path = worker_path.str();
+        }
+        string temporary_path = path + ".tmp";
+        {
+            ofstream status(temporary_path.c_str());
+            status << "tree " << _reporter.tree_name << endl
+                   << "state "
+                   << (!final ? "running" : success ? "done" : "failed")
+                   << endl
+                   << "entries " << entries << endl
+                   << "total_entries " << n_entries << endl
+                   << "elapsed_seconds " << elapsed << endl
+                   << "entries_per_second " << entry_rate << endl
+                   << "bytes_read " << bytes_read << endl
+                   << "bytes_written " << bytes_written << endl
+                   << "eta_seconds " << (final ? 0.0 : remaining) << endl;
+        }
+        rename(temporary_path.c_str(), path.c_str());
+    }
+}
+
+
+void root2hdf5::progress::run_reporter()
+{
+    unique_lock<mutex> guard(_reporter.lock);
+    while(!_reporter.stop)
+    {
+        _reporter.wake.wait_for(guard, report_interval);
+        if(!_reporter.stop)
+        {
+            report(false);
+        }
+    }
+}
+
+
+void root2hdf5::progress::begin_tree(const string & name,
+                                     unsigned long long n_entries)
+{
+    if(!reporting_requested())
+    {
+        return;
+    }
+
+    counters.entries.store(0, memory_order_relaxed);
+    counters.bytes_read.store(0, memory_order_relaxed);
+    counters.bytes_written.store(0, memory_order_relaxed);
+    _reporter.tree_name = name;
+    _reporter.n_entries = n_entries;
+    _reporter.start = chrono::steady_clock::now();
+    _reporter.stop = false;
+    _reporter.reporter = thread(run_reporter);
+}
+
+
+void root2hdf5::progress::end_tree(bool success)
+{
+    if(!_reporter.reporter.joinable())
+    {
+        return;
+    }
+
+    {
+        lock_guard<mutex> guard(_reporter.lock);
+        _reporter.stop = true;
+    }
+    _reporter.wake.notify_one();
+    _reporter.reporter.join();
+    report(true, success);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+// Standard includes
+#include <atomic>
+#include <string>
+
+
+namespace root2hdf5
+{
+    namespace progress
+    {
+        // Counters for the tree currently being converted.  The conversion
+        // loop only ever bumps these with relaxed atomic adds, and all of the
+        // formatting is done by a separate reporting thread.
+        struct progress_counters
+        {
+            std::atomic<unsigned long long> entries;
+            std::atomic<unsigned long long> bytes_read;
+            std::atomic<unsigned long long> bytes_written;
+        };
+        extern progress_counters counters;
+
+        // Returns true if --progress or --status-file was given
+        bool reporting_requested();
+
+        // Starts reporting the progress of converting a tree with the given
+        // number of entries.  Progress is printed to stderr with --progress,
+        // and written to the --status-file path (atomically replaced on each
+        // update) if one was given.  Does nothing if neither was requested.
+        void begin_tree(const std::string & name,
+                        unsigned long long n_entries);
+
+        // Stops reporting, printing a final update which says whether the
+        // conversion succeeded
+        void end_tree(bool success);
+
+        // Reports progress for as long as it is in scope, so that early
+        // returns from the conversion loop still stop the reporting thread.
+        // The conversion counts as failed unless succeeded() is called before
+        // the scope ends.
+        struct progress_scope
+        {
+            progress_scope(const std::string & name,
+                           unsigned long long n_entries)
+                : _success(false)
+            {
+                begin_tree(name, n_entries);
+            }
+            ~progress_scope()
+            {
+                end_tree(_success);
+            }
+
+            void succeeded()
+            {
+                _success = true;
+            }
+
+        private:
+            bool _success;
+        };
+
+        // Hot loop accessors
+        inline void add_entries(unsigned long long n)
+        {
+            counters.entries.fetch_add(n, std::memory_order_relaxed);
+        }
+        inline void add_bytes_read(unsigned long long n)
+        {
+            counters.bytes_read.fetch_add(n, std::memory_order_relaxed);
+        }
+        inline void add_bytes_written(unsigned long long n)
+        {
+            counters.bytes_written.fetch_add(n, std::memory_order_relaxed);
+        }
+    }
+}
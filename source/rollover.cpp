@@ -0,0 +1,614 @@
+#include "rollover.h"
+
+// C Standard includes
+#include <cstdio>
+
+// Standard includes
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Boost includes
+// HACK: Need to define this macro to tell Boost not to use deprecated
+// Boost.System constructs which result in unused-variable errors.
+#ifndef BOOST_SYSTEM_NO_DEPRECATED
+#define BOOST_SYSTEM_NO_DEPRECATED 1
+#endif
+#include <boost/filesystem.hpp>
+
+// ROOT includes
+#include <TDirectory.h>
+#include <TTree.h>
+
+// root2hdf5 includes
+#include "options.h"
+#include "tree/block.h"
+#include "tree/split.h"
+#include "tree/pack.h"
+#include "tree/booleans.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// Boost namespace aliases
+namespace fs = boost::filesystem;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::rollover;
+using namespace root2hdf5::options;
+using namespace root2hdf5::tree;
+using namespace root2hdf5::tree::block;
+using namespace root2hdf5::tree::split;
+using namespace root2hdf5::tree::pack;
+using namespace root2hdf5::tree::booleans;
+
+
+// Private namespace members
+namespace root2hdf5
+{
+    namespace rollover
+    {
+        // The rows of a tree which ended up in one part file
+        struct segment
+        {
+            string file_name;
+            hsize_t start;
+            hsize_t count;
+        };
+
+        // Everything the rollover sink tracks between calls
+        struct rollover_state
+        {
+            // The output and its limit
+            string output_url;
+            hid_t index_file;
+            hsize_t max_bytes;
+
+            // The current part file, if one is open
+            unsigned part;
+            hid_t part_file;
+            bool part_has_rows;
+
+            // The tree currently being converted
+            string group_path;
+            hsize_t n_rows;
+            hsize_t n_chunk_rows;
+            size_t file_row_bytes;
+            vector<string> dataset_names;
+            vector<hid_t> file_types;
+            vector<packed_layout> layouts;
+            vector<vector<string> > bit_paths;
+            vector<char> packed_buffer;
+
+            // Its datasets in the current part file, and where they started
+            vector<hid_t> datasets;
+            hsize_t segment_start;
+            hsize_t rows_written;
+            vector<segment> segments;
+        };
+
+        // Returns the HDF5 path of the group a tree's datasets go in, which
+        // mirrors the ROOT directory the tree lives in
+        string group_path_for_tree(TTree *tree);
+
+        // Returns the path of a dataset in the tree's group
+        string dataset_path(const rollover_state & state, size_t group);
+
+        // Closes the current part file (if any) and opens the next one
+        bool open_next_part(rollover_state & state);
+
+        // Creates the tree's datasets in the current part file
+        bool create_part_datasets(rollover_state & state);
+
+        // Closes the tree's datasets in the current part file, recording
+        // the rows they hold
+        bool close_part_datasets(rollover_state & state);
+
+        // Creates the tree's virtual datasets in the index file
+        bool create_virtual_datasets(rollover_state & state);
+
+        // Releases the tree's types
+        void release_tree_types(rollover_state & state);
+    }
+}
+
+
+hsize_t root2hdf5::rollover::max_output_size()
+{
+    if(root2hdf5::options::options.count("max-output-size") == 0)
+    {
+        return 0;
+    }
+
+    return (hsize_t)root2hdf5::options::options["max-output-size"]
+        .as<unsigned>() * 1024 * 1024;
+}
+
+
+string root2hdf5::rollover::part_path(const string & output_url,
+                                      unsigned part)
+{
+    fs::path output_path(output_url);
+    char number[16];
+    snprintf(number, sizeof(number), ".%04u", part);
+    return (output_path.parent_path()
+            / (output_path.stem().native()
+               + number
+               + output_path.extension().native())).native();
+}
+
+
+string root2hdf5::rollover::group_path_for_tree(TTree *tree)
+{
+    // ROOT paths look like "file.root:/directory/subdirectory"
+    if(tree->GetDirectory() == NULL)
+    {
+        return "/";
+    }
+    string path = tree->GetDirectory()->GetPath();
+    size_t separator = path.find(":/");
+    if(separator != string::npos)
+    {
+        path = path.substr(separator + 1);
+    }
+    if(path.empty() || path[0] != '/')
+    {
+        return "/";
+    }
+    if(path.size() > 1 && path[path.size() - 1] == '/')
+    {
+        path.erase(path.size() - 1);
+    }
+
+    return path;
+}
+
+
+string root2hdf5::rollover::dataset_path(const rollover_state & state,
+                                         size_t group)
+{
+    return (state.group_path == "/" ? string() : state.group_path)
+           + "/" + state.dataset_names[group];
+}
+
+
+bool root2hdf5::rollover::open_next_part(rollover_state & state)
+{
+    // Close out the current part
+    if(state.part_file >= 0)
+    {
+        if(!close_part_datasets(state))
+        {
+            return false;
+        }
+        if(H5Fclose(state.part_file) < 0)
+        {
+            if(verbose)
+            {
+                cerr << "ERROR: Closing part file "
+                     << part_path(state.output_url, state.part) << " failed"
+                     << endl;
+            }
+            state.part_file = -1;
+
+            return false;
+        }
+        state.part_file = -1;
+    }
+
+    // Open the next one, with the same care for existing files as the
+    // output itself
+    state.part++;
+    string path = part_path(state.output_url, state.part);
+    if(fs::exists(fs::path(path))
+       && root2hdf5::options::options.count("overwrite") == 0)
+    {
+        cerr << "Part file " << path << " exists.  Specify the "
+             << "\"--overwrite\" option if you would like to overwrite it"
+             << endl;
+        return false;
+    }
+    state.part_file = H5Fcreate(path.c_str(),
+                                H5F_ACC_TRUNC,
+                                H5P_DEFAULT,
+                                H5P_DEFAULT);
+    if(state.part_file < 0)
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Unable to create part file: " << path << endl;
+        }
+
+        return false;
+    }
+    state.part_has_rows = false;
+    if(verbose)
+    {
+        cout << "Writing part " << path << endl;
+    }
+
+    return true;
+}
+
+
+bool root2hdf5::rollover::create_part_datasets(rollover_state & state)
+{
+    // Create the datasets empty and let them grow block by block, since we
+    // don't know how many rows will fit.  Missing groups are created on the
+    // way.
+    hsize_t n_initial = 0;
+    hsize_t n_maximum = H5S_UNLIMITED;
+    hid_t space = H5Screate_simple(1, &n_initial, &n_maximum);
+    hid_t link_properties = H5Pcreate(H5P_LINK_CREATE);
+    hid_t properties = H5Pcreate(H5P_DATASET_CREATE);
+    bool success = space >= 0
+                   && link_properties >= 0
+                   && properties >= 0
+                   && H5Pset_create_intermediate_group(link_properties, 1) >= 0
+                   && H5Pset_chunk(properties, 1, &state.n_chunk_rows) >= 0;
+    for(size_t g = 0; success && g < state.dataset_names.size(); g++)
+    {
+        hid_t dataset = H5Dcreate2(state.part_file,
+                                   dataset_path(state, g).c_str(),
+                                   state.file_types[g],
+                                   space,
+                                   link_properties,
+                                   properties,
+                                   H5P_DEFAULT);
+        if(dataset < 0)
+        {
+            if(verbose)
+            {
+                cerr << "ERROR: Unable to create HDF5 dataset \""
+                     << dataset_path(state, g) << "\" in part file "
+                     << part_path(state.output_url, state.part) << endl;
+            }
+            success = false;
+            break;
+        }
+        state.datasets.push_back(dataset);
+    }
+    if(properties >= 0)
+    {
+        H5Pclose(properties);
+    }
+    if(link_properties >= 0)
+    {
+        H5Pclose(link_properties);
+    }
+    if(space >= 0)
+    {
+        H5Sclose(space);
+    }
+    state.segment_start = state.rows_written;
+
+    return success;
+}
+
+
+bool root2hdf5::rollover::close_part_datasets(rollover_state & state)
+{
+    if(state.datasets.empty())
+    {
+        return true;
+    }
+
+    // Record where the rows went
+    segment new_segment;
+    new_segment.file_name
+        = fs::path(part_path(state.output_url, state.part)).filename()
+          .native();
+    new_segment.start = state.segment_start;
+    new_segment.count = state.rows_written - state.segment_start;
+    if(new_segment.count > 0)
+    {
+        state.segments.push_back(new_segment);
+    }
+
+    // Close the datasets
+    bool success = true;
+    for(auto it = state.datasets.begin(); it != state.datasets.end(); it++)
+    {
+        if(H5Dclose(*it) < 0)
+        {
+            success = false;
+        }
+    }
+    state.datasets.clear();
+    if(!success && verbose)
+    {
+        cerr << "ERROR: Couldn't close HDF5 datasets in part file "
+             << part_path(state.output_url, state.part) << endl;
+    }
+
+    return success;
+}
+
+
+bool root2hdf5::rollover::create_virtual_datasets(rollover_state & state)
+{
+#if H5_VERSION_GE(1, 10, 0)
+    hid_t group = H5Gopen2(state.index_file,
+                           state.group_path.c_str(),
+                           H5P_DEFAULT);
+    hid_t space = H5Screate_simple(1, &state.n_rows, NULL);
+    bool success = group >= 0 && space >= 0;
+    for(size_t g = 0; success && g < state.dataset_names.size(); g++)
+    {
+        // Map each segment's rows onto their place in the tree.  Source
+        // files are named relative to the index file, so the whole set can
+        // be moved together.
+        hid_t properties = H5Pcreate(H5P_DATASET_CREATE);
+        success = properties >= 0;
+        for(auto it = state.segments.begin();
+            success && it != state.segments.end();
+            it++)
+        {
+            hid_t source_space = H5Screate_simple(1, &it->count, NULL);
+            success = source_space >= 0
+                      && H5Sselect_hyperslab(space,
+                                             H5S_SELECT_SET,
+                                             &it->start,
+                                             NULL,
+                                             &it->count,
+                                             NULL) >= 0
+                      && H5Pset_virtual(properties,
+                                        space,
+                                        it->file_name.c_str(),
+                                        dataset_path(state, g).c_str(),
+                                        source_space) >= 0;
+            if(source_space >= 0)
+            {
+                H5Sclose(source_space);
+            }
+        }
+
+        // Create the virtual dataset itself
+        hid_t dataset = -1;
+        if(success && H5Sselect_all(space) >= 0)
+        {
+            dataset = H5Dcreate2(group,
+                                 state.dataset_names[g].c_str(),
+                                 state.file_types[g],
+                                 space,
+                                 H5P_DEFAULT,
+                                 properties,
+                                 H5P_DEFAULT);
+        }
+        success = dataset >= 0
+                  && write_bits_attribute(dataset, state.bit_paths[g]);
+        if(dataset >= 0 && H5Dclose(dataset) < 0)
+        {
+            success = false;
+        }
+        if(properties >= 0)
+        {
+            H5Pclose(properties);
+        }
+        if(!success && verbose)
+        {
+            cerr << "ERROR: Unable to create virtual dataset \""
+                 << dataset_path(state, g) << "\"" << endl;
+        }
+    }
+    if(space >= 0)
+    {
+        H5Sclose(space);
+    }
+    if(group >= 0 && H5Gclose(group) < 0)
+    {
+        success = false;
+    }
+
+    return success;
+#else
+    if(verbose)
+    {
+        cerr << "ERROR: Virtual datasets require HDF5 1.10 or newer" << endl;
+    }
+
+    return false;
+#endif
+}
+
+
+void root2hdf5::rollover::release_tree_types(rollover_state & state)
+{
+    for(size_t g = 0; g < state.file_types.size(); g++)
+    {
+        H5Tclose(state.file_types[g]);
+    }
+    state.dataset_names.clear();
+    state.file_types.clear();
+    state.layouts.clear();
+    state.bit_paths.clear();
+}
+
+
+boost::tuple<tree_sink, rollover_closer>
+root2hdf5::rollover::build_rollover_sink(const string & output_url,
+                                         hid_t index_file,
+                                         hsize_t max_bytes,
+                                         const tree_sink & downstream)
+{
+    std::shared_ptr<rollover_state> state(new rollover_state());
+    state->output_url = output_url;
+    state->index_file = index_file;
+    state->max_bytes = max_bytes;
+    state->part = 0;
+    state->part_file = -1;
+    state->part_has_rows = false;
+
+    tree_sink sink;
+    sink.write_dataset = false;
+
+    // Work out the tree's datasets, which are the same as they would be in
+    // a single output file
+    sink.begin = [state, downstream]
+                 (TTree *tree, hid_t row_type, hsize_t n_rows) -> bool {
+        state->group_path = group_path_for_tree(tree);
+        state->n_rows = n_rows;
+        state->n_chunk_rows = rows_per_block(H5Tget_size(row_type), n_rows);
+        state->file_row_bytes = 0;
+        state->rows_written = 0;
+        state->segment_start = 0;
+        state->segments.clear();
+        vector<column_group> groups = column_groups_for_type(row_type);
+        vector<string> boolean_paths;
+        if(pack_booleans_requested())
+        {
+            boolean_paths = boolean_leaf_paths(tree);
+        }
+        for(auto it = groups.begin(); it != groups.end(); it++)
+        {
+            packed_layout layout;
+            vector<string> bit_paths;
+            hid_t file_type = file_type_for_column_group(row_type,
+                                                         *it,
+                                                         boolean_paths,
+                                                         layout,
+                                                         bit_paths);
+            if(file_type < 0)
+            {
+                if(verbose)
+                {
+                    cerr << "ERROR: Unable to create HDF5 types for tree \""
+                         << tree->GetName() << "\"" << endl;
+                }
+
+                return false;
+            }
+            state->dataset_names.push_back(
+                column_group_dataset_name(tree, *it)
+            );
+            state->file_types.push_back(file_type);
+            state->layouts.push_back(layout);
+            state->bit_paths.push_back(bit_paths);
+            state->file_row_bytes += H5Tget_size(file_type);
+        }
+
+        return !downstream.begin || downstream.begin(tree, row_type, n_rows);
+    };
+
+    // Write each block to the current part, moving on to the next part
+    // first if this block would take the current one over the limit.  A
+    // part always takes at least one block, even if that alone is too big.
+    sink.block = [state, downstream]
+                 (const char *rows, hsize_t n_rows) -> bool {
+        hsize_t part_size = 0;
+        if(state->part_file >= 0
+           && state->part_has_rows
+           && H5Fget_filesize(state->part_file, &part_size) >= 0
+           && part_size + n_rows * state->file_row_bytes > state->max_bytes
+           && !open_next_part(*state))
+        {
+            return false;
+        }
+        if(state->part_file < 0 && !open_next_part(*state))
+        {
+            return false;
+        }
+        if(state->datasets.empty() && !create_part_datasets(*state))
+        {
+            return false;
+        }
+
+        // Append the rows to each dataset
+        hsize_t offset = state->rows_written - state->segment_start;
+        hsize_t new_size = offset + n_rows;
+        hid_t memory_space = H5Screate_simple(1, &n_rows, NULL);
+        bool success = memory_space >= 0;
+        for(size_t g = 0; success && g < state->datasets.size(); g++)
+        {
+            // Pack the rows into the file's layout first
+            const char *packed = rows;
+            if(!state->layouts[g].identity)
+            {
+                size_t n_bytes = n_rows * state->layouts[g].packed_size;
+                if(state->packed_buffer.size() < n_bytes)
+                {
+                    state->packed_buffer.resize(n_bytes);
+                }
+                gather_rows(state->layouts[g],
+                            rows,
+                            n_rows,
+                            &state->packed_buffer[0]);
+                packed = &state->packed_buffer[0];
+            }
+            hid_t file_space = -1;
+            success = H5Dset_extent(state->datasets[g], &new_size) >= 0
+                      && (file_space = H5Dget_space(state->datasets[g])) >= 0
+                      && H5Sselect_hyperslab(file_space,
+                                             H5S_SELECT_SET,
+                                             &offset,
+                                             NULL,
+                                             &n_rows,
+                                             NULL) >= 0
+                      && H5Dwrite(state->datasets[g],
+                                  state->file_types[g],
+                                  memory_space,
+                                  file_space,
+                                  H5P_DEFAULT,
+                                  packed) >= 0;
+            if(file_space >= 0)
+            {
+                H5Sclose(file_space);
+            }
+        }
+        if(memory_space >= 0)
+        {
+            H5Sclose(memory_space);
+        }
+        if(!success)
+        {
+            if(verbose)
+            {
+                cerr << "ERROR: Unable to write rows " << state->rows_written
+                     << " to " << state->rows_written + n_rows - 1
+                     << " to part file "
+                     << part_path(state->output_url, state->part) << endl;
+            }
+
+            return false;
+        }
+        state->rows_written += n_rows;
+        state->part_has_rows = true;
+
+        return !downstream.block || downstream.block(rows, n_rows);
+    };
+
+    // Stitch the tree back together in the index file
+    sink.end = [state, downstream](TTree *tree) -> bool {
+        bool success = close_part_datasets(*state)
+                       && create_virtual_datasets(*state);
+        release_tree_types(*state);
+
+        return success && (!downstream.end || downstream.end(tree));
+    };
+
+    // Close whatever is left open
+    rollover_closer closer = [state]() -> bool {
+        bool success = close_part_datasets(*state);
+        release_tree_types(*state);
+        if(state->part_file >= 0)
+        {
+            if(H5Fclose(state->part_file) < 0)
+            {
+                if(verbose)
+                {
+                    cerr << "ERROR: Closing part file "
+                         << part_path(state->output_url, state->part)
+                         << " failed" << endl;
+                }
+                success = false;
+            }
+            state->part_file = -1;
+        }
+
+        return success;
+    };
+
+    return boost::make_tuple(sink, closer);
+}
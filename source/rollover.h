@@ -0,0 +1,54 @@
+#pragma once
+
+// Standard includes
+#include <functional>
+#include <string>
+
+// HACK: Use Boost.Tuple instead of std::tuple because at the moment, the LLVM-
+// provided libc++ doesn't support the std::tuple, and Boost.Tuple is
+// effectively the same thing.
+// Boost includes
+#include <boost/tuple/tuple.hpp>
+
+// HDF5 includes
+#include <hdf5.h>
+
+// root2hdf5 includes
+#include "tree.h"
+
+
+namespace root2hdf5
+{
+    namespace rollover
+    {
+        // Callback type for closing whichever part file is still open once
+        // conversion is done.  Returns false on failure.
+        typedef std::function<bool()> rollover_closer;
+
+        // Returns the --max-output-size in bytes, or 0 if the output should
+        // be a single file
+        hsize_t max_output_size();
+
+        // Returns the path of the numbered part file next to the output,
+        // e.g. out.0002.h5 for out.h5 and part 2
+        std::string part_path(const std::string & output_url, unsigned part);
+
+        // Builds a sink which writes the rows of every tree to a series of
+        // part files next to the output, starting a new part (at a block
+        // boundary) whenever the current one would grow beyond max_bytes.
+        // Part files mirror the group layout of the output and may hold
+        // pieces of several trees.  Once a tree is done, a virtual dataset
+        // with its usual name is created in the index file, stitching its
+        // pieces back together into one continuous dataset.  The index file
+        // should be the output file itself, so that side datasets and
+        // histograms stay next to the virtual datasets.  The downstream
+        // sink, if any, still receives every block.  The returned sink
+        // doesn't write datasets of its own, and the closer must be called
+        // after conversion, whether or not it succeeded.
+        boost::tuple<root2hdf5::tree::tree_sink, rollover_closer>
+        build_rollover_sink(const std::string & output_url,
+                            hid_t index_file,
+                            hsize_t max_bytes,
+                            const root2hdf5::tree::tree_sink & downstream);
+    }
+}
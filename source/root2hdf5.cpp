@@ -2,6 +2,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <string>
+#include <vector>
 
 // Boost includes
 #include <boost/filesystem.hpp>
@@ -17,6 +18,9 @@
 // root2hdf5 includes
 #include "options.h"
 #include "convert.h"
+#include "inspect.h"
+#include "batch.h"
+#include "plugin.h"
 
 // Standard namespaces
 using namespace std;
@@ -27,6 +31,9 @@ namespace fs = boost::filesystem;
 // root2hdf5 namespaces
 using namespace root2hdf5::options;
 using namespace root2hdf5::convert;
+using namespace root2hdf5::inspect;
+using namespace root2hdf5::batch;
+using namespace root2hdf5::plugin;
 
 
 int main(int argc, char *argv[])
@@ -41,76 +48,58 @@ int main(int argc, char *argv[])
     // Parse command line options and create some convenient accessors
     parse_command_line_options(argc, argv);
 
-    // Grab file paths (parse_command_line_options will have validated them)
-    string input_url = options["input-url"].as<string>();
-    string output_url = options["output-url"].as<string>();
+    // Register any plugin converters before anything looks at a leaf, and
+    // before batch workers are forked so that they all inherit them
+    if(!load_converter_plugins())
+    {
+        exit(EXIT_FAILURE);
+    }
 
-    // Check if the output path exists.  If it does, and it is a directory, then
-    // the user has likely made a mistake, so bail.  If it does and it is a
-    // file, then check if the user has specified the overwrite option, and in
-    // that case, proceed.
-    fs::path output_path(output_url);
-    bool exists = fs::exists(output_path);
-    bool is_dir = exists && fs::is_directory(output_path);
-    if(exists)
+    // In batch mode, the manifest supplies all of the paths
+    if(options.count("batch"))
     {
-        if(is_dir)
-        {
-            cerr << "Output path is a directory, manually delete if you would "
-                 << "like to overwrite it" << endl;
-            exit(EXIT_FAILURE);
-        }
-        else if(options.count("overwrite") == 0)
+        vector<job> jobs;
+        if(!read_manifest(options["batch"].as<string>(), jobs))
         {
-            cout << "Output path exists.  Specify the \"--overwrite\" option "
-                 << "if you would like to overwrite it" << endl;
             exit(EXIT_FAILURE);
         }
+
+        return run_batch(jobs, options["workers"].as<unsigned>())
+               ? 0
+               : EXIT_FAILURE;
     }
-    
-    // Print path information if requested
-    if(verbose)
-    {
-        cout << "Converting " << input_url << " -> " << output_url << endl;
-    }
 
-    // Open the input file
-    TFile *input_file = TFile::Open(input_url.c_str(), "READ");
-    if(input_file == NULL)
+    // Grab the input path (parse_command_line_options will have validated it)
+    string input_url = options["input-url"].as<string>();
+
+    // If the user only wants to inspect the input, print the conversion plan
+    // and bail before touching any output
+    if(options.count("inspect"))
     {
-        if(verbose)
+        TFile *input_file = TFile::Open(input_url.c_str(), "READ");
+        if(input_file == NULL)
         {
             cerr << "Unable to open input file: " << input_url << endl;
+            exit(EXIT_FAILURE);
         }
-        exit(EXIT_FAILURE);
-    }
 
-    // Open the output file
-    hid_t output_file = H5Fcreate(output_url.c_str(),
-                                  H5F_ACC_TRUNC,
-                                  H5P_DEFAULT,
-                                  H5P_DEFAULT);
+        bool success = inspect(input_file);
 
-    // Walk the input file and convert everything
-    if(!convert(input_file, output_file))
-    {
-        exit(EXIT_FAILURE);
+        input_file->Close();
+        delete input_file;
+        input_file = NULL;
+
+        return success ? 0 : EXIT_FAILURE;
     }
 
-    // Cleanup output resources
-    if(H5Fclose(output_file) < 0)
+    // Grab the output path
+    string output_url = options["output-url"].as<string>();
+
+    // Do the conversion
+    if(!convert_file(input_url, output_url))
     {
-        if(verbose)
-        {
-            cerr << "ERROR: Closing output file failed" << endl;
-        }
         exit(EXIT_FAILURE);
     }
 
-    // Cleanup input resources
-    input_file->Close();
-    delete input_file;
-    input_file = NULL;
-
     return 0;
 }
@@ -1,9 +1,14 @@
 #include "tree.h"
 
+// C Standard includes
+#include <cstring>
+
 // Standard includes
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <utility>
+#include <vector>
 
 // HACK: Use Boost.Tuple instead of std::tuple because at the moment, the LLVM-
 // provided libc++ doesn't support the std::tuple, and Boost.Tuple is
@@ -14,6 +19,8 @@
 // ROOT includes
 #include <TROOT.h>
 #include <TBranch.h>
+#include <TEntryList.h>
+#include <TFile.h>
 #include <TLeaf.h>
 
 // root2hdf5 includes
@@ -21,6 +28,18 @@
 #include "tree/structure.h"
 #include "tree/map_hdf5.h"
 #include "tree/map_root.h"
+#include "tree/index.h"
+#include "tree/block.h"
+#include "tree/statistics.h"
+#include "tree/profile.h"
+#include "tree/split.h"
+#include "tree/bulk.h"
+#include "tree/byte_order.h"
+#include "tree/threads.h"
+#include "tree/pack.h"
+#include "tree/booleans.h"
+#include "tree/leaf_converters/string_converter.h"
+#include "progress.h"
 
 
 // Standard namespaces
@@ -32,11 +51,148 @@ using namespace root2hdf5::options;
 using namespace root2hdf5::tree::structure;
 using namespace root2hdf5::tree::map_hdf5;
 using namespace root2hdf5::tree::map_root;
+using namespace root2hdf5::tree::index;
+using namespace root2hdf5::tree::block;
+using namespace root2hdf5::tree::statistics;
+using namespace root2hdf5::tree::profile;
+using namespace root2hdf5::tree::split;
+using namespace root2hdf5::tree::bulk;
+using namespace root2hdf5::tree::threads;
+using namespace root2hdf5::tree::pack;
+using namespace root2hdf5::tree::booleans;
+using namespace root2hdf5::tree::byte_order;
+using namespace root2hdf5::tree::leaf_converters::string_converter;
+using namespace root2hdf5::progress;
+
+
+// Private namespace members
+namespace root2hdf5
+{
+    namespace tree
+    {
+        // The --entry-list-file currently open, and its path
+        TFile *_entry_list_file = NULL;
+        string _entry_list_file_path;
+
+        // Returns the --entry-list-file, opening it if it isn't open yet.
+        // The file stays open while the same path is given, since it may
+        // hold lists for trees in several input files, but is replaced when
+        // a later conversion gives another path.  Returns NULL if it can't
+        // be opened.
+        TFile * entry_list_file(const string & path);
+
+        // Finds the entry list given with --entry-list which applies to the
+        // tree, or returns NULL if every entry should be converted
+        TEntryList * entry_list_for_tree(TTree *tree);
+    }
+}
+
+
+TFile * root2hdf5::tree::entry_list_file(const string & path)
+{
+    if(_entry_list_file != NULL && _entry_list_file_path == path)
+    {
+        return _entry_list_file;
+    }
+
+    // Switch files, dropping any lists from the previous one
+    if(_entry_list_file != NULL)
+    {
+        _entry_list_file->Close();
+        delete _entry_list_file;
+        _entry_list_file = NULL;
+    }
+    _entry_list_file = TFile::Open(path.c_str());
+    _entry_list_file_path = path;
+    if(_entry_list_file == NULL && verbose)
+    {
+        cerr << "WARNING: Unable to open entry list file \"" << path << "\""
+             << endl;
+    }
+
+    return _entry_list_file;
+}
+
+
+TEntryList * root2hdf5::tree::entry_list_for_tree(TTree *tree)
+{
+    if(root2hdf5::options::options.count("entry-list") == 0)
+    {
+        return NULL;
+    }
+    string name = root2hdf5::options::options["entry-list"].as<string>();
+
+    // Look in the side file if one was given, otherwise next to the tree
+    TObject *object = NULL;
+    if(root2hdf5::options::options.count("entry-list-file"))
+    {
+        TFile *side_file = entry_list_file(
+            root2hdf5::options::options["entry-list-file"].as<string>()
+        );
+        if(side_file != NULL)
+        {
+            object = side_file->Get(name.c_str());
+        }
+    }
+    else if(tree->GetDirectory() != NULL)
+    {
+        object = tree->GetDirectory()->Get(name.c_str());
+    }
+    TEntryList *entry_list = dynamic_cast<TEntryList *>(object);
+    if(entry_list == NULL)
+    {
+        if(verbose)
+        {
+            cerr << "WARNING: Entry list \"" << name << "\" not found for tree "
+                 << "\"" << tree->GetName() << "\" - converting all entries"
+                 << endl;
+        }
+
+        return NULL;
+    }
+
+    // Lists covering several trees keep a sub-list for each
+    if(entry_list->GetLists() != NULL && tree->GetCurrentFile() != NULL)
+    {
+        entry_list = entry_list->GetEntryList(
+            tree->GetName(),
+            tree->GetCurrentFile()->GetName()
+        );
+    }
+    else if(entry_list->GetTreeName() != NULL
+            && entry_list->GetTreeName()[0] != '\0'
+            && string(entry_list->GetTreeName()) != tree->GetName())
+    {
+        entry_list = NULL;
+    }
+    if(entry_list == NULL && verbose)
+    {
+        cerr << "WARNING: Entry list \"" << name << "\" doesn't apply to tree "
+             << "\"" << tree->GetName() << "\" - converting all entries"
+             << endl;
+    }
+
+    return entry_list;
+}
 
 
 bool root2hdf5::tree::convert(TTree *tree,
-                              hid_t parent_destination)
+                              hid_t parent_destination,
+                              const tree_sink & sink)
 {
+    // Decide how string leaves are stored, which decides their converters,
+    // before anything looks at the converters
+    if(!choose_string_encodings(tree))
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Unable to choose string encodings for tree \""
+                 << tree->GetName() << "\"" << endl;
+        }
+
+        return false;
+    }
+
     // Create a string which represents a struct that we can use to construct
     // the HDF5 composite data type
     string hdf5_struct_name = struct_type_name_for_tree(tree);
@@ -59,15 +215,32 @@ bool root2hdf5::tree::convert(TTree *tree,
         return false;
     }
     
-    // Tell CINT to allocate an instance of the structure
-    void *hdf5_struct = allocate_instance_by_name(hdf5_struct_name);
+    // Allocate an instance of the structure
+    void *hdf5_struct = allocate_conversion_struct(hdf5_struct_name);
+    if(hdf5_struct == NULL)
+    {
+        hdf5_deallocator();
+        return false;
+    }
+
+    // Set up branch profiling, if requested, which times every converter
+    std::shared_ptr<tree_profile> profile;
+    root_converter_wrapper wrapper;
+    if(profiling_requested())
+    {
+        profile = profile_tree(tree);
+        wrapper = profiling_wrapper(profile);
+    }
 
     // Map the ROOT tree into the hdf5_struct instance
     bool root_map_success = false;
     root_converter converter;
+    root_finalizer finalizer;
     root_resource_deallocator root_deallocator;
-    boost::tie(root_map_success, converter, root_deallocator)
-        = map_root_tree_into_struct_and_build_converter(tree, hdf5_struct);
+    boost::tie(root_map_success, converter, finalizer, root_deallocator)
+        = map_root_tree_into_struct_and_build_converter(tree,
+                                                        hdf5_struct,
+                                                        wrapper);
     if(!root_map_success)
     {
         // ROOT mapping has failed, and it should have already printed a message
@@ -75,13 +248,117 @@ bool root2hdf5::tree::convert(TTree *tree,
         return false;
     }
 
-    // Create the dataspace with the same dimensions as the tree and a
-    // single-element dataset to represent the in-memory space
-    const hsize_t n_entries = tree->GetEntries();
-    const hsize_t n_memory_entries = 1; // We only have a single instance of the
-                                        // struct in-memory
-    hid_t hdf5_file_space = H5Screate_simple(1, &n_entries, NULL);
-    hid_t hdf5_memory_space = H5Screate_simple(1, &n_memory_entries, NULL);
+    // With a --read-threads budget, read branches and unzip upcoming
+    // clusters in parallel.  Failing to get the threads just means reading
+    // serially.  This sets up the tree cache, so it comes before anything
+    // else configures it.
+    enable_read_threads();
+    prefetch_clusters(tree);
+
+    // Find out which entries to convert.  With an entry list, only the listed
+    // entries are read, in order, and each becomes the next row of the
+    // dataset.  Telling the tree about the list lets its cache skip baskets
+    // without any selected entries, and the cache is limited to the range
+    // the list spans.
+    TEntryList *entry_list = entry_list_for_tree(tree);
+    hsize_t n_rows = tree->GetEntries();
+    if(entry_list != NULL)
+    {
+        n_rows = entry_list->GetN();
+        tree->SetEntryList(entry_list);
+        if(n_rows > 0)
+        {
+            tree->SetCacheSize();
+            tree->SetCacheEntryRange(entry_list->GetEntry(0),
+                                     entry_list->GetEntry(n_rows - 1) + 1);
+            tree->AddBranchToCache("*", kTRUE);
+            tree->StopCacheLearningPhase();
+        }
+        if(verbose)
+        {
+            cout << "Converting " << n_rows << " of " << tree->GetEntries()
+                 << " entries of tree \"" << tree->GetName() << "\"" << endl;
+        }
+    }
+
+    // Set up the index, if one was requested
+    vector<string> columns = index_columns();
+    bool index_success = true;
+    index_collector collector;
+    root_finalizer index_finalizer;
+    if(!columns.empty())
+    {
+        // A TTreeIndex refers to entries, not rows, so it can only be reused
+        // when every entry is converted
+        boost::tie(index_success, collector, index_finalizer)
+            = build_index(tree,
+                          columns,
+                          default_index_memory_limit,
+                          entry_list == NULL);
+        if(!index_success)
+        {
+            // Index setup has failed, and it should have already printed a
+            // message if necessary, so just bail
+            return false;
+        }
+    }
+
+    // Figure out how many rows to buffer before each write.  Each block of
+    // rows is written as exactly one chunk of the dataset.
+    const size_t row_size = H5Tget_size(hdf5_type);
+    const hsize_t n_block_rows = rows_per_block(row_size, n_rows);
+    vector<char> block_buffer(n_block_rows * row_size);
+    vector<variable_length_member> variable_length
+        = variable_length_members(hdf5_type);
+    variable_length_arena arena;
+
+    // Read flat scalar branches a basket at a time where possible, filling
+    // them into each block just before it is written
+    bool bulk_success = true;
+    block_filler bulk_filler;
+    root_resource_deallocator bulk_deallocator;
+    bool read_entries = true;
+    hid_t big_endian_type = -1;
+    vector<Long64_t> block_entries(n_block_rows);
+    if(bulk_read_requested())
+    {
+        boost::tie(bulk_success,
+                   bulk_filler,
+                   bulk_deallocator,
+                   read_entries,
+                   big_endian_type)
+            = build_bulk_reader(tree,
+                                hdf5_type,
+                                columns,
+                                big_endian_requested());
+        if(!bulk_success)
+        {
+            return false;
+        }
+    }
+
+    // The rows are written as they are laid out in memory, which leaves any
+    // big-endian bulk-read columns big-endian on disk as well
+    hid_t hdf5_row_type = big_endian_type >= 0 ? big_endian_type : hdf5_type;
+
+    // Set up the chunk statistics, if they were requested
+    bool statistics_success = true;
+    block_observer observer;
+    root_finalizer statistics_finalizer;
+    if(statistics_requested())
+    {
+        boost::tie(statistics_success, observer, statistics_finalizer)
+            = build_statistics(tree, hdf5_row_type, n_block_rows);
+        if(!statistics_success)
+        {
+            return false;
+        }
+    }
+
+    // Create the dataspace with one row per converted entry and a
+    // block-sized dataspace to represent the in-memory buffer
+    hid_t hdf5_file_space = H5Screate_simple(1, &n_rows, NULL);
+    hid_t hdf5_memory_space = H5Screate_simple(1, &n_block_rows, NULL);
     if(hdf5_file_space < 0 || hdf5_memory_space < 0)
     {
         // Data space creation failed
@@ -94,38 +371,128 @@ bool root2hdf5::tree::convert(TTree *tree,
         return false;
     }
 
-    // Create the dataset
-    hid_t hdf5_dataset = H5Dcreate2(parent_destination,
-                                    tree->GetName(),
-                                    hdf5_type,
-                                    hdf5_file_space,
-                                    H5P_DEFAULT,
-                                    H5P_DEFAULT,
-                                    H5P_DEFAULT);
-    if(hdf5_dataset < 0)
+    // Create the datasets, chunked by block.  Wide trees are split into
+    // column groups, each of which gets a dataset of its own, all written
+    // from the same rows.
+    hid_t hdf5_properties = H5Pcreate(H5P_DATASET_CREATE);
+    if(hdf5_properties < 0
+       || H5Pset_chunk(hdf5_properties, 1, &n_block_rows) < 0)
     {
-        // Dataset creation failed
         if(verbose)
         {
-            cerr << "ERROR: Unable to create HDF5 dataset for tree \""
+            cerr << "ERROR: Unable to set up chunking for tree \""
                  << tree->GetName() << "\"" << endl;
         }
 
         return false;
     }
+    vector<column_group> groups;
+    if(sink.write_dataset)
+    {
+        groups = column_groups_for_type(hdf5_row_type);
+    }
+    vector<hid_t> hdf5_datasets;
+    vector<hid_t> hdf5_packed_types;
+    vector<packed_layout> layouts(groups.size());
+    size_t packed_row_size = 0;
+    vector<string> boolean_paths;
+    if(pack_booleans_requested())
+    {
+        boolean_paths = boolean_leaf_paths(tree);
+    }
+    for(size_t g = 0; g < groups.size(); g++)
+    {
+        vector<string> bit_paths;
+        hid_t file_type = file_type_for_column_group(hdf5_row_type,
+                                                     groups[g],
+                                                     boolean_paths,
+                                                     layouts[g],
+                                                     bit_paths);
+        hid_t dataset = -1;
+        if(file_type >= 0)
+        {
+            dataset = H5Dcreate2(
+                parent_destination,
+                column_group_dataset_name(tree, groups[g]).c_str(),
+                file_type,
+                hdf5_file_space,
+                H5P_DEFAULT,
+                hdf5_properties,
+                H5P_DEFAULT
+            );
+        }
+        if(dataset >= 0 && !write_bits_attribute(dataset, bit_paths))
+        {
+            H5Dclose(dataset);
+            dataset = -1;
+        }
+        if(dataset < 0)
+        {
+            // Dataset creation failed
+            if(verbose)
+            {
+                cerr << "ERROR: Unable to create HDF5 dataset \""
+                     << column_group_dataset_name(tree, groups[g])
+                     << "\" for tree \"" << tree->GetName() << "\"" << endl;
+            }
+            if(file_type >= 0)
+            {
+                H5Tclose(file_type);
+            }
+            H5Pclose(hdf5_properties);
+
+            return false;
+        }
+        hdf5_datasets.push_back(dataset);
+        hdf5_packed_types.push_back(file_type);
+        packed_row_size = max(packed_row_size, layouts[g].packed_size);
+    }
+    H5Pclose(hdf5_properties);
+
+    // Blocks are packed into the file's layout before they are written, so
+    // that HDF5 doesn't have to convert the compound type itself
+    vector<char> packed_buffer;
+    for(size_t g = 0; g < layouts.size(); g++)
+    {
+        if(!layouts[g].identity)
+        {
+            packed_buffer.resize(n_block_rows * packed_row_size);
+            break;
+        }
+    }
+
+    // Tell the sink what is coming
+    if(sink.begin && !sink.begin(tree, hdf5_row_type, n_rows))
+    {
+        return false;
+    }
 
-    // Loop through the tree, getting every entry, calling the converter, and
-    // then writing it to the HDF5 dataset
-    const hsize_t slab_stride = 1;
-    const hsize_t slab_count = 1;
-    for(hsize_t i = 0; i < n_entries; i++)
+    // Loop through the tree, getting every entry, calling the converter,
+    // copying the result into the block buffer, and writing out each block
+    // once it is full.  Progress reporting, if requested, runs on its own
+    // thread for as long as the loop does.
+    progress_scope progress(tree->GetName(), n_rows);
+    hsize_t block_start = 0;
+    for(hsize_t i = 0; i < n_rows; i++)
     {
         // Load the entry
-        if(tree->GetEntry((Long64_t)i) < 1)
+        Long64_t entry = entry_list != NULL
+                         ? entry_list->GetEntry(i)
+                         : (Long64_t)i;
+        Int_t n_bytes_read = 0;
+        if(read_entries)
+        {
+            n_bytes_read = profile
+                           ? read_entry(*profile, tree, entry)
+                           : tree->GetEntry(entry);
+        }
+        add_entries(1);
+        add_bytes_read(n_bytes_read > 0 ? n_bytes_read : 0);
+        if(read_entries && n_bytes_read < 1)
         {
             if(verbose)
             {
-                cerr << "ERROR: Unable to read entry " << i << " from tree"
+                cerr << "ERROR: Unable to read entry " << entry << " from tree"
                      << endl;
             }
 
@@ -140,51 +507,141 @@ bool root2hdf5::tree::convert(TTree *tree,
             return false;
         }
 
-        // Do the HDF5 fill.  First, select the single event hyperslab to fill,
-        // and then write!
-        if(H5Sselect_hyperslab(hdf5_file_space,
-                               H5S_SELECT_SET,
-                               &i,
-                               &slab_stride,
-                               &slab_count,
-                               NULL) < 0)
+        // Record the entry's index keys
+        if(collector && !collector((Long64_t)i))
         {
-            if(verbose)
-            {
-                cerr << "ERROR: Unable to select hyperslab for entry " << i
-                     << endl;
-            }
+            return false;
+        }
+
+        // Stage the row in the block, taking a copy of any variable-length
+        // data, since that belongs to the converters
+        char *row = &block_buffer[(i - block_start) * row_size];
+        memcpy(row, hdf5_struct, row_size);
+        if(!variable_length.empty())
+        {
+            stage_variable_length_data(variable_length, row, arena);
+        }
+        block_entries[i - block_start] = entry;
 
+        // Write the block out if it is full or this is the last entry, once
+        // the bulk-read columns have been filled in
+        hsize_t n_block_used = i - block_start + 1;
+        if(n_block_used < n_block_rows && i + 1 < n_rows)
+        {
+            continue;
+        }
+        if(bulk_filler
+           && !bulk_filler(&block_entries[0], n_block_used, &block_buffer[0]))
+        {
             return false;
         }
-        if(H5Dwrite(hdf5_dataset,
-                    hdf5_type,
-                    hdf5_memory_space,
-                    hdf5_file_space,
-                    H5P_DEFAULT,
-                    hdf5_struct) < 0)
+        if(!hdf5_datasets.empty())
         {
-            if(verbose)
+            const hsize_t memory_start = 0;
+            if(H5Sselect_hyperslab(hdf5_file_space,
+                                   H5S_SELECT_SET,
+                                   &block_start,
+                                   NULL,
+                                   &n_block_used,
+                                   NULL) < 0
+               || H5Sselect_hyperslab(hdf5_memory_space,
+                                      H5S_SELECT_SET,
+                                      &memory_start,
+                                      NULL,
+                                      &n_block_used,
+                                      NULL) < 0)
             {
-                cerr << "ERROR: Unable to write hyperslab fro entry " << i
-                     << endl;
+                if(verbose)
+                {
+                    cerr << "ERROR: Unable to select hyperslab for rows "
+                         << block_start << " to " << i << endl;
+                }
+
+                return false;
             }
+            hsize_t n_bytes_written = 0;
+            for(size_t g = 0; g < hdf5_datasets.size(); g++)
+            {
+                const char *packed = &block_buffer[0];
+                if(!layouts[g].identity)
+                {
+                    gather_rows(layouts[g],
+                                &block_buffer[0],
+                                n_block_used,
+                                &packed_buffer[0]);
+                    packed = &packed_buffer[0];
+                }
+                n_bytes_written += n_block_used * layouts[g].packed_size;
+                if(H5Dwrite(hdf5_datasets[g],
+                            hdf5_packed_types[g],
+                            hdf5_memory_space,
+                            hdf5_file_space,
+                            H5P_DEFAULT,
+                            packed) < 0)
+                {
+                    if(verbose)
+                    {
+                        cerr << "ERROR: Unable to write hyperslab for rows "
+                             << block_start << " to " << i << endl;
+                    }
+
+                    return false;
+                }
+            }
+            add_bytes_written(n_bytes_written);
+        }
+
+        // Compute the statistics of the block
+        if(observer && !observer(&block_buffer[0], n_block_used))
+        {
+            return false;
+        }
 
+        // Hand the block to the sink
+        if(sink.block && !sink.block(&block_buffer[0], n_block_used))
+        {
             return false;
         }
 
+        // Start a new block
+        arena_reset(arena);
+        block_start = i + 1;
     }
 
-    // Close the data set
-    if(H5Dclose(hdf5_dataset) < 0)
+    // Let the converters, the index and the statistics write out anything
+    // they've accumulated
+    if(!finalizer(parent_destination)
+       || (index_finalizer && !index_finalizer(parent_destination))
+       || (statistics_finalizer
+           && !statistics_finalizer(parent_destination)))
     {
-        if(verbose)
+        // The finalizer should have already printed an error if necessary, so
+        // just bail
+        return false;
+    }
+    if(sink.end && !sink.end(tree))
+    {
+        return false;
+    }
+    if(profile)
+    {
+        print_profile(tree, *profile, n_rows);
+    }
+
+    // Close the data sets
+    for(size_t g = 0; g < hdf5_datasets.size(); g++)
+    {
+        H5Tclose(hdf5_packed_types[g]);
+        if(H5Dclose(hdf5_datasets[g]) < 0)
         {
-            cerr << "ERROR: Couldn't close HDF5 dataset for tree \""
-                 << tree->GetName() << "\"" << endl;
-        }
+            if(verbose)
+            {
+                cerr << "ERROR: Couldn't close HDF5 dataset for tree \""
+                     << tree->GetName() << "\"" << endl;
+            }
 
-        return false;
+            return false;
+        }
     }
 
     // Close out the HDF5 memory data space
@@ -211,6 +668,16 @@ bool root2hdf5::tree::convert(TTree *tree,
         return false;
     }
 
+    // Re-enable the bulk-read branches
+    if(bulk_deallocator && !bulk_deallocator())
+    {
+        return false;
+    }
+    if(big_endian_type >= 0)
+    {
+        H5Tclose(big_endian_type);
+    }
+
     // Call the root mapping deallocator
     if(!root_deallocator())
     {
@@ -219,8 +686,15 @@ bool root2hdf5::tree::convert(TTree *tree,
         return false;
     }
 
-    // Tell CINT to deallocate the instance of the structure
-    deallocate_instance_by_name_and_location(hdf5_struct_name, hdf5_struct);
+    // Detach the entry list, which belongs to a file that a later conversion
+    // may close
+    if(entry_list != NULL)
+    {
+        tree->SetEntryList(NULL);
+    }
+
+    // Deallocate the instance of the structure
+    deallocate_conversion_struct(hdf5_struct);
     hdf5_struct = NULL;
 
     // Call the HDF5 type deallocator
@@ -232,5 +706,55 @@ bool root2hdf5::tree::convert(TTree *tree,
     }
 
     // All done
+    progress.succeeded();
     return true;
 }
+
+
+bool root2hdf5::tree::prepare(TTree *tree)
+{
+    // Decide how string leaves are stored, just like conversion does
+    if(!choose_string_encodings(tree))
+    {
+        return false;
+    }
+
+    // Generate and declare the struct
+    string hdf5_struct_name = struct_type_name_for_tree(tree);
+    if(!create_struct_code_for_tree(tree))
+    {
+        return false;
+    }
+
+    // Generate the HDF5 type, which computes the struct layout
+    hid_t hdf5_type = -1;
+    hdf5_type_deallocator hdf5_deallocator;
+    boost::tie(hdf5_type, hdf5_deallocator)
+        = hdf5_type_for_tree(tree);
+    if(hdf5_type == -1)
+    {
+        return false;
+    }
+    if(!hdf5_deallocator())
+    {
+        return false;
+    }
+
+    // Map the tree into a throwaway instance so that converters do any of
+    // their expensive setup (e.g. building dictionaries)
+    void *hdf5_struct = allocate_conversion_struct(hdf5_struct_name);
+    if(hdf5_struct == NULL)
+    {
+        return false;
+    }
+    bool root_map_success = false;
+    root_converter converter;
+    root_finalizer finalizer;
+    root_resource_deallocator root_deallocator;
+    boost::tie(root_map_success, converter, finalizer, root_deallocator)
+        = map_root_tree_into_struct_and_build_converter(tree, hdf5_struct);
+    bool success = root_map_success && root_deallocator();
+    deallocate_conversion_struct(hdf5_struct);
+
+    return success;
+}
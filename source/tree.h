@@ -1,5 +1,8 @@
 #pragma once
 
+// Standard includes
+#include <functional>
+
 // ROOT includes
 #include <TTree.h>
 
@@ -11,12 +14,48 @@ namespace root2hdf5
 {
     namespace tree
     {
+        // Callbacks for receiving the rows of a tree as they are converted,
+        // any of which may be empty.  This lets the converted data be
+        // consumed directly, with or without also writing the tree's dataset.
+        struct tree_sink
+        {
+            // Called before the first block with the tree, the HDF5 type of
+            // its rows and the number of rows which will follow
+            std::function<bool(TTree *, hid_t, hsize_t)> begin;
+
+            // Called with each block of rows, laid out exactly as in the row
+            // type.  Variable-length data in the rows is only valid for the
+            // duration of the call.
+            std::function<bool(const char *, hsize_t)> block;
+
+            // Called after the last block
+            std::function<bool(TTree *)> end;
+
+            // Whether the tree's dataset is written as well.  The side
+            // datasets (index, statistics and string dictionaries) are
+            // always written to the destination.
+            bool write_dataset;
+
+            tree_sink() : write_dataset(true) {}
+        };
+
         // This method converts a TTree object into an HDF5 dataset with a
         // compound datatype modeled after the TTree branches.  The dataset is
-        // created in the HDF5 file or group pointed to by parent_destination.
-        // This method returns false if the conversion fails, true if it
-        // succeeds.
+        // created in the HDF5 file or group pointed to by parent_destination,
+        // and each block of rows is also handed to the sink.  This method
+        // returns false if the conversion fails, true if it succeeds.
         bool convert(TTree *tree,
-                     hid_t parent_destination);
+                     hid_t parent_destination,
+                     const tree_sink & sink = tree_sink());
+
+        // This method performs all of the per-schema setup that convert would
+        // do for the tree (struct generation, HDF5 type generation, and
+        // branch address mapping, including any dictionary compilation), but
+        // without reading any entries or writing any output.  This is used to
+        // warm the caches before forking batch workers.  The tree's branch
+        // addresses are left dangling afterwards, so the tree should not be
+        // read from after calling this.  Returns true on success, false on
+        // failure.
+        bool prepare(TTree *tree);
     }
 }
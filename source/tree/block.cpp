@@ -0,0 +1,201 @@
+#include "tree/block.h"
+
+// C Standard includes
+#include <cstring>
+
+// Standard includes
+#include <algorithm>
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::block;
+
+
+// Private namespace members
+namespace root2hdf5
+{
+    namespace tree
+    {
+        namespace block
+        {
+            // The minimum size of the memory chunks of an arena
+            const size_t arena_chunk_bytes = 1024 * 1024;
+
+            // Arena allocations are aligned to this many bytes
+            const size_t arena_alignment = 16;
+
+            // Appends the variable-length members of a type located at the
+            // specified offset
+            void find_variable_length_members(
+                hid_t type,
+                size_t offset,
+                vector<variable_length_member> & members
+            );
+        }
+    }
+}
+
+
+hsize_t root2hdf5::tree::block::rows_per_block(size_t row_size,
+                                               hsize_t n_rows)
+{
+    hsize_t result = target_block_bytes / max(row_size, (size_t)1);
+    result = min(result, n_rows);
+    return max(result, (hsize_t)1);
+}
+
+
+void root2hdf5::tree::block::find_variable_length_members(
+    hid_t type,
+    size_t offset,
+    vector<variable_length_member> & members
+)
+{
+    H5T_class_t type_class = H5Tget_class(type);
+    if(type_class == H5T_COMPOUND)
+    {
+        int n_members = H5Tget_nmembers(type);
+        for(int i = 0; i < n_members; i++)
+        {
+            hid_t member_type = H5Tget_member_type(type, i);
+            find_variable_length_members(
+                member_type,
+                offset + H5Tget_member_offset(type, i),
+                members
+            );
+            H5Tclose(member_type);
+        }
+    }
+    else if(type_class == H5T_ARRAY)
+    {
+        // Only expand arrays which actually hold variable-length data
+        hid_t base_type = H5Tget_super(type);
+        vector<variable_length_member> element_members;
+        find_variable_length_members(base_type, 0, element_members);
+        if(!element_members.empty())
+        {
+            size_t element_size = H5Tget_size(base_type);
+            size_t n_elements = H5Tget_size(type) / element_size;
+            for(size_t i = 0; i < n_elements; i++)
+            {
+                for(auto it = element_members.begin();
+                    it != element_members.end();
+                    it++)
+                {
+                    variable_length_member member = *it;
+                    member.offset += offset + i * element_size;
+                    members.push_back(member);
+                }
+            }
+        }
+        H5Tclose(base_type);
+    }
+    else if(type_class == H5T_VLEN)
+    {
+        hid_t base_type = H5Tget_super(type);
+        variable_length_member member;
+        member.offset = offset;
+        member.is_string = false;
+        member.element_size = H5Tget_size(base_type);
+        find_variable_length_members(base_type, 0, member.element_members);
+        members.push_back(member);
+        H5Tclose(base_type);
+    }
+    else if(type_class == H5T_STRING && H5Tis_variable_str(type) > 0)
+    {
+        variable_length_member member;
+        member.offset = offset;
+        member.is_string = true;
+        member.element_size = 1;
+        members.push_back(member);
+    }
+}
+
+
+vector<variable_length_member>
+root2hdf5::tree::block::variable_length_members(hid_t type)
+{
+    vector<variable_length_member> members;
+    find_variable_length_members(type, 0, members);
+    return members;
+}
+
+
+void * root2hdf5::tree::block::arena_allocate(variable_length_arena & arena,
+                                              size_t size)
+{
+    size = (size + arena_alignment - 1) / arena_alignment * arena_alignment;
+
+    // Find room in the remaining chunks
+    for(; arena.current < arena.chunks.size(); arena.current++, arena.used = 0)
+    {
+        if(arena.used + size <= arena.chunks[arena.current].size())
+        {
+            void *result = &arena.chunks[arena.current][arena.used];
+            arena.used += size;
+            return result;
+        }
+    }
+
+    // Otherwise add a new chunk
+    arena.chunks.push_back(vector<char>(max(size, arena_chunk_bytes)));
+    arena.current = arena.chunks.size() - 1;
+    arena.used = size;
+    return &arena.chunks.back()[0];
+}
+
+
+void root2hdf5::tree::block::arena_reset(variable_length_arena & arena)
+{
+    arena.current = 0;
+    arena.used = 0;
+}
+
+
+void root2hdf5::tree::block::stage_variable_length_data(
+    const vector<variable_length_member> & members,
+    char *row,
+    variable_length_arena & arena
+)
+{
+    for(auto it = members.begin(); it != members.end(); it++)
+    {
+        if(it->is_string)
+        {
+            char **value = (char **)(row + it->offset);
+            if(*value != NULL)
+            {
+                size_t size = strlen(*value) + 1;
+                char *copy = (char *)arena_allocate(arena, size);
+                memcpy(copy, *value, size);
+                *value = copy;
+            }
+
+            continue;
+        }
+
+        hvl_t *sequence = (hvl_t *)(row + it->offset);
+        if(sequence->len == 0 || sequence->p == NULL)
+        {
+            continue;
+        }
+        size_t size = sequence->len * it->element_size;
+        char *copy = (char *)arena_allocate(arena, size);
+        memcpy(copy, sequence->p, size);
+        sequence->p = copy;
+
+        // Copy anything the elements point to as well
+        if(!it->element_members.empty())
+        {
+            for(size_t i = 0; i < sequence->len; i++)
+            {
+                stage_variable_length_data(it->element_members,
+                                           copy + i * it->element_size,
+                                           arena);
+            }
+        }
+    }
+}
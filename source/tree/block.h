@@ -0,0 +1,75 @@
+#pragma once
+
+// Standard includes
+#include <cstddef>
+#include <vector>
+
+// HDF5 includes
+#include <hdf5.h>
+
+
+namespace root2hdf5
+{
+    namespace tree
+    {
+        namespace block
+        {
+            // Rows are buffered into blocks of roughly this many bytes before
+            // being written out, and each block is exactly one chunk of the
+            // tree's dataset
+            const size_t target_block_bytes = 1024 * 1024;
+
+            // Returns the number of rows per block (and chunk) for rows of
+            // the specified size in a dataset of the specified length.  This
+            // is always at least one.
+            hsize_t rows_per_block(size_t row_size, hsize_t n_rows);
+
+            // Describes where variable-length data lives in a row, so that it
+            // can be copied out of the converters' buffers without walking the
+            // HDF5 type for every row.  Offsets are relative to the start of
+            // the enclosing row or sequence element.
+            struct variable_length_member
+            {
+                size_t offset;
+                bool is_string; // A char * rather than an hvl_t
+                size_t element_size; // Size of sequence elements
+                std::vector<variable_length_member> element_members;
+            };
+
+            // Finds all of the variable-length members of an HDF5 type,
+            // including those nested in compounds and arrays
+            std::vector<variable_length_member> variable_length_members(
+                hid_t type
+            );
+
+            // A simple bump allocator for the variable-length data of the
+            // rows in a block.  Memory is kept between blocks and reused once
+            // the arena is reset.
+            struct variable_length_arena
+            {
+                std::vector<std::vector<char> > chunks;
+                size_t current;
+                size_t used;
+
+                variable_length_arena() : current(0), used(0) {}
+            };
+
+            // Allocates memory from the arena
+            void * arena_allocate(variable_length_arena & arena, size_t size);
+
+            // Releases everything allocated from the arena
+            void arena_reset(variable_length_arena & arena);
+
+            // Copies the variable-length data referenced by a row into the
+            // arena and points the row at the copies.  Converters only
+            // guarantee that their variable-length data stays valid until the
+            // next entry is read, so this must be done to every row which is
+            // kept in a block.
+            void stage_variable_length_data(
+                const std::vector<variable_length_member> & members,
+                char *row,
+                variable_length_arena & arena
+            );
+        }
+    }
+}
@@ -0,0 +1,342 @@
+#include "tree/booleans.h"
+
+// Standard includes
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+// ROOT includes
+#include <TBranch.h>
+#include <TLeaf.h>
+
+// root2hdf5 includes
+#include "options.h"
+#include "type.h"
+#include "tree/walk.h"
+#include "tree/leaf_converters.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::booleans;
+using namespace root2hdf5::options;
+using namespace root2hdf5::type;
+using namespace root2hdf5::tree::walk;
+using namespace root2hdf5::tree::leaf_converters;
+
+
+// Private namespace members
+namespace root2hdf5
+{
+    namespace tree
+    {
+        namespace booleans
+        {
+            // A member of a compound type under construction
+            typedef pair<string, hid_t> member;
+
+            // Collects the members of a packed compound type which aren't
+            // named by paths, descending into nested compounds, and records
+            // the paths which were left out.  The member types should be
+            // closed with H5Tclose.
+            bool collect_members(hid_t type,
+                                 const string & prefix,
+                                 const vector<string> & paths,
+                                 vector<string> & removed,
+                                 vector<member> & members);
+
+            // Lays members out back to back in a new compound type
+            hid_t compound_from_members(const vector<member> & members);
+
+            // Closes the types of members
+            void close_members(vector<member> & members);
+        }
+    }
+}
+
+
+bool root2hdf5::tree::booleans::pack_booleans_requested()
+{
+    return root2hdf5::options::options.count("pack-booleans");
+}
+
+
+vector<string> root2hdf5::tree::booleans::boolean_leaf_paths(TTree *tree)
+{
+    // Walk the tree the same way the row type is built, so that the paths
+    // match its member names.  Single-leaf branches are just their leaf.
+    vector<string> result;
+    vector<string> branch_path;
+    walk_tree(
+        tree,
+
+        // Branch open
+        [&branch_path](TBranch *branch) -> bool {
+            branch_path.push_back(branch->GetName());
+            return true;
+        },
+
+        // Leaf process
+        [&branch_path, &result](TLeaf *leaf) -> bool {
+            leaf_converter *converter = find_converter(leaf);
+            if(converter != NULL
+               && converter->name == "scalar"
+               && is_boolean_type_name(leaf->GetTypeName()))
+            {
+                string path;
+                for(auto it = branch_path.begin();
+                    it != branch_path.end();
+                    it++)
+                {
+                    path += *it + ".";
+                }
+                result.push_back(path + leaf->GetName());
+            }
+            return true;
+        },
+
+        // Branch close
+        [&branch_path](TBranch *branch) -> bool {
+            // Silence unused variable warnings
+            (void)branch;
+
+            branch_path.pop_back();
+            return true;
+        }
+    );
+
+    return result;
+}
+
+
+hid_t root2hdf5::tree::booleans::bitfield_type(size_t n_bits)
+{
+    if(n_bits <= 8)
+    {
+        return H5Tcopy(H5T_NATIVE_B8);
+    }
+    else if(n_bits <= 16)
+    {
+        return H5Tcopy(H5T_NATIVE_B16);
+    }
+    else if(n_bits <= 32)
+    {
+        return H5Tcopy(H5T_NATIVE_B32);
+    }
+    else if(n_bits <= 64)
+    {
+        return H5Tcopy(H5T_NATIVE_B64);
+    }
+
+    hsize_t n_words = (n_bits + 63) / 64;
+    return H5Tarray_create2(H5T_NATIVE_B64, 1, &n_words);
+}
+
+
+bool root2hdf5::tree::booleans::collect_members(hid_t type,
+                                                const string & prefix,
+                                                const vector<string> & paths,
+                                                vector<string> & removed,
+                                                vector<member> & members)
+{
+    int n_members = H5Tget_nmembers(type);
+    if(n_members < 0)
+    {
+        return false;
+    }
+
+    for(unsigned i = 0; i < (unsigned)n_members; i++)
+    {
+        char *name = H5Tget_member_name(type, i);
+        if(name == NULL)
+        {
+            return false;
+        }
+        string member_name = name;
+        H5free_memory(name);
+        string path = prefix.empty()
+                      ? member_name
+                      : prefix + "." + member_name;
+
+        // Leave out the booleans
+        if(find(paths.begin(), paths.end(), path) != paths.end())
+        {
+            removed.push_back(path);
+            continue;
+        }
+
+        // Rebuild nested compounds without theirs, dropping any left empty
+        hid_t member_type = H5Tget_member_type(type, i);
+        if(member_type < 0)
+        {
+            return false;
+        }
+        if(H5Tget_class(member_type) == H5T_COMPOUND)
+        {
+            vector<member> nested;
+            bool success = collect_members(member_type,
+                                           path,
+                                           paths,
+                                           removed,
+                                           nested);
+            H5Tclose(member_type);
+            member_type = -1;
+            if(success && !nested.empty())
+            {
+                member_type = compound_from_members(nested);
+                success = member_type >= 0;
+            }
+            close_members(nested);
+            if(!success)
+            {
+                return false;
+            }
+            if(member_type < 0)
+            {
+                continue;
+            }
+        }
+        members.push_back(make_pair(member_name, member_type));
+    }
+
+    return true;
+}
+
+
+hid_t root2hdf5::tree::booleans::compound_from_members(
+    const vector<member> & members
+)
+{
+    size_t size = 0;
+    for(auto it = members.begin(); it != members.end(); it++)
+    {
+        size += H5Tget_size(it->second);
+    }
+    hid_t result = size > 0 ? H5Tcreate(H5T_COMPOUND, size) : -1;
+    size_t offset = 0;
+    for(auto it = members.begin(); result >= 0 && it != members.end(); it++)
+    {
+        if(H5Tinsert(result, it->first.c_str(), offset, it->second) < 0)
+        {
+            H5Tclose(result);
+            result = -1;
+        }
+        offset += H5Tget_size(it->second);
+    }
+
+    return result;
+}
+
+
+void root2hdf5::tree::booleans::close_members(vector<member> & members)
+{
+    for(auto it = members.begin(); it != members.end(); it++)
+    {
+        H5Tclose(it->second);
+    }
+    members.clear();
+}
+
+
+hid_t root2hdf5::tree::booleans::boolean_file_type(
+    hid_t packed_type,
+    const vector<string> & paths,
+    vector<string> & packed_paths
+)
+{
+    packed_paths.clear();
+    if(paths.empty())
+    {
+        return H5Tcopy(packed_type);
+    }
+
+    // Take the booleans out
+    vector<member> members;
+    if(!collect_members(packed_type, "", paths, packed_paths, members))
+    {
+        close_members(members);
+        if(verbose)
+        {
+            cerr << "ERROR: Unable to remove booleans from row type" << endl;
+        }
+
+        return -1;
+    }
+    if(packed_paths.empty())
+    {
+        close_members(members);
+        return H5Tcopy(packed_type);
+    }
+
+    // And put the bits in at the end
+    hid_t bits_type = bitfield_type(packed_paths.size());
+    if(bits_type >= 0)
+    {
+        members.push_back(make_pair(string(bits_member_name), bits_type));
+    }
+    hid_t result = bits_type >= 0 ? compound_from_members(members) : -1;
+    close_members(members);
+    if(result < 0 && verbose)
+    {
+        cerr << "ERROR: Unable to create bitfield for booleans" << endl;
+    }
+
+    return result;
+}
+
+
+bool root2hdf5::tree::booleans::write_bits_attribute(
+    hid_t dataset,
+    const vector<string> & paths
+)
+{
+    if(paths.empty())
+    {
+        return true;
+    }
+
+    // Write the paths as variable-length strings, indexed by bit
+    vector<const char *> names;
+    for(auto it = paths.begin(); it != paths.end(); it++)
+    {
+        names.push_back(it->c_str());
+    }
+    hsize_t n_names = names.size();
+    hid_t string_type = H5Tcopy(H5T_C_S1);
+    hid_t space = H5Screate_simple(1, &n_names, NULL);
+    hid_t attribute = -1;
+    if(string_type >= 0
+       && space >= 0
+       && H5Tset_size(string_type, H5T_VARIABLE) >= 0)
+    {
+        attribute = H5Acreate2(dataset,
+                               bits_attribute_name,
+                               string_type,
+                               space,
+                               H5P_DEFAULT,
+                               H5P_DEFAULT);
+    }
+    bool success = attribute >= 0
+                   && H5Awrite(attribute, string_type, &names[0]) >= 0;
+    if(attribute >= 0 && H5Aclose(attribute) < 0)
+    {
+        success = false;
+    }
+    if(space >= 0)
+    {
+        H5Sclose(space);
+    }
+    if(string_type >= 0)
+    {
+        H5Tclose(string_type);
+    }
+    if(!success && verbose)
+    {
+        cerr << "ERROR: Unable to write the \"" << bits_attribute_name
+             << "\" attribute" << endl;
+    }
+
+    return success;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+// Standard includes
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// ROOT includes
+#include <TTree.h>
+
+// HDF5 includes
+#include <hdf5.h>
+
+
+namespace root2hdf5
+{
+    namespace tree
+    {
+        namespace booleans
+        {
+            // The member of the file type which holds the packed booleans of
+            // a row
+            const char * const bits_member_name = "_booleans";
+
+            // The dataset attribute naming the boolean behind each bit,
+            // i.e. element n is the path of bit n
+            const char * const bits_attribute_name = "boolean_bits";
+
+            // Returns true if --pack-booleans was given
+            bool pack_booleans_requested();
+
+            // Returns the paths (in the row type, with nested members
+            // separated by '.') of the scalar boolean leaves of a tree, in
+            // the order they appear in the row
+            std::vector<std::string> boolean_leaf_paths(TTree *tree);
+
+            // Returns the type of a bitfield with room for n_bits bits: the
+            // smallest of H5T_NATIVE_B8 to H5T_NATIVE_B64 which fits, or an
+            // array of H5T_NATIVE_B64 words beyond 64 bits.  Bit n lives in
+            // word n / 64 as the value 1 << (n % 64).  Returns -1 on failure.
+            // The caller should close the type with H5Tclose.
+            hid_t bitfield_type(size_t n_bits);
+
+            // Returns a copy of a packed file type with the boolean members
+            // named by paths taken out and replaced by a single bitfield
+            // member at the end of the row, dropping any nested compounds
+            // left empty.  The paths of the booleans which were found are
+            // stored in packed_paths, in bit order.  If none were found, the
+            // type is just copied.  Returns -1 on failure.  The caller should
+            // close the type with H5Tclose.
+            hid_t boolean_file_type(hid_t packed_type,
+                                    const std::vector<std::string> & paths,
+                                    std::vector<std::string> & packed_paths);
+
+            // Records which boolean each bit of a dataset holds, as an array
+            // of strings in the bits_attribute_name attribute.  Returns false
+            // on failure.
+            bool write_bits_attribute(hid_t dataset,
+                                      const std::vector<std::string> & paths);
+        }
+    }
+}
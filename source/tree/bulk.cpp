@@ -0,0 +1,320 @@
+#include "tree/bulk.h"
+
+// C Standard includes
+#include <cstring>
+
+// Standard includes
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <set>
+
+// ROOT includes
+#include <RVersion.h>
+#include <TBranch.h>
+#include <TBufferFile.h>
+#include <TFriendElement.h>
+#include <TLeaf.h>
+#include <TObjArray.h>
+
+// root2hdf5 includes
+#include "options.h"
+#include "progress.h"
+#include "tree/profile.h"
+#include "tree/byte_order.h"
+#include "tree/leaf_converters.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::bulk;
+using namespace root2hdf5::tree::map_root;
+using namespace root2hdf5::tree::leaf_converters;
+using namespace root2hdf5::tree::byte_order;
+using namespace root2hdf5::options;
+
+
+// Private namespace members
+namespace root2hdf5
+{
+    namespace tree
+    {
+        namespace bulk
+        {
+            // The size of the buffers baskets are read into, which ROOT grows
+            // as necessary
+            const Int_t initial_basket_buffer_size = 32 * 1024;
+
+            // A single bulk-read column and the basket currently loaded for
+            // it
+            struct bulk_column
+            {
+                TBranch *branch;
+                size_t row_offset;
+                size_t value_size;
+                bool swap; // Whether values are swapped to native order
+                std::shared_ptr<TBufferFile> buffer;
+                std::shared_ptr<vector<char> > swapped;
+                const char *values; // The values of the loaded basket
+                Long64_t first; // The first entry of the loaded basket
+                Long64_t count; // The number of entries in it
+            };
+
+            // Loads the basket of a column holding an entry
+            bool load_basket(bulk_column & column, Long64_t entry);
+
+            // Adds the branches holding the counters of variable-length
+            // leaves (e.g. n for x[n]) of a tree and its friends to a set.
+            // These must stay enabled for TTree::GetEntry, since TLeaf::GetLen
+            // reads the counter's current value.
+            void add_counter_branches(TTree *tree, set<TBranch *> & counters);
+        }
+    }
+}
+
+
+bool root2hdf5::tree::bulk::bulk_read_requested()
+{
+    return root2hdf5::options::options.count("no-bulk-read") == 0
+           && !root2hdf5::tree::profile::profiling_requested();
+}
+
+
+bool root2hdf5::tree::bulk::load_basket(bulk_column & column, Long64_t entry)
+{
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 14, 0)
+    // Find the basket holding the entry.  Bulk reads always start at the
+    // beginning of a basket.
+    const Long64_t *basket_entry = column.branch->GetBasketEntry();
+    const Long64_t *basket_end = basket_entry
+                                 + column.branch->GetWriteBasket() + 1;
+    const Long64_t *basket = upper_bound(basket_entry, basket_end, entry);
+    if(basket == basket_entry)
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Unable to bulk read entry " << entry
+                 << " of branch \"" << column.branch->GetName() << "\""
+                 << " (entry precedes its first basket)" << endl;
+        }
+
+        return false;
+    }
+    column.first = *(basket - 1);
+
+    // Read it serialized, which leaves the values big-endian
+    Int_t count = column.branch->GetBulkRead().GetEntriesSerialized(
+        column.first,
+        *column.buffer
+    );
+    if(count <= 0 || entry >= column.first + count)
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Unable to bulk read entry " << entry
+                 << " of branch \"" << column.branch->GetName() << "\""
+                 << endl;
+        }
+
+        return false;
+    }
+    column.count = count;
+    root2hdf5::progress::add_bytes_read(count * column.value_size);
+
+    // Swap the whole basket into native order if necessary
+    column.values = column.buffer->GetCurrent();
+    if(column.swap)
+    {
+        column.swapped->resize(count * column.value_size);
+        swap_byte_order(column.values,
+                        &(*column.swapped)[0],
+                        count,
+                        column.value_size);
+        column.values = &(*column.swapped)[0];
+    }
+
+    return true;
+#else
+    // Silence unused variable warnings
+    (void)column;
+    (void)entry;
+
+    return false;
+#endif
+}
+
+
+void root2hdf5::tree::bulk::add_counter_branches(TTree *tree,
+                                                 set<TBranch *> & counters)
+{
+    TIter next_leaf(tree->GetListOfLeaves());
+    TLeaf *leaf = NULL;
+    while((leaf = (TLeaf *)next_leaf()))
+    {
+        if(leaf->GetLeafCount() != NULL)
+        {
+            counters.insert(leaf->GetLeafCount()->GetBranch());
+        }
+    }
+
+    if(tree->GetListOfFriends() == NULL)
+    {
+        return;
+    }
+    TIter next_friend(tree->GetListOfFriends());
+    TFriendElement *friend_element = NULL;
+    while((friend_element = (TFriendElement *)next_friend()))
+    {
+        if(friend_element->GetTree() != NULL)
+        {
+            add_counter_branches(friend_element->GetTree(), counters);
+        }
+    }
+}
+
+
+boost::tuple<bool, block_filler, root_resource_deallocator, bool, hid_t>
+root2hdf5::tree::bulk::build_bulk_reader(TTree *tree,
+                                         hid_t row_type,
+                                         const vector<string> & excluded,
+                                         bool big_endian)
+{
+    // Find the top-level single-leaf branches which can be read in bulk.
+    // Friends' branches are always read entry by entry, since their entries
+    // are only aligned by TTree::GetEntry.  Counter branches are left to
+    // TTree::GetEntry too, so variable-length leaves see their lengths.
+    set<TBranch *> counters;
+    add_counter_branches(tree, counters);
+    vector<bulk_column> columns;
+    vector<string> names;
+    bool needs_entry_reads = tree->GetListOfFriends() != NULL
+                             && tree->GetListOfFriends()->GetEntries() > 0
+                             && root2hdf5::options::options.count(
+                                    "ignore-friends"
+                                ) == 0;
+    TIter next_branch(tree->GetListOfBranches());
+    TBranch *branch = NULL;
+    while((branch = (TBranch *)next_branch()))
+    {
+        TLeaf *leaf = branch->GetListOfLeaves()->GetEntries() == 1
+                      ? (TLeaf *)branch->GetListOfLeaves()->At(0)
+                      : NULL;
+        leaf_converter *converter = leaf != NULL
+                                    ? find_converter(leaf)
+                                    : NULL;
+        int member = leaf != NULL
+                     ? H5Tget_member_index(row_type, leaf->GetName())
+                     : -1;
+        if(converter == NULL
+           || counters.count(branch)
+           || !converter->can_bulk_read
+           || !converter->can_bulk_read(leaf)
+           || member < 0
+           || find(excluded.begin(), excluded.end(), leaf->GetName())
+              != excluded.end())
+        {
+            needs_entry_reads = true;
+            continue;
+        }
+
+        hid_t member_type = H5Tget_member_type(row_type, member);
+        bulk_column column;
+        column.branch = branch;
+        column.row_offset = H5Tget_member_offset(row_type, member);
+        column.value_size = H5Tget_size(member_type);
+        column.swap = !big_endian && column.value_size > 1;
+        column.buffer.reset(new TBufferFile(TBuffer::kWrite,
+                                            initial_basket_buffer_size));
+        column.swapped.reset(new vector<char>());
+        column.values = NULL;
+        column.first = 0;
+        column.count = 0;
+        H5Tclose(member_type);
+        columns.push_back(column);
+        names.push_back(leaf->GetName());
+    }
+    if(columns.empty())
+    {
+        return boost::make_tuple(
+            true,
+            block_filler(),
+            []() -> bool { return true; },
+            true,
+            -1
+        );
+    }
+
+    // Describe the big-endian columns, if they are kept that way
+    hid_t written_type = -1;
+    if(big_endian)
+    {
+        written_type = big_endian_row_type(row_type, names);
+        if(written_type < 0)
+        {
+            return boost::make_tuple(
+                false,
+                block_filler(),
+                root_resource_deallocator(),
+                true,
+                -1
+            );
+        }
+    }
+
+    // Stop TTree::GetEntry from reading the bulk branches
+    for(auto it = columns.begin(); it != columns.end(); it++)
+    {
+        tree->SetBranchStatus(it->branch->GetName(), 0);
+    }
+    if(verbose)
+    {
+        cout << "Reading " << columns.size() << " branches of tree \""
+             << tree->GetName() << "\" in bulk" << endl;
+    }
+
+    // Shared between the callbacks, since the filler keeps track of the
+    // loaded baskets
+    std::shared_ptr<vector<bulk_column> > state(
+        new vector<bulk_column>(columns)
+    );
+    size_t row_size = H5Tget_size(row_type);
+
+    return boost::make_tuple(
+        true,
+        [state, row_size](const Long64_t *entries,
+                          hsize_t n_rows,
+                          char *rows) -> bool {
+            // Go column by column, so each basket is walked in order
+            for(auto it = state->begin(); it != state->end(); it++)
+            {
+                char *destination = rows + it->row_offset;
+                for(hsize_t i = 0; i < n_rows; i++, destination += row_size)
+                {
+                    Long64_t entry = entries[i];
+                    if((entry < it->first || entry >= it->first + it->count)
+                       && !load_basket(*it, entry))
+                    {
+                        return false;
+                    }
+                    memcpy(destination,
+                           it->values + (entry - it->first) * it->value_size,
+                           it->value_size);
+                }
+            }
+
+            return true;
+        },
+        [state, tree]() -> bool {
+            for(auto it = state->begin(); it != state->end(); it++)
+            {
+                tree->SetBranchStatus(it->branch->GetName(), 1);
+            }
+
+            return true;
+        },
+        needs_entry_reads,
+        written_type
+    );
+}
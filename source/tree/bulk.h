@@ -0,0 +1,69 @@
+#pragma once
+
+// Standard includes
+#include <functional>
+#include <string>
+#include <vector>
+
+// HACK: Use Boost.Tuple instead of std::tuple because at the moment, the LLVM-
+// provided libc++ doesn't support the std::tuple, and Boost.Tuple is
+// effectively the same thing.
+// Boost includes
+#include <boost/tuple/tuple.hpp>
+
+// ROOT includes
+#include <TTree.h>
+
+// HDF5 includes
+#include <hdf5.h>
+
+// root2hdf5 includes
+#include "tree/map_root.h"
+
+
+namespace root2hdf5
+{
+    namespace tree
+    {
+        namespace bulk
+        {
+            // Callback type for filling the bulk-read columns of a block of
+            // rows.  It receives the entry number of each row, the number of
+            // rows and the rows themselves, laid out as in the row type.
+            typedef std::function<bool(const Long64_t *, hsize_t, char *)>
+                block_filler;
+
+            // Returns true unless --no-bulk-read was given, or branch
+            // profiling (which reads every branch entry by entry) was
+            // requested
+            bool bulk_read_requested();
+
+            // Sets up bulk reading for the top-level branches of a tree whose
+            // leaf converters declare them bulk-capable, except for the
+            // excluded leaves (e.g. index columns, which are read entry by
+            // entry).  Those branches are disabled for TTree::GetEntry, and
+            // are instead read a basket at a time with ROOT's bulk I/O API
+            // and scattered into each block of rows by the filler.  Baskets
+            // are read serialized, i.e. big-endian, and byte-swapped a whole
+            // basket at a time, unless big_endian is true, in which case the
+            // values are left big-endian and the written type describes them
+            // as such.  The deallocator re-enables the branches.  If every
+            // branch is read in bulk, the tree no longer needs to be read
+            // entry by entry at all.  This method returns a tuple of the form:
+            //      (success, filler, deallocator, needs_entry_reads,
+            //       written_type)
+            // where the filler is empty if no branch can be read in bulk, and
+            // the written type is -1 unless it differs from the row type, in
+            // which case the caller should close it with H5Tclose.
+            boost::tuple<bool,
+                         block_filler,
+                         map_root::root_resource_deallocator,
+                         bool,
+                         hid_t>
+            build_bulk_reader(TTree *tree,
+                              hid_t row_type,
+                              const std::vector<std::string> & excluded,
+                              bool big_endian);
+        }
+    }
+}
@@ -0,0 +1,224 @@
+#include "tree/byte_order.h"
+
+// C Standard includes
+#include <cstring>
+#include <stdint.h>
+
+// Standard includes
+#include <algorithm>
+#include <iostream>
+
+// SSSE3 includes.  The shuffle kernel is compiled for SSSE3 on any x86
+// build and picked at runtime, so it doesn't depend on the compiler flags.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ROOT2HDF5_SSSE3_SWAP 1
+#include <tmmintrin.h>
+#endif
+
+// root2hdf5 includes
+#include "options.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::byte_order;
+using namespace root2hdf5::options;
+
+
+// Private namespace members
+namespace root2hdf5
+{
+    namespace tree
+    {
+        namespace byte_order
+        {
+#ifdef ROOT2HDF5_SSSE3_SWAP
+            // Returns true if the CPU supports SSSE3
+            bool have_ssse3();
+
+            // Swaps as many whole 16 byte blocks of values as fit in n_bytes
+            // with SSSE3 byte shuffles, and returns the number of bytes
+            // swapped.  This may only be called if have_ssse3() is true.
+            __attribute__((target("ssse3")))
+            size_t swap_blocks(const char *source,
+                               char *destination,
+                               size_t n_bytes,
+                               size_t value_size);
+#endif
+        }
+    }
+}
+
+
+bool root2hdf5::tree::byte_order::big_endian_requested()
+{
+    return root2hdf5::options::options.count("big-endian");
+}
+
+
+#ifdef ROOT2HDF5_SSSE3_SWAP
+bool root2hdf5::tree::byte_order::have_ssse3()
+{
+    static const bool supported = __builtin_cpu_supports("ssse3");
+    return supported;
+}
+
+
+size_t root2hdf5::tree::byte_order::swap_blocks(const char *source,
+                                                char *destination,
+                                                size_t n_bytes,
+                                                size_t value_size)
+{
+    // Shuffle masks reversing each 2, 4 or 8 byte lane
+    __m128i mask;
+    switch(value_size)
+    {
+        case 2:
+            mask = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6,
+                                 9, 8, 11, 10, 13, 12, 15, 14);
+            break;
+        case 4:
+            mask = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4,
+                                 11, 10, 9, 8, 15, 14, 13, 12);
+            break;
+        case 8:
+            mask = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0,
+                                 15, 14, 13, 12, 11, 10, 9, 8);
+            break;
+        default:
+            return 0;
+    }
+
+    size_t n_blocks = n_bytes / 16;
+    for(size_t i = 0; i < n_blocks; i++)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i *)source + i);
+        _mm_storeu_si128((__m128i *)destination + i,
+                         _mm_shuffle_epi8(block, mask));
+    }
+
+    return n_blocks * 16;
+}
+#endif
+
+
+void root2hdf5::tree::byte_order::swap_byte_order(const char *source,
+                                                  char *destination,
+                                                  size_t n_values,
+                                                  size_t value_size)
+{
+    // Swap what we can 16 bytes at a time if the CPU has byte shuffles,
+    // then the rest value by value.  The values may not be aligned, so go
+    // through memcpy, which compiles down to plain loads and stores around a
+    // bswap.
+#ifdef ROOT2HDF5_SSSE3_SWAP
+    if(have_ssse3())
+    {
+        size_t swapped = swap_blocks(source,
+                                     destination,
+                                     n_values * value_size,
+                                     value_size);
+        source += swapped;
+        destination += swapped;
+        if(swapped > 0)
+        {
+            n_values -= swapped / value_size;
+        }
+    }
+#endif
+    switch(value_size)
+    {
+        case 2:
+            for(size_t i = 0; i < n_values; i++)
+            {
+                uint16_t value;
+                memcpy(&value, source + 2 * i, 2);
+                value = __builtin_bswap16(value);
+                memcpy(destination + 2 * i, &value, 2);
+            }
+            break;
+        case 4:
+            for(size_t i = 0; i < n_values; i++)
+            {
+                uint32_t value;
+                memcpy(&value, source + 4 * i, 4);
+                value = __builtin_bswap32(value);
+                memcpy(destination + 4 * i, &value, 4);
+            }
+            break;
+        case 8:
+            for(size_t i = 0; i < n_values; i++)
+            {
+                uint64_t value;
+                memcpy(&value, source + 8 * i, 8);
+                value = __builtin_bswap64(value);
+                memcpy(destination + 8 * i, &value, 8);
+            }
+            break;
+        default:
+            memcpy(destination, source, n_values * value_size);
+            break;
+    }
+}
+
+
+hid_t root2hdf5::tree::byte_order::big_endian_row_type(
+    hid_t row_type,
+    const vector<string> & members
+)
+{
+    hid_t result = H5Tcreate(H5T_COMPOUND, H5Tget_size(row_type));
+    int n_members = H5Tget_nmembers(row_type);
+    bool success = result >= 0 && n_members >= 0;
+    for(unsigned i = 0; success && i < (unsigned)n_members; i++)
+    {
+        char *name = H5Tget_member_name(row_type, i);
+        hid_t member_type = H5Tget_member_type(row_type, i);
+        success = name != NULL && member_type >= 0;
+
+        // Swap the order of a copy of the member's type if it is named
+        hid_t inserted_type = -1;
+        if(success)
+        {
+            inserted_type = H5Tcopy(member_type);
+            if(find(members.begin(), members.end(), name) != members.end())
+            {
+                success = H5Tset_order(inserted_type, H5T_ORDER_BE) >= 0;
+            }
+        }
+        success = success
+                  && inserted_type >= 0
+                  && H5Tinsert(result,
+                               name,
+                               H5Tget_member_offset(row_type, i),
+                               inserted_type) >= 0;
+
+        H5free_memory(name);
+        if(inserted_type >= 0)
+        {
+            H5Tclose(inserted_type);
+        }
+        if(member_type >= 0)
+        {
+            H5Tclose(member_type);
+        }
+    }
+
+    if(!success)
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Unable to create big-endian row type" << endl;
+        }
+        if(result >= 0)
+        {
+            H5Tclose(result);
+        }
+
+        return -1;
+    }
+
+    return result;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+// Standard includes
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// HDF5 includes
+#include <hdf5.h>
+
+
+namespace root2hdf5
+{
+    namespace tree
+    {
+        namespace byte_order
+        {
+            // Returns true if --big-endian was given
+            bool big_endian_requested();
+
+            // Copies n_values values of value_size bytes (1, 2, 4 or 8) from
+            // source to destination, reversing the bytes of each, e.g. to
+            // turn the big-endian values of a serialized ROOT basket into
+            // native little-endian ones.  On x86 CPUs with SSSE3, 16 bytes
+            // are swapped at a time with byte shuffles, and otherwise (and
+            // for the remainder) each width has its own fixed-width bswap
+            // loop.  The source and destination may be the same buffer, but
+            // must not otherwise overlap.
+            void swap_byte_order(const char *source,
+                                 char *destination,
+                                 size_t n_values,
+                                 size_t value_size);
+
+            // Returns a copy of a compound row type in which the named
+            // top-level members are big-endian.  Returns -1 on failure.  The
+            // caller should close the type with H5Tclose.
+            hid_t big_endian_row_type(hid_t row_type,
+                                      const std::vector<std::string> & members);
+        }
+    }
+}
@@ -0,0 +1,595 @@
+#include "tree/index.h"
+
+// C Standard includes
+#include <cstdio>
+
+// Standard includes
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <queue>
+
+// Boost includes
+#include <boost/algorithm/string.hpp>
+
+// ROOT includes
+#include <TLeaf.h>
+#include <TTreeIndex.h>
+
+// root2hdf5 includes
+#include "options.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// Boost namespaces
+using namespace boost;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::index;
+using namespace root2hdf5::tree::map_root;
+using namespace root2hdf5::options;
+
+
+// Private namespace members
+namespace root2hdf5
+{
+    namespace tree
+    {
+        namespace index
+        {
+            // Records are written to HDF5 in blocks of this many
+            const size_t write_block_records = 64 * 1024;
+
+            // The state of an index being collected from the entry loop.
+            // Sorted runs which didn't fit in memory are kept in anonymous
+            // temporary files, which are closed (and thus removed) along with
+            // the state.
+            struct index_sorter
+            {
+                vector<TLeaf *> leaves;
+                size_t records_per_run;
+                vector<index_record> records;
+                vector<FILE *> runs;
+                hsize_t n_records;
+
+                ~index_sorter()
+                {
+                    for(auto it = runs.begin(); it != runs.end(); it++)
+                    {
+                        fclose(*it);
+                    }
+                }
+            };
+
+            // Creates the compound type of the index dataset
+            hid_t create_index_type(const vector<string> & columns);
+
+            // Creates the index dataset and its file data space
+            bool create_index_dataset(hid_t parent_destination,
+                                      const string & name,
+                                      hid_t type,
+                                      hsize_t n_records,
+                                      hid_t & dataset,
+                                      hid_t & space);
+
+            // Writes a block of records at the given offset in the dataset
+            bool write_index_records(hid_t dataset,
+                                     hid_t space,
+                                     hid_t type,
+                                     hsize_t offset,
+                                     const vector<index_record> & records);
+
+            // Sorts the in-memory records and writes them to a new temporary
+            // file
+            bool spill_run(index_sorter & sorter);
+
+            // Sorts or merges everything collected and writes the dataset
+            bool write_sorted_index(index_sorter & sorter,
+                                    const vector<string> & columns,
+                                    hid_t parent_destination,
+                                    const string & name);
+
+            // Writes the dataset from an existing TTreeIndex
+            bool write_tree_index(TTreeIndex *tree_index,
+                                  const vector<string> & columns,
+                                  hid_t parent_destination,
+                                  const string & name);
+        }
+    }
+}
+
+
+bool root2hdf5::tree::index::index_record_less(const index_record & a,
+                                               const index_record & b)
+{
+    for(unsigned i = 0; i < max_index_columns; i++)
+    {
+        if(a.keys[i] != b.keys[i])
+        {
+            return a.keys[i] < b.keys[i];
+        }
+    }
+
+    return a.entry < b.entry;
+}
+
+
+vector<string> root2hdf5::tree::index::index_columns()
+{
+    vector<string> columns;
+    if(root2hdf5::options::options.count("index") == 0)
+    {
+        return columns;
+    }
+
+    string specification
+        = root2hdf5::options::options["index"].as<string>();
+    split(columns, specification, is_any_of(","));
+    for(auto it = columns.begin(); it != columns.end(); it++)
+    {
+        trim(*it);
+    }
+
+    return columns;
+}
+
+
+string root2hdf5::tree::index::index_dataset_name(TTree *tree)
+{
+    return string(tree->GetName()) + ".index";
+}
+
+
+hid_t root2hdf5::tree::index::create_index_type(const vector<string> & columns)
+{
+    hid_t type = H5Tcreate(H5T_COMPOUND, sizeof(index_record));
+    if(type < 0)
+    {
+        return -1;
+    }
+
+    bool success = true;
+    for(unsigned i = 0; i < columns.size(); i++)
+    {
+        success = success && H5Tinsert(type,
+                                       columns[i].c_str(),
+                                       HOFFSET(index_record, keys)
+                                       + i * sizeof(Long64_t),
+                                       H5T_NATIVE_LLONG) >= 0;
+    }
+    success = success && H5Tinsert(type,
+                                   "entry",
+                                   HOFFSET(index_record, entry),
+                                   H5T_NATIVE_LLONG) >= 0;
+
+    // Drop the unused keys from the on-disk layout
+    if(!success || H5Tpack(type) < 0)
+    {
+        H5Tclose(type);
+        return -1;
+    }
+
+    return type;
+}
+
+
+bool root2hdf5::tree::index::create_index_dataset(hid_t parent_destination,
+                                                  const string & name,
+                                                  hid_t type,
+                                                  hsize_t n_records,
+                                                  hid_t & dataset,
+                                                  hid_t & space)
+{
+    space = H5Screate_simple(1, &n_records, NULL);
+    if(space < 0)
+    {
+        return false;
+    }
+
+    dataset = H5Dcreate2(parent_destination,
+                         name.c_str(),
+                         type,
+                         space,
+                         H5P_DEFAULT,
+                         H5P_DEFAULT,
+                         H5P_DEFAULT);
+    if(dataset < 0)
+    {
+        H5Sclose(space);
+        return false;
+    }
+
+    return true;
+}
+
+
+bool root2hdf5::tree::index::write_index_records(
+    hid_t dataset,
+    hid_t space,
+    hid_t type,
+    hsize_t offset,
+    const vector<index_record> & records
+)
+{
+    if(records.empty())
+    {
+        return true;
+    }
+
+    // The memory type still describes the full record layout, while the
+    // dataset type was packed, so convert between them on write
+    hsize_t count = records.size();
+    hid_t memory_space = H5Screate_simple(1, &count, NULL);
+    hid_t memory_type = H5Tcreate(H5T_COMPOUND, sizeof(index_record));
+    int n_members = H5Tget_nmembers(type);
+    for(int i = 0; i < n_members; i++)
+    {
+        char *name = H5Tget_member_name(type, i);
+        size_t member_offset = (i == n_members - 1)
+                               ? HOFFSET(index_record, entry)
+                               : HOFFSET(index_record, keys)
+                                 + i * sizeof(Long64_t);
+        H5Tinsert(memory_type, name, member_offset, H5T_NATIVE_LLONG);
+        H5free_memory(name);
+    }
+
+    bool success = H5Sselect_hyperslab(space,
+                                       H5S_SELECT_SET,
+                                       &offset,
+                                       NULL,
+                                       &count,
+                                       NULL) >= 0
+                   && H5Dwrite(dataset,
+                               memory_type,
+                               memory_space,
+                               space,
+                               H5P_DEFAULT,
+                               &records[0]) >= 0;
+
+    H5Tclose(memory_type);
+    H5Sclose(memory_space);
+
+    return success;
+}
+
+
+bool root2hdf5::tree::index::spill_run(index_sorter & sorter)
+{
+    sort(sorter.records.begin(), sorter.records.end(), index_record_less);
+
+    FILE *run = tmpfile();
+    if(run == NULL)
+    {
+        return false;
+    }
+    sorter.runs.push_back(run);
+    if(fwrite(&sorter.records[0],
+              sizeof(index_record),
+              sorter.records.size(),
+              run) != sorter.records.size())
+    {
+        return false;
+    }
+    rewind(run);
+    sorter.records.clear();
+
+    return true;
+}
+
+
+bool root2hdf5::tree::index::write_sorted_index(index_sorter & sorter,
+                                                const vector<string> & columns,
+                                                hid_t parent_destination,
+                                                const string & name)
+{
+    // If everything was spilled, merge the remaining records in as one more
+    // run, otherwise just sort them in place
+    if(!sorter.runs.empty() && !sorter.records.empty() && !spill_run(sorter))
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Unable to spill index run to disk" << endl;
+        }
+
+        return false;
+    }
+    if(sorter.runs.empty())
+    {
+        sort(sorter.records.begin(), sorter.records.end(), index_record_less);
+    }
+
+    // Create the dataset
+    hid_t type = create_index_type(columns);
+    hid_t dataset = -1, space = -1;
+    if(type < 0
+       || !create_index_dataset(parent_destination,
+                                name,
+                                type,
+                                sorter.n_records,
+                                dataset,
+                                space))
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Unable to create index dataset \"" << name << "\""
+                 << endl;
+        }
+
+        if(type >= 0)
+        {
+            H5Tclose(type);
+        }
+
+        return false;
+    }
+
+    bool success = true;
+    if(sorter.runs.empty())
+    {
+        success = write_index_records(dataset, space, type, 0, sorter.records);
+    }
+    else
+    {
+        // Do a k-way merge of the runs, keeping the head record of each run
+        // in a heap
+        typedef pair<index_record, size_t> head;
+        auto greater = [](const head & a, const head & b) -> bool {
+            return index_record_less(b.first, a.first);
+        };
+        priority_queue<head, vector<head>, decltype(greater)> heads(greater);
+        for(size_t i = 0; i < sorter.runs.size(); i++)
+        {
+            index_record record;
+            if(fread(&record, sizeof(index_record), 1, sorter.runs[i]) == 1)
+            {
+                heads.push(make_pair(record, i));
+            }
+        }
+
+        vector<index_record> block;
+        block.reserve(write_block_records);
+        hsize_t offset = 0;
+        while(success && !heads.empty())
+        {
+            head next = heads.top();
+            heads.pop();
+            block.push_back(next.first);
+
+            index_record record;
+            if(fread(&record,
+                     sizeof(index_record),
+                     1,
+                     sorter.runs[next.second]) == 1)
+            {
+                heads.push(make_pair(record, next.second));
+            }
+
+            if(block.size() == write_block_records || heads.empty())
+            {
+                success = write_index_records(dataset,
+                                              space,
+                                              type,
+                                              offset,
+                                              block);
+                offset += block.size();
+                block.clear();
+            }
+        }
+        success = success && offset == sorter.n_records;
+    }
+
+    if(H5Dclose(dataset) < 0)
+    {
+        success = false;
+    }
+    H5Sclose(space);
+    H5Tclose(type);
+
+    if(!success && verbose)
+    {
+        cerr << "ERROR: Unable to write index dataset \"" << name << "\""
+             << endl;
+    }
+
+    return success;
+}
+
+
+bool root2hdf5::tree::index::write_tree_index(TTreeIndex *tree_index,
+                                              const vector<string> & columns,
+                                              hid_t parent_destination,
+                                              const string & name)
+{
+    // Create the dataset
+    hsize_t n_records = tree_index->GetN();
+    hid_t type = create_index_type(columns);
+    hid_t dataset = -1, space = -1;
+    if(type < 0
+       || !create_index_dataset(parent_destination,
+                                name,
+                                type,
+                                n_records,
+                                dataset,
+                                space))
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Unable to create index dataset \"" << name << "\""
+                 << endl;
+        }
+
+        if(type >= 0)
+        {
+            H5Tclose(type);
+        }
+
+        return false;
+    }
+
+    // The TTreeIndex arrays are already sorted by (major, minor), so just
+    // copy them over a block at a time
+    const Long64_t *major = tree_index->GetIndexValues();
+    const Long64_t *minor = tree_index->GetIndexValuesMinor();
+    const Long64_t *entries = tree_index->GetIndex();
+    bool success = true;
+    vector<index_record> block;
+    for(hsize_t offset = 0; success && offset < n_records;)
+    {
+        hsize_t count = min((hsize_t)write_block_records, n_records - offset);
+        block.assign(count, index_record());
+        for(hsize_t i = 0; i < count; i++)
+        {
+            block[i].keys[0] = major[offset + i];
+            block[i].keys[1] = columns.size() > 1 ? minor[offset + i] : 0;
+            block[i].entry = entries[offset + i];
+        }
+
+        success = write_index_records(dataset, space, type, offset, block);
+        offset += count;
+    }
+
+    if(H5Dclose(dataset) < 0)
+    {
+        success = false;
+    }
+    H5Sclose(space);
+    H5Tclose(type);
+
+    if(!success && verbose)
+    {
+        cerr << "ERROR: Unable to write index dataset \"" << name << "\""
+             << endl;
+    }
+
+    return success;
+}
+
+
+boost::tuple<bool, index_collector, root_finalizer>
+root2hdf5::tree::index::build_index(TTree *tree,
+                                    const vector<string> & columns,
+                                    size_t memory_limit,
+                                    bool reuse_tree_index)
+{
+    string name = index_dataset_name(tree);
+
+    // Validate the columns
+    if(columns.empty() || columns.size() > max_index_columns)
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: An index needs between 1 and " << max_index_columns
+                 << " columns" << endl;
+        }
+
+        return boost::make_tuple(false, index_collector(), root_finalizer());
+    }
+
+    // If the tree has a TTreeIndex over the same columns, reuse it
+    TTreeIndex *tree_index = dynamic_cast<TTreeIndex *>(tree->GetTreeIndex());
+    if(reuse_tree_index
+       && tree_index != NULL
+       && columns.size() <= 2
+       && columns[0] == tree_index->GetMajorName()
+       && (columns.size() == 2
+           ? columns[1] == tree_index->GetMinorName()
+           : string(tree_index->GetMinorName()) == "0"))
+    {
+        if(verbose)
+        {
+            cout << "Reusing TTreeIndex of tree \"" << tree->GetName() << "\""
+                 << endl;
+        }
+
+        return boost::make_tuple(
+            true,
+            [](Long64_t entry) -> bool {
+                // Silence unused variable warnings
+                (void)entry;
+
+                return true;
+            },
+            [=](hid_t parent_destination) -> bool {
+                return write_tree_index(tree_index,
+                                        columns,
+                                        parent_destination,
+                                        name);
+            }
+        );
+    }
+
+    // Otherwise, find the key leaves
+    std::shared_ptr<index_sorter> sorter(new index_sorter());
+    for(auto it = columns.begin(); it != columns.end(); it++)
+    {
+        TLeaf *leaf = tree->GetLeaf(it->c_str());
+        if(leaf == NULL)
+        {
+            // Files often hold other trees alongside the indexed one, so
+            // just leave those unindexed
+            if(verbose)
+            {
+                cerr << "WARNING: Index column \"" << *it << "\" is not a leaf "
+                     << "of tree \"" << tree->GetName() << "\" - not indexing"
+                     << endl;
+            }
+
+            return boost::make_tuple(
+                true,
+                [](Long64_t entry) -> bool {
+                    // Silence unused variable warnings
+                    (void)entry;
+
+                    return true;
+                },
+                [](hid_t parent_destination) -> bool {
+                    // Silence unused variable warnings
+                    (void)parent_destination;
+
+                    return true;
+                }
+            );
+        }
+        sorter->leaves.push_back(leaf);
+    }
+    sorter->records_per_run = max(memory_limit / sizeof(index_record),
+                                  (size_t)1);
+    sorter->records.reserve(min(sorter->records_per_run,
+                                (size_t)tree->GetEntries()));
+    sorter->n_records = 0;
+
+    return boost::make_tuple(
+        true,
+        [=](Long64_t entry) -> bool {
+            index_record record = index_record();
+            for(size_t i = 0; i < sorter->leaves.size(); i++)
+            {
+                record.keys[i] = sorter->leaves[i]->GetValueLong64();
+            }
+            record.entry = entry;
+            sorter->records.push_back(record);
+            sorter->n_records++;
+
+            if(sorter->records.size() == sorter->records_per_run
+               && !spill_run(*sorter))
+            {
+                if(verbose)
+                {
+                    cerr << "ERROR: Unable to spill index run to disk" << endl;
+                }
+
+                return false;
+            }
+
+            return true;
+        },
+        [=](hid_t parent_destination) -> bool {
+            return write_sorted_index(*sorter,
+                                      columns,
+                                      parent_destination,
+                                      name);
+        }
+    );
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+// Standard includes
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+// HACK: Use Boost.Tuple instead of std::tuple because at the moment, the LLVM-
+// provided libc++ doesn't support the std::tuple, and Boost.Tuple is
+// effectively the same thing.
+// Boost includes
+#include <boost/tuple/tuple.hpp>
+
+// ROOT includes
+#include <TTree.h>
+
+// HDF5 includes
+#include <hdf5.h>
+
+// root2hdf5 includes
+#include "tree/map_root.h"
+
+
+namespace root2hdf5
+{
+    namespace tree
+    {
+        namespace index
+        {
+            // The maximum number of key columns in an index
+            const unsigned max_index_columns = 4;
+
+            // By default, this many bytes of index records are sorted in
+            // memory before a sorted run is spilled to a temporary file
+            const size_t default_index_memory_limit = 64 * 1024 * 1024;
+
+            // A single index record.  Unused keys are left as zero so that
+            // records can always be compared on every key.
+            struct index_record
+            {
+                Long64_t keys[max_index_columns];
+                Long64_t entry;
+            };
+
+            // Orders index records by their keys, then by entry
+            bool index_record_less(const index_record & a,
+                                   const index_record & b);
+
+            // Callback type for collecting the index keys of an entry.  It
+            // should be called after each converted entry has been loaded,
+            // with the number of the row it was written to in the tree's
+            // dataset (which is the entry number unless only some entries
+            // are converted).
+            typedef std::function<bool(Long64_t)> index_collector;
+
+            // Returns the index key columns given with --index, or an empty
+            // vector if no index was requested
+            std::vector<std::string> index_columns();
+
+            // Returns the name of the index dataset for a tree, which is
+            // written next to the tree's dataset, e.g. "events.index"
+            std::string index_dataset_name(TTree *tree);
+
+            // Sets up indexing of a tree by the specified leaves.  The index
+            // is written as a dataset of records with a 64-bit integer member
+            // for each key column and an "entry" member holding the row
+            // number, sorted by the keys.  If reuse_tree_index is true and
+            // the tree already has a TTreeIndex over the same columns, its
+            // sorted values are written directly and the collector does
+            // nothing.  Otherwise, the collector reads the key leaves for each
+            // entry, and sorted runs of at most memory_limit bytes are spilled
+            // to temporary files and merged by the finalizer.  This method
+            // returns a tuple of the form:
+            //      (success, collector, finalizer)
+            boost::tuple<bool, index_collector, map_root::root_finalizer>
+            build_index(TTree *tree,
+                        const std::vector<std::string> & columns,
+                        size_t memory_limit = default_index_memory_limit,
+                        bool reuse_tree_index = true);
+        }
+    }
+}
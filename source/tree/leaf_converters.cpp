@@ -1,11 +1,19 @@
 #include "leaf_converters.h"
 
 // Standard includes
+#include <list>
 #include <vector>
 
+// ROOT includes
+#include <TROOT.h>
+
 // root2hdf5 includes
 #include "tree/leaf_converters/scalar_converter.h"
+#include "tree/leaf_converters/array_converter.h"
+#include "tree/leaf_converters/counted_array_converter.h"
 #include "tree/leaf_converters/vector_converter.h"
+#include "tree/leaf_converters/string_converter.h"
+#include "tree/leaf_converters/string_dictionary_converter.h"
 
 
 // Standard namespaces
@@ -26,28 +34,116 @@ namespace root2hdf5
             {
                 // Scalar converter
                 {
+                    "scalar",
                     scalar_converter::can_handle,
                     scalar_converter::member_for_conversion_struct,
                     scalar_converter::hdf5_type_for_leaf,
-                    scalar_converter::map_leaf_and_build_converter
+                    scalar_converter::map_leaf_and_build_converter,
+                    scalar_converter::can_bulk_read
+                },
+
+                // Fixed-size array converter
+                {
+                    "array",
+                    array_converter::can_handle,
+                    array_converter::member_for_conversion_struct,
+                    array_converter::hdf5_type_for_leaf,
+                    array_converter::map_leaf_and_build_converter,
+                    nullptr
+                },
+
+                // Counter-indexed variable-length array converter
+                {
+                    "counted_array",
+                    counted_array_converter::can_handle,
+                    counted_array_converter::member_for_conversion_struct,
+                    counted_array_converter::hdf5_type_for_leaf,
+                    counted_array_converter::map_leaf_and_build_converter,
+                    nullptr
                 },
 
                 // Vector converter
                 {
+                    "vector",
                     vector_converter::can_handle,
                     vector_converter::member_for_conversion_struct,
                     vector_converter::hdf5_type_for_leaf,
-                    vector_converter::map_leaf_and_build_converter
+                    vector_converter::map_leaf_and_build_converter,
+                    nullptr
+                },
+
+                // Dictionary encoded string converter
+                {
+                    "string_dictionary",
+                    string_dictionary_converter::can_handle,
+                    string_dictionary_converter::member_for_conversion_struct,
+                    string_dictionary_converter::hdf5_type_for_leaf,
+                    string_dictionary_converter::map_leaf_and_build_converter,
+                    nullptr
+                },
+
+                // Plain string converter
+                {
+                    "string",
+                    string_converter::can_handle,
+                    string_converter::member_for_conversion_struct,
+                    string_converter::hdf5_type_for_leaf,
+                    string_converter::map_leaf_and_build_converter,
+                    nullptr
                 }
             };
+
+            // Converters added with register_converter.  These live in a
+            // list so that the pointers handed out by find_converter stay
+            // valid as more are registered.
+            list<leaf_converter> _registered_converters;
         }
     }
 }
 
 
+string root2hdf5::tree::leaf_converters::variable_length_member_for_leaf(
+    TLeaf *leaf
+)
+{
+    // HACK: ROOT cannot easily include the HDF5 headers because CINT is a piece
+    // of junk.  Anyway, it seems the easiest way to add the data structures we
+    // need to ROOT is just to typedef them ourselves.  Of course, if HDF5
+    // changes the implementation of this struct, we are borked hard, but we can
+    // do some version checking in that case.  It isn't elegant, but it'll work.
+    static bool root_informed_of_hvl_t = false;
+    if(!root_informed_of_hvl_t)
+    {
+        gROOT->ProcessLine("typedef struct{size_t len;void *p;}hvl_t;");
+        root_informed_of_hvl_t = true;
+    }
+
+    return string("hvl_t ") + leaf->GetName() + ";";
+}
+
+
+void root2hdf5::tree::leaf_converters::register_converter(
+    const leaf_converter & converter
+)
+{
+    _registered_converters.push_back(converter);
+}
+
+
 leaf_converter * root2hdf5::tree::leaf_converters::find_converter(TLeaf *leaf)
 {
-    // Try to find a registered converter
+    // Registered converters take priority over the built-in ones
+    for(auto it = _registered_converters.begin();
+        it != _registered_converters.end();
+        it++)
+    {
+        if(it->can_handle(leaf))
+        {
+            return &(*it);
+        }
+    }
+
+    // Try to find a built-in converter
     for(auto it = _leaf_converters.begin();
         it != _leaf_converters.end();
         it++)
@@ -28,13 +28,19 @@ namespace root2hdf5
             // need for strict OO at the moment.
             struct leaf_converter
             {
+                // A short, human-readable name for the converter, used when
+                // reporting which converter was chosen for a leaf.
+                std::string name;
+
                 // This function should return true if this leaf converter can
                 // handle the leaf, false if not.
                 std::function<bool(TLeaf *)> can_handle;
 
                 // This function should return a string which can be included in
                 // the code of a parent struct and that HDF5 data can be written
-                // from and ROOT data written to.
+                // from and ROOT data written to.  The member must be plain data
+                // (no constructors or destructors), since conversion structs
+                // are allocated as zeroed memory.
                 std::function<std::string(TLeaf *)> 
                     member_for_conversion_struct;
 
@@ -52,19 +58,47 @@ namespace root2hdf5
                 // This function will map the specified TLeaf into the target
                 // address.  If necessary, the leaf converter may allocate an
                 // intermediate buffer along with a converter and deallocator
-                // callback which it will add to the provided lists.  Returns
-                // true on success, false on failure.
+                // callback which it will add to the provided lists.  Converters
+                // which need to write out extra data after the last entry may
+                // also add a finalizer callback.  Returns true on success,
+                // false on failure.
                 std::function<bool(
                     TLeaf *,
                     void *,
                     std::vector<root2hdf5::tree::map_root::root_converter> &,
+                    std::vector<root2hdf5::tree::map_root::root_finalizer> &,
                     std::vector<
                         root2hdf5::tree::map_root::root_resource_deallocator
                     > &
                 )> map_leaf_and_build_converter;
 
+                // This optional function should return true if the values of
+                // the leaf can be copied straight into its member from the
+                // deserialized baskets read with ROOT's bulk I/O API, rather
+                // than being read entry by entry.  This is not a hook for
+                // converting a batch of values: the bulk reader bypasses
+                // map_leaf_and_build_converter and copies (and byte-swaps)
+                // the values itself, so it is only valid for leaves whose
+                // member is a single plain scalar of the leaf's own type and
+                // size.  Converters which leave it empty are never read in
+                // bulk.
+                std::function<bool(TLeaf *)> can_bulk_read;
             };
 
+            // Returns a conversion struct member of HDF5's hvl_t type for the
+            // leaf, for use by converters which produce variable-length data,
+            // making sure that CINT knows about the hvl_t type first.
+            std::string variable_length_member_for_leaf(TLeaf *leaf);
+
+            // Registers an additional leaf converter, e.g. one loaded from a
+            // plugin.  Registered converters are tried before the built-in
+            // ones, in the order they were registered, so they can take over
+            // leaves the built-in converters would otherwise handle.  The
+            // converter's name ends up in the schema signature of every tree
+            // it handles, so it should be unique and change whenever the
+            // converter's output does.
+            void register_converter(const leaf_converter & converter);
+
             // Finds a leaf converter suitable for doing the leaf conversion.
             // If no conversion is found, this function returns NULL.  If a
             // non-null leaf-converter is returned, it will be a global
@@ -0,0 +1,158 @@
+#include "tree/leaf_converters/array_converter.h"
+
+// C Standard includes
+#include <cstdlib>
+
+// Standard includes
+#include <iostream>
+#include <sstream>
+
+// ROOT includes
+#include <TLeafC.h>
+
+// root2hdf5 includes
+#include "options.h"
+#include "type.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::leaf_converters;
+using namespace root2hdf5::tree::map_hdf5;
+using namespace root2hdf5::tree::map_root;
+using namespace root2hdf5::options;
+using namespace root2hdf5::type;
+
+
+vector<hsize_t> array_converter::static_dimensions_for_leaf(TLeaf *leaf)
+{
+    // Parse each "[N]" in the title, e.g. "cov[5][5]"
+    vector<hsize_t> dimensions;
+    hsize_t n_elements = 1;
+    string title = leaf->GetTitle();
+    size_t open = title.find('[');
+    while(open != string::npos)
+    {
+        size_t close = title.find(']', open);
+        if(close == string::npos)
+        {
+            break;
+        }
+
+        string dimension = title.substr(open + 1, close - open - 1);
+        char *end = NULL;
+        unsigned long size = strtoul(dimension.c_str(), &end, 10);
+        if(dimension.empty() || *end != '\0' || size == 0)
+        {
+            break;
+        }
+        dimensions.push_back(size);
+        n_elements *= size;
+
+        open = title.find('[', close);
+    }
+
+    // Make sure it agrees with what ROOT thinks the length is
+    if(dimensions.empty() || n_elements != (hsize_t)leaf->GetLenStatic())
+    {
+        dimensions.assign(1, leaf->GetLenStatic());
+    }
+
+    return dimensions;
+}
+
+
+bool array_converter::can_handle(TLeaf *leaf)
+{
+    // Handle fixed-size arrays of anything that is convertible to an HDF5
+    // scalar type.  Arrays whose length comes from another leaf and character
+    // strings are handled elsewhere.
+    return leaf->GetLenStatic() > 1
+           && leaf->GetLeafCount() == NULL
+           && !leaf->InheritsFrom(TLeafC::Class())
+           && root_type_name_to_scalar_hdf5_type(leaf->GetTypeName()) != -1;
+}
+
+
+string array_converter::member_for_conversion_struct(TLeaf *leaf)
+{
+    // Return an array member of the same type and shape as the ROOT leaf,
+    // e.g.:
+    //      typename leaf_name[5][5];
+    stringstream member;
+    member << leaf->GetTypeName() << " " << leaf->GetName();
+    vector<hsize_t> dimensions = static_dimensions_for_leaf(leaf);
+    for(auto it = dimensions.begin(); it != dimensions.end(); it++)
+    {
+        member << "[" << *it << "]";
+    }
+    member << ";";
+
+    return member.str();
+}
+
+
+hid_t array_converter::hdf5_type_for_leaf(
+    TLeaf * leaf, 
+    vector<hdf5_type_deallocator> & deallocators
+)
+{
+    // Create an array type with the same shape as the leaf
+    vector<hsize_t> dimensions = static_dimensions_for_leaf(leaf);
+    hid_t result = H5Tarray_create2(
+        root_type_name_to_scalar_hdf5_type(leaf->GetTypeName()),
+        dimensions.size(),
+        &dimensions[0]
+    );
+    if(result < 0)
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Unable to create array type for leaf \""
+                 << leaf->GetName() << "\"" << endl;
+        }
+
+        return -1;
+    }
+
+    // Generate a deallocator for it
+    deallocators.push_back([=]() -> bool {
+        if(H5Tclose(result) < 0)
+        {
+            if(verbose)
+            {
+                cerr << "ERROR: Unable to close array type for leaf \""
+                     << leaf->GetName() << "\"" << endl;
+            }
+
+            return false;
+        }
+
+        return true;
+    });
+
+    return result;
+}
+
+
+bool array_converter::map_leaf_and_build_converter(
+    TLeaf *leaf,
+    void *address,
+    vector<root_converter> & converters,
+    vector<root_finalizer> & finalizers,
+    vector<root_resource_deallocator> & deallocators
+)
+{
+    // Silence unused variable warnings
+    (void)converters;
+    (void)finalizers;
+    (void)deallocators;
+
+    // The struct member has exactly the leaf's layout, so ROOT can read the
+    // whole array straight into it without any intermediate conversion
+    leaf->SetAddress(address);
+
+    return true;
+}
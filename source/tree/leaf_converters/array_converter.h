@@ -0,0 +1,49 @@
+#pragma once
+
+// Standard includes
+#include <vector>
+
+// root2hdf5 includes
+#include "tree/leaf_converters.h"
+
+
+namespace root2hdf5
+{
+    namespace tree
+    {
+        namespace leaf_converters
+        {
+            namespace array_converter
+            {
+                // Returns the dimensions of a fixed-size array leaf, such as
+                // {16} for "x[16]/F" or {5, 5} for "cov[5][5]/D", parsed from
+                // the leaf title.  If the title can't be parsed consistently
+                // with the leaf's static length, the leaf is treated as a
+                // flat array of that length.
+                std::vector<hsize_t> static_dimensions_for_leaf(TLeaf *leaf);
+
+                bool can_handle(TLeaf *leaf);
+                std::string member_for_conversion_struct(TLeaf *leaf);
+                hid_t hdf5_type_for_leaf(
+                    TLeaf * leaf, 
+                    std::vector<
+                        root2hdf5::tree::map_hdf5::hdf5_type_deallocator
+                    > & deallocators
+                );
+                bool map_leaf_and_build_converter(
+                    TLeaf *leaf,
+                    void *address,
+                    std::vector<
+                        root2hdf5::tree::map_root::root_converter
+                    > & converters,
+                    std::vector<
+                        root2hdf5::tree::map_root::root_finalizer
+                    > & finalizers,
+                    std::vector<
+                        root2hdf5::tree::map_root::root_resource_deallocator
+                    > & deallocators
+                );
+            }
+        }
+    }
+}
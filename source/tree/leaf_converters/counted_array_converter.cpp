@@ -0,0 +1,158 @@
+#include "tree/leaf_converters/counted_array_converter.h"
+
+// Standard includes
+#include <iostream>
+
+// ROOT includes
+#include <TLeafC.h>
+
+// root2hdf5 includes
+#include "options.h"
+#include "type.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::leaf_converters;
+using namespace root2hdf5::tree::map_hdf5;
+using namespace root2hdf5::tree::map_root;
+using namespace root2hdf5::options;
+using namespace root2hdf5::type;
+
+
+bool counted_array_converter::can_handle(TLeaf *leaf)
+{
+    // Handle arrays whose length is given by another leaf in the same entry,
+    // e.g. "x[n]/F" or "p[n][3]/D", of anything that is convertible to an
+    // HDF5 scalar type.  Character strings are handled elsewhere.
+    return leaf->GetLeafCount() != NULL
+           && !leaf->InheritsFrom(TLeafC::Class())
+           && root_type_name_to_scalar_hdf5_type(leaf->GetTypeName()) != -1;
+}
+
+
+string counted_array_converter::member_for_conversion_struct(TLeaf *leaf)
+{
+    return variable_length_member_for_leaf(leaf);
+}
+
+
+hid_t counted_array_converter::hdf5_type_for_leaf(
+    TLeaf * leaf, 
+    vector<hdf5_type_deallocator> & deallocators
+)
+{
+    // Each element of the variable-length sequence is either a scalar or, for
+    // leaves like "p[n][3]/D", a fixed-size array of the trailing dimensions
+    hid_t scalar_type = root_type_name_to_scalar_hdf5_type(leaf->GetTypeName());
+    hid_t element_type = scalar_type;
+    if(leaf->GetLenStatic() > 1)
+    {
+        hsize_t element_length = leaf->GetLenStatic();
+        element_type = H5Tarray_create2(scalar_type, 1, &element_length);
+        if(element_type < 0)
+        {
+            if(verbose)
+            {
+                cerr << "ERROR: Unable to create element type for leaf \""
+                     << leaf->GetName() << "\"" << endl;
+            }
+
+            return -1;
+        }
+
+        deallocators.push_back([=]() -> bool {
+            if(H5Tclose(element_type) < 0)
+            {
+                if(verbose)
+                {
+                    cerr << "ERROR: Unable to close element type for leaf \""
+                         << leaf->GetName() << "\"" << endl;
+                }
+
+                return false;
+            }
+
+            return true;
+        });
+    }
+
+    // Wrap it in a variable-length type
+    hid_t result = H5Tvlen_create(element_type);
+    if(result < 0)
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Unable to create variable length type for leaf \""
+                 << leaf->GetName() << "\"" << endl;
+        }
+
+        return -1;
+    }
+
+    // Generate a deallocator for it
+    deallocators.push_back([=]() -> bool {
+        if(H5Tclose(result) < 0)
+        {
+            if(verbose)
+            {
+                cerr << "ERROR: Unable to close variable length type for leaf "
+                     << "\"" << leaf->GetName() << "\"" << endl;
+            }
+
+            return false;
+        }
+
+        return true;
+    });
+
+    return result;
+}
+
+
+bool counted_array_converter::map_leaf_and_build_converter(
+    TLeaf *leaf,
+    void *address,
+    vector<root_converter> & converters,
+    vector<root_finalizer> & finalizers,
+    vector<root_resource_deallocator> & deallocators
+)
+{
+    // Silence unused variable warnings
+    (void)finalizers;
+
+    // ROOT records the largest value the counter leaf ever held while the tree
+    // was filled, so we can allocate a single buffer up front which is large
+    // enough for every entry, rather than growing one as we go.  ROOT reads
+    // the counter before the array in each entry, and TLeaf::GetLen clamps the
+    // length to this same maximum, so the buffer can never overflow.
+    size_t element_size = H5Tget_size(
+        root_type_name_to_scalar_hdf5_type(leaf->GetTypeName())
+    );
+    size_t element_length = leaf->GetLenStatic();
+    Int_t maximum_count = leaf->GetLeafCount()->GetMaximum();
+    size_t capacity = (maximum_count > 0 ? maximum_count : 1) * element_length;
+    char *buffer = new char[capacity * element_size];
+    deallocators.push_back([=]() -> bool {
+        delete [] buffer;
+        return true;
+    });
+
+    // Set the leaf address to the buffer
+    leaf->SetAddress(buffer);
+
+    // Build a converter which points the struct's hvl_t at the used prefix of
+    // the buffer.  The conversion loop copies variable-length data out of the
+    // row before the next entry is read, so we don't need to copy it here.
+    converters.push_back([=]() -> bool {
+        hvl_t *vl_member = (hvl_t *)address;
+        vl_member->len = leaf->GetLen() / element_length;
+        vl_member->p = vl_member->len > 0 ? buffer : NULL;
+
+        return true;
+    });
+
+    return true;
+}
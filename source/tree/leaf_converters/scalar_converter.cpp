@@ -1,5 +1,11 @@
 #include "tree/leaf_converters/scalar_converter.h"
 
+// ROOT includes
+#include <RVersion.h>
+#include <TBranch.h>
+#include <TLeafC.h>
+#include <TObjArray.h>
+
 // root2hdf5 includes
 #include "type.h"
 
@@ -16,8 +22,13 @@ using namespace root2hdf5::type;
 
 bool scalar_converter::can_handle(TLeaf *leaf)
 {
-    // Handle anything that is convertible to an HDF5 scalar type
-    return root_type_name_to_scalar_hdf5_type(leaf->GetTypeName()) != -1;
+    // Handle anything that is convertible to an HDF5 scalar type, as long as
+    // the leaf holds a single value (arrays and character strings are handled
+    // elsewhere)
+    return leaf->GetLenStatic() == 1
+           && leaf->GetLeafCount() == NULL
+           && !leaf->InheritsFrom(TLeafC::Class())
+           && root_type_name_to_scalar_hdf5_type(leaf->GetTypeName()) != -1;
 }
 
 string scalar_converter::member_for_conversion_struct(TLeaf *leaf)
@@ -44,11 +55,13 @@ bool scalar_converter::map_leaf_and_build_converter(
     TLeaf *leaf,
     void *address,
     vector<root_converter> & converters,
+    vector<root_finalizer> & finalizers,
     vector<root_resource_deallocator> & deallocators
 )
 {
     // Silence unused variable warnings
     (void)converters;
+    (void)finalizers;
     (void)deallocators;
 
     // Do the simple mapping
@@ -56,3 +69,21 @@ bool scalar_converter::map_leaf_and_build_converter(
 
     return true;
 }
+
+bool scalar_converter::can_bulk_read(TLeaf *leaf)
+{
+    // Scalars are mapped straight into the struct, so their values can be
+    // taken straight from the baskets as long as the branch holds nothing
+    // else and ROOT can read it in bulk
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 14, 0)
+    TBranch *branch = leaf->GetBranch();
+    return branch->GetListOfLeaves()->GetEntries() == 1
+           && branch->GetListOfBranches()->GetEntries() == 0
+           && branch->SupportsBulkRead();
+#else
+    // Silence unused variable warnings
+    (void)leaf;
+
+    return false;
+#endif
+}
@@ -26,10 +26,14 @@ namespace root2hdf5
                     std::vector<
                         root2hdf5::tree::map_root::root_converter
                     > & converters,
+                    std::vector<
+                        root2hdf5::tree::map_root::root_finalizer
+                    > & finalizers,
                     std::vector<
                         root2hdf5::tree::map_root::root_resource_deallocator
                     > & deallocators
                 );
+                bool can_bulk_read(TLeaf *leaf);
             }
         }
     }
@@ -0,0 +1,388 @@
+#include "tree/leaf_converters/string_converter.h"
+
+// Standard includes
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_set>
+
+// ROOT includes
+#include <TBranch.h>
+#include <TDirectory.h>
+#include <TLeafC.h>
+#include <TObjArray.h>
+#include <TTree.h>
+
+// root2hdf5 includes
+#include "options.h"
+#include "tree/walk.h"
+#include "tree/leaf_converters/vector_converter.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::leaf_converters::string_converter;
+using namespace root2hdf5::tree::leaf_converters;
+using namespace root2hdf5::tree::map_hdf5;
+using namespace root2hdf5::tree::map_root;
+using namespace root2hdf5::tree::walk;
+using namespace root2hdf5::options;
+
+
+// Private namespace members
+namespace root2hdf5
+{
+    namespace tree
+    {
+        namespace leaf_converters
+        {
+            namespace string_converter
+            {
+                // The number of entries sampled when deciding whether or not
+                // to dictionary encode a leaf
+                const Long64_t dictionary_sample_entries = 1000;
+
+                // Leaves with a larger fraction of unique values than this in
+                // the sample are stored as plain strings
+                const double dictionary_maximum_unique_fraction = 0.5;
+
+                // Dictionary encoding decisions, keyed by leaf_key
+                map<string, bool> _dictionary_decisions;
+
+                // Returns a key identifying a leaf in a particular tree in a
+                // particular file, since TLeaf pointers may be reused once a
+                // tree is deleted
+                string leaf_key(TLeaf *leaf);
+
+                // Samples the values of a string leaf and records whether or
+                // not to dictionary encode it
+                void choose_encoding(TLeaf *leaf);
+            }
+        }
+    }
+}
+
+
+string_leaf_kind string_converter::kind_of_string_leaf(TLeaf *leaf)
+{
+    string type_name = leaf->GetTypeName();
+    if(leaf->InheritsFrom(TLeafC::Class()))
+    {
+        return c_string_leaf;
+    }
+    else if(type_name == "string")
+    {
+        return std_string_leaf;
+    }
+    else if(type_name == "vector<string>")
+    {
+        return string_vector_leaf;
+    }
+
+    return not_a_string_leaf;
+}
+
+
+void * string_converter::map_string_leaf(
+    TLeaf *leaf,
+    vector<root_resource_deallocator> & deallocators
+)
+{
+    void *buffer = NULL;
+    string_leaf_kind kind = kind_of_string_leaf(leaf);
+    if(kind == c_string_leaf)
+    {
+        // ROOT tracks the longest string written to the leaf (including its
+        // terminator) and truncates anything longer when reading, so this is
+        // always large enough
+        Int_t capacity = max(leaf->GetLenStatic(), leaf->GetMaximum()) + 1;
+        buffer = new char[capacity];
+        ((char *)buffer)[0] = '\0';
+    }
+    else if(kind == std_string_leaf)
+    {
+        buffer = new string();
+    }
+    else
+    {
+        vector_converter::require_dictionary(leaf->GetTypeName());
+        buffer = new vector<string>();
+    }
+
+    // Set the leaf address to the buffer, and make sure ROOT forgets about it
+    // before it is freed.  The whole branch is only reset if the leaf is all
+    // there is to it, since resetting a leaflist branch would also clear the
+    // addresses of the leaf's siblings.
+    leaf->SetAddress(buffer);
+    deallocators.push_back([=]() -> bool {
+        leaf->SetAddress(NULL);
+        if(leaf->GetBranch()->GetListOfLeaves()->GetEntries() == 1)
+        {
+            leaf->GetBranch()->ResetAddress();
+        }
+        if(kind == c_string_leaf)
+        {
+            delete [] (char *)buffer;
+        }
+        else if(kind == std_string_leaf)
+        {
+            delete (string *)buffer;
+        }
+        else
+        {
+            delete (vector<string> *)buffer;
+        }
+
+        return true;
+    });
+
+    return buffer;
+}
+
+
+void string_converter::strings_in_buffer(string_leaf_kind kind,
+                                         const void *buffer,
+                                         vector<const char *> & strings)
+{
+    strings.clear();
+    if(kind == c_string_leaf)
+    {
+        strings.push_back((const char *)buffer);
+    }
+    else if(kind == std_string_leaf)
+    {
+        strings.push_back(((const string *)buffer)->c_str());
+    }
+    else
+    {
+        const vector<string> *values = (const vector<string> *)buffer;
+        for(auto it = values->begin(); it != values->end(); it++)
+        {
+            strings.push_back(it->c_str());
+        }
+    }
+}
+
+
+string string_converter::leaf_key(TLeaf *leaf)
+{
+    TBranch *branch = leaf->GetBranch();
+    TTree *tree = branch->GetTree();
+    string key = tree->GetDirectory() != NULL
+                 ? tree->GetDirectory()->GetPath()
+                 : "";
+    return key + "/" + tree->GetName() + "/" + branch->GetName() + "/"
+           + leaf->GetName();
+}
+
+
+void string_converter::choose_encoding(TLeaf *leaf)
+{
+    // Check if we've already decided
+    string key = leaf_key(leaf);
+    if(_dictionary_decisions.count(key))
+    {
+        return;
+    }
+
+    // Read a sample of the leaf's values into a temporary buffer, counting
+    // the unique ones.  The buffer is unmapped again before conversion maps
+    // the leaf for real.
+    TBranch *branch = leaf->GetBranch();
+    Long64_t n_sampled = min(branch->GetEntries(), dictionary_sample_entries);
+    string_leaf_kind kind = kind_of_string_leaf(leaf);
+    vector<root_resource_deallocator> deallocators;
+    void *buffer = map_string_leaf(leaf, deallocators);
+    unordered_set<string> unique_values;
+    vector<const char *> strings;
+    Long64_t n_values = 0;
+    for(Long64_t i = 0; i < n_sampled; i++)
+    {
+        if(branch->GetEntry(i) < 0)
+        {
+            break;
+        }
+        strings_in_buffer(kind, buffer, strings);
+        unique_values.insert(strings.begin(), strings.end());
+        n_values += strings.size();
+    }
+    for(auto it = deallocators.rbegin(); it != deallocators.rend(); it++)
+    {
+        (*it)();
+    }
+
+    // Decide
+    bool result = n_values == 0
+                  || ((double)unique_values.size() / n_values
+                      <= dictionary_maximum_unique_fraction);
+    if(verbose)
+    {
+        cout << "Leaf \"" << leaf->GetName() << "\" has "
+             << unique_values.size() << " unique values in " << n_values
+             << " sampled - " << (result ? "using" : "not using")
+             << " dictionary encoding" << endl;
+    }
+    _dictionary_decisions[key] = result;
+}
+
+
+bool string_converter::choose_string_encodings(TTree *tree)
+{
+    return walk_tree(
+        tree,
+        [](TBranch *branch) -> bool {
+            // Hide unused variable warning
+            (void)branch;
+            return true;
+        },
+        [](TLeaf *leaf) -> bool {
+            if(kind_of_string_leaf(leaf) != not_a_string_leaf)
+            {
+                choose_encoding(leaf);
+            }
+            return true;
+        },
+        [](TBranch *branch) -> bool {
+            // Hide unused variable warning
+            (void)branch;
+            return true;
+        }
+    );
+}
+
+
+bool string_converter::uses_dictionary(TLeaf *leaf)
+{
+    auto existing = _dictionary_decisions.find(leaf_key(leaf));
+    return existing != _dictionary_decisions.end() && existing->second;
+}
+
+
+bool string_converter::can_handle(TLeaf *leaf)
+{
+    return kind_of_string_leaf(leaf) != not_a_string_leaf
+           && !uses_dictionary(leaf);
+}
+
+
+string string_converter::member_for_conversion_struct(TLeaf *leaf)
+{
+    // Scalar strings are stored by pointer, vectors of strings as an hvl_t of
+    // pointers
+    if(kind_of_string_leaf(leaf) == string_vector_leaf)
+    {
+        return variable_length_member_for_leaf(leaf);
+    }
+
+    return string("char *") + leaf->GetName() + ";";
+}
+
+
+hid_t string_converter::hdf5_type_for_leaf(
+    TLeaf * leaf, 
+    vector<hdf5_type_deallocator> & deallocators
+)
+{
+    // Create a variable-length string type
+    hid_t string_type = H5Tcopy(H5T_C_S1);
+    if(string_type < 0 || H5Tset_size(string_type, H5T_VARIABLE) < 0)
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Unable to create string type for leaf \""
+                 << leaf->GetName() << "\"" << endl;
+        }
+
+        return -1;
+    }
+    deallocators.push_back([=]() -> bool {
+        if(H5Tclose(string_type) < 0)
+        {
+            if(verbose)
+            {
+                cerr << "ERROR: Unable to close string type for leaf \""
+                     << leaf->GetName() << "\"" << endl;
+            }
+
+            return false;
+        }
+
+        return true;
+    });
+    if(kind_of_string_leaf(leaf) != string_vector_leaf)
+    {
+        return string_type;
+    }
+
+    // Wrap it for vectors
+    hid_t result = H5Tvlen_create(string_type);
+    if(result < 0)
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Unable to create variable length type for leaf \""
+                 << leaf->GetName() << "\"" << endl;
+        }
+
+        return -1;
+    }
+    deallocators.push_back([=]() -> bool {
+        if(H5Tclose(result) < 0)
+        {
+            if(verbose)
+            {
+                cerr << "ERROR: Unable to close variable length type for leaf "
+                     << "\"" << leaf->GetName() << "\"" << endl;
+            }
+
+            return false;
+        }
+
+        return true;
+    });
+
+    return result;
+}
+
+
+bool string_converter::map_leaf_and_build_converter(
+    TLeaf *leaf,
+    void *address,
+    vector<root_converter> & converters,
+    vector<root_finalizer> & finalizers,
+    vector<root_resource_deallocator> & deallocators
+)
+{
+    // Silence unused variable warnings
+    (void)finalizers;
+
+    // Map the leaf into an intermediate buffer
+    string_leaf_kind kind = kind_of_string_leaf(leaf);
+    void *buffer = map_string_leaf(leaf, deallocators);
+
+    // Build a converter which points the struct member at the strings in the
+    // buffer.  The conversion loop copies variable-length data out of the row
+    // before the next entry is read, so we don't need to copy it here.
+    shared_ptr<vector<const char *> > strings(new vector<const char *>());
+    converters.push_back([=]() -> bool {
+        strings_in_buffer(kind, buffer, *strings);
+        if(kind == string_vector_leaf)
+        {
+            hvl_t *vl_member = (hvl_t *)address;
+            vl_member->len = strings->size();
+            vl_member->p = strings->empty() ? NULL : &(*strings)[0];
+        }
+        else
+        {
+            *(const char **)address = (*strings)[0];
+        }
+
+        return true;
+    });
+
+    return true;
+}
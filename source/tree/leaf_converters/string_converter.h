@@ -0,0 +1,92 @@
+#pragma once
+
+// Standard includes
+#include <vector>
+
+// ROOT includes
+#include <TTree.h>
+
+// root2hdf5 includes
+#include "tree/leaf_converters.h"
+
+
+namespace root2hdf5
+{
+    namespace tree
+    {
+        namespace leaf_converters
+        {
+            namespace string_converter
+            {
+                // The kinds of leaves which hold character strings
+                enum string_leaf_kind
+                {
+                    not_a_string_leaf,
+                    c_string_leaf,      // "name/C"
+                    std_string_leaf,    // std::string
+                    string_vector_leaf  // std::vector<std::string>
+                };
+
+                // Returns the kind of string leaf this is, if any
+                string_leaf_kind kind_of_string_leaf(TLeaf *leaf);
+
+                // Allocates a buffer of the right type for a string leaf, sets
+                // the leaf's address to it, and registers a deallocator for
+                // it.  Returns the buffer.
+                void * map_string_leaf(
+                    TLeaf *leaf,
+                    std::vector<
+                        root2hdf5::tree::map_root::root_resource_deallocator
+                    > & deallocators
+                );
+
+                // Collects pointers to each of the strings currently held in a
+                // buffer returned by map_string_leaf.  Scalar string leaves
+                // always produce exactly one string.  The pointers are only
+                // valid until the next entry is read.
+                void strings_in_buffer(string_leaf_kind kind,
+                                       const void *buffer,
+                                       std::vector<const char *> & strings);
+
+                // Decides whether each string leaf of the tree (and its
+                // friends) repeats its values often enough to be worth
+                // dictionary encoding.  This is judged from the fraction of
+                // unique values in a sample of the first entries of the leaf,
+                // so it reads baskets, and must happen before the conversion
+                // struct is generated.  Decisions are remembered per leaf so
+                // that the struct, HDF5 type and mapping all agree.  Returns
+                // true on success, false on failure.
+                bool choose_string_encodings(TTree *tree);
+
+                // Returns true if choose_string_encodings decided to
+                // dictionary encode the leaf.  Leaves without a decision are
+                // stored as plain strings.  This never reads any baskets.
+                bool uses_dictionary(TLeaf *leaf);
+
+                // Handles string leaves which aren't dictionary encoded by
+                // storing them as HDF5 variable-length strings
+                bool can_handle(TLeaf *leaf);
+                std::string member_for_conversion_struct(TLeaf *leaf);
+                hid_t hdf5_type_for_leaf(
+                    TLeaf * leaf, 
+                    std::vector<
+                        root2hdf5::tree::map_hdf5::hdf5_type_deallocator
+                    > & deallocators
+                );
+                bool map_leaf_and_build_converter(
+                    TLeaf *leaf,
+                    void *address,
+                    std::vector<
+                        root2hdf5::tree::map_root::root_converter
+                    > & converters,
+                    std::vector<
+                        root2hdf5::tree::map_root::root_finalizer
+                    > & finalizers,
+                    std::vector<
+                        root2hdf5::tree::map_root::root_resource_deallocator
+                    > & deallocators
+                );
+            }
+        }
+    }
+}
@@ -0,0 +1,252 @@
+#include "tree/leaf_converters/string_dictionary_converter.h"
+
+// Standard includes
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ROOT includes
+#include <TBranch.h>
+#include <TTree.h>
+
+// root2hdf5 includes
+#include "options.h"
+#include "tree/leaf_converters/string_converter.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::leaf_converters;
+using namespace root2hdf5::tree::leaf_converters::string_converter;
+using namespace root2hdf5::tree::map_hdf5;
+using namespace root2hdf5::tree::map_root;
+using namespace root2hdf5::options;
+
+
+// Private namespace members
+namespace root2hdf5
+{
+    namespace tree
+    {
+        namespace leaf_converters
+        {
+            namespace string_dictionary_converter
+            {
+                // The state of the encoding of a single leaf.  The hash table
+                // is built incrementally as values are seen, and codes are
+                // assigned in order of first appearance, so the code of a
+                // value is its index in the dictionary dataset.
+                struct dictionary
+                {
+                    unordered_map<string, Int_t> codes;
+                    vector<const string *> values;
+                    vector<Int_t> row_codes;
+                };
+
+                // Returns the code for a value, adding it if necessary
+                Int_t encode(dictionary & dictionary, const char *value);
+
+                // Writes the unique values of a dictionary to a new dataset
+                bool write_dictionary(const dictionary & dictionary,
+                                      hid_t parent_destination,
+                                      const string & name);
+            }
+        }
+    }
+}
+
+
+string string_dictionary_converter::dictionary_dataset_name(TLeaf *leaf)
+{
+    // Qualify the leaf with its branch if they differ
+    TBranch *branch = leaf->GetBranch();
+    string name = string(branch->GetTree()->GetName()) + ".";
+    if(string(branch->GetName()) != leaf->GetName())
+    {
+        name += string(branch->GetName()) + ".";
+    }
+
+    return name + leaf->GetName() + ".dictionary";
+}
+
+
+Int_t string_dictionary_converter::encode(dictionary & dictionary,
+                                          const char *value)
+{
+    auto inserted = dictionary.codes.insert(
+        make_pair(string(value), (Int_t)dictionary.values.size())
+    );
+    if(inserted.second)
+    {
+        // Element pointers of an unordered_map are stable across rehashes
+        dictionary.values.push_back(&inserted.first->first);
+    }
+
+    return inserted.first->second;
+}
+
+
+bool string_dictionary_converter::write_dictionary(
+    const dictionary & dictionary,
+    hid_t parent_destination,
+    const string & name
+)
+{
+    // Gather the values in code order
+    vector<const char *> values;
+    values.reserve(dictionary.values.size());
+    for(auto it = dictionary.values.begin();
+        it != dictionary.values.end();
+        it++)
+    {
+        values.push_back((*it)->c_str());
+    }
+
+    // Write them as variable-length strings
+    hsize_t n_values = values.size();
+    hid_t string_type = H5Tcopy(H5T_C_S1);
+    H5Tset_size(string_type, H5T_VARIABLE);
+    hid_t space = H5Screate_simple(1, &n_values, NULL);
+    hid_t dataset = H5Dcreate2(parent_destination,
+                               name.c_str(),
+                               string_type,
+                               space,
+                               H5P_DEFAULT,
+                               H5P_DEFAULT,
+                               H5P_DEFAULT);
+    bool success = dataset >= 0
+                   && (n_values == 0
+                       || H5Dwrite(dataset,
+                                   string_type,
+                                   H5S_ALL,
+                                   H5S_ALL,
+                                   H5P_DEFAULT,
+                                   &values[0]) >= 0);
+    if(dataset >= 0 && H5Dclose(dataset) < 0)
+    {
+        success = false;
+    }
+    H5Sclose(space);
+    H5Tclose(string_type);
+
+    if(!success && verbose)
+    {
+        cerr << "ERROR: Unable to write dictionary dataset \"" << name << "\""
+             << endl;
+    }
+
+    return success;
+}
+
+
+bool string_dictionary_converter::can_handle(TLeaf *leaf)
+{
+    return kind_of_string_leaf(leaf) != not_a_string_leaf
+           && uses_dictionary(leaf);
+}
+
+
+string string_dictionary_converter::member_for_conversion_struct(TLeaf *leaf)
+{
+    // Scalar strings become a single code, vectors of strings an hvl_t of
+    // codes
+    if(kind_of_string_leaf(leaf) == string_vector_leaf)
+    {
+        return variable_length_member_for_leaf(leaf);
+    }
+
+    return string("Int_t ") + leaf->GetName() + ";";
+}
+
+
+hid_t string_dictionary_converter::hdf5_type_for_leaf(
+    TLeaf * leaf, 
+    vector<hdf5_type_deallocator> & deallocators
+)
+{
+    if(kind_of_string_leaf(leaf) != string_vector_leaf)
+    {
+        return H5T_NATIVE_INT;
+    }
+
+    // Create a variable length type of codes for vectors
+    hid_t result = H5Tvlen_create(H5T_NATIVE_INT);
+    if(result < 0)
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Unable to create variable length type for leaf \""
+                 << leaf->GetName() << "\"" << endl;
+        }
+
+        return -1;
+    }
+    deallocators.push_back([=]() -> bool {
+        if(H5Tclose(result) < 0)
+        {
+            if(verbose)
+            {
+                cerr << "ERROR: Unable to close variable length type for leaf "
+                     << "\"" << leaf->GetName() << "\"" << endl;
+            }
+
+            return false;
+        }
+
+        return true;
+    });
+
+    return result;
+}
+
+
+bool string_dictionary_converter::map_leaf_and_build_converter(
+    TLeaf *leaf,
+    void *address,
+    vector<root_converter> & converters,
+    vector<root_finalizer> & finalizers,
+    vector<root_resource_deallocator> & deallocators
+)
+{
+    // Map the leaf into an intermediate buffer
+    string_leaf_kind kind = kind_of_string_leaf(leaf);
+    void *buffer = map_string_leaf(leaf, deallocators);
+
+    // Build a converter which encodes each entry's strings
+    shared_ptr<dictionary> leaf_dictionary(new dictionary());
+    shared_ptr<vector<const char *> > strings(new vector<const char *>());
+    converters.push_back([=]() -> bool {
+        strings_in_buffer(kind, buffer, *strings);
+        if(kind == string_vector_leaf)
+        {
+            vector<Int_t> & row_codes = leaf_dictionary->row_codes;
+            row_codes.resize(strings->size());
+            for(size_t i = 0; i < strings->size(); i++)
+            {
+                row_codes[i] = encode(*leaf_dictionary, (*strings)[i]);
+            }
+
+            hvl_t *vl_member = (hvl_t *)address;
+            vl_member->len = row_codes.size();
+            vl_member->p = row_codes.empty() ? NULL : &row_codes[0];
+        }
+        else
+        {
+            *(Int_t *)address = encode(*leaf_dictionary, (*strings)[0]);
+        }
+
+        return true;
+    });
+
+    // Build a finalizer which writes out the dictionary
+    string name = dictionary_dataset_name(leaf);
+    finalizers.push_back([=](hid_t parent_destination) -> bool {
+        return write_dictionary(*leaf_dictionary, parent_destination, name);
+    });
+
+    return true;
+}
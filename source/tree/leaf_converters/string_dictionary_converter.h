@@ -0,0 +1,44 @@
+#pragma once
+
+// root2hdf5 includes
+#include "tree/leaf_converters.h"
+
+
+namespace root2hdf5
+{
+    namespace tree
+    {
+        namespace leaf_converters
+        {
+            namespace string_dictionary_converter
+            {
+                // Returns the name of the dataset which holds the unique
+                // values of a dictionary encoded leaf, which is written next
+                // to the tree's dataset, e.g. "events.trigger.dictionary"
+                std::string dictionary_dataset_name(TLeaf *leaf);
+
+                bool can_handle(TLeaf *leaf);
+                std::string member_for_conversion_struct(TLeaf *leaf);
+                hid_t hdf5_type_for_leaf(
+                    TLeaf * leaf, 
+                    std::vector<
+                        root2hdf5::tree::map_hdf5::hdf5_type_deallocator
+                    > & deallocators
+                );
+                bool map_leaf_and_build_converter(
+                    TLeaf *leaf,
+                    void *address,
+                    std::vector<
+                        root2hdf5::tree::map_root::root_converter
+                    > & converters,
+                    std::vector<
+                        root2hdf5::tree::map_root::root_finalizer
+                    > & finalizers,
+                    std::vector<
+                        root2hdf5::tree::map_root::root_resource_deallocator
+                    > & deallocators
+                );
+            }
+        }
+    }
+}
@@ -14,6 +14,7 @@
 #include "options.h"
 #include "type.h"
 #include "cint.h"
+#include "dictionaries.h"
 
 
 // Standard namespaces
@@ -31,6 +32,7 @@ using namespace root2hdf5::tree::structure;
 using namespace root2hdf5::options;
 using namespace root2hdf5::type;
 using namespace root2hdf5::cint;
+using namespace root2hdf5::dictionaries;
 
 
 root_vector_conversion 
@@ -83,6 +85,27 @@ vector_converter::root_type_name_to_vector_hdf5_type(string type_name)
 }
 
 
+void vector_converter::require_dictionary(const string & type_name)
+{
+    if(!has_compiled_dictionary(type_name))
+    {
+        if(verbose)
+        {
+            cout << "Compiling dictionary for \"" << type_name << "\"" << endl;
+        }
+
+        process_long_line(
+            string("#include <vector>\n")
+            + "#include <string>\n"
+            + "#ifdef __CINT__\n"
+            + "#pragma link C++ class " + type_name + "+;\n"
+            + "#endif",
+            true
+        );
+    }
+}
+
+
 bool vector_converter::can_handle(TLeaf *leaf)
 {
     return root_type_name_to_vector_hdf5_type(leaf->GetTypeName()).valid;
@@ -91,19 +114,7 @@ bool vector_converter::can_handle(TLeaf *leaf)
 
 string vector_converter::member_for_conversion_struct(TLeaf *leaf)
 {
-    // HACK: ROOT cannot easily include the HDF5 headers because CINT is a piece
-    // of junk.  Anyway, it seems the easiest way to add the data structures we
-    // need to ROOT is just to typedef them ourselves.  Of course, if HDF5
-    // changes the implementation of this struct, we are borked hard, but we can
-    // do some version checking in that case.  It isn't elegant, but it'll work.
-    static bool root_informed_of_hvl_t = false;
-    if(!root_informed_of_hvl_t)
-    {
-        gROOT->ProcessLine("typedef struct{size_t len;void *p;}hvl_t;");
-        root_informed_of_hvl_t = true;
-    }
-
-    return string("hvl_t ") + leaf->GetName() + ";";
+    return variable_length_member_for_leaf(leaf);
 }
 
 
@@ -153,22 +164,19 @@ bool vector_converter::map_leaf_and_build_converter(
     TLeaf *leaf,
     void *address,
     vector<root_converter> & converters,
+    vector<root_finalizer> & finalizers,
     vector<root_resource_deallocator> & deallocators
 )
 {
+    // Silence unused variable warnings
+    (void)finalizers;
+
     // Generate a conversion
     root_vector_conversion conversion
         = root_type_name_to_vector_hdf5_type(leaf->GetTypeName());
 
-    // Have ROOT generate a dictionary for the branch type
-    // gInterpreter->GenerateDictionary(leaf->GetTypeName(), "vector");
-    process_long_line(
-        string("#include <vector>\n")
-        + "#ifdef __CINT__\n"
-        + "#pragma link C++ class " + leaf->GetTypeName()+ "+;\n"
-        + "#endif",
-        true
-    );
+    // Make sure ROOT has a dictionary for the branch type
+    require_dictionary(leaf->GetTypeName());
 
     // Allocate a buffer that we can use to load the vector into and add a
     // deallocator for it
@@ -38,6 +38,13 @@ namespace root2hdf5
                     std::string type_name
                 );
 
+                // Makes sure ROOT has a compiled dictionary for an STL vector
+                // type.  The common nested vector types are prebuilt into the
+                // root2hdf5_dictionaries library, so this only generates one
+                // at runtime (which needs a compiler and takes seconds) for
+                // anything more exotic.
+                void require_dictionary(const std::string & type_name);
+
                 bool can_handle(TLeaf *leaf);
                 std::string member_for_conversion_struct(TLeaf *leaf);
                 hid_t hdf5_type_for_leaf(
@@ -52,6 +59,9 @@ namespace root2hdf5
                     std::vector<
                         root2hdf5::tree::map_root::root_converter
                     > & converters,
+                    std::vector<
+                        root2hdf5::tree::map_root::root_finalizer
+                    > & finalizers,
                     std::vector<
                         root2hdf5::tree::map_root::root_resource_deallocator
                     > & deallocators
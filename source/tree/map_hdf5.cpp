@@ -41,8 +41,13 @@ root2hdf5::tree::map_hdf5::hdf5_type_for_tree(TTree *tree)
     // Compute the structure type name for the tree
     string hdf5_struct_name = struct_type_name_for_tree(tree);
 
-    // Grab the size for the struct
+    // Grab the size for the struct, bailing if CINT couldn't compute it (it
+    // will have already printed a message if necessary)
     size_t hdf5_struct_size = sizeof_type_by_name(hdf5_struct_name);
+    if(hdf5_struct_size == invalid_layout_value)
+    {
+        return boost::make_tuple(-1, []()->bool{return true;});
+    }
 
     // Create the HDF5 data type for the tree and create a deallocator for it
     hid_t result = H5Tcreate(H5T_COMPOUND, hdf5_struct_size);
@@ -97,16 +102,21 @@ root2hdf5::tree::map_hdf5::hdf5_type_for_tree(TTree *tree)
             string branch_path_in_struct = join(path_stack, ".");
 
             // Calculate the offset of this branch in the top-level HDF5 struct
-            path_offset_stack.push_back(offsetof_member_in_type_by_name(
+            // and its size there
+            size_t branch_offset_in_struct = offsetof_member_in_type_by_name(
                 hdf5_struct_name,
                 branch_path_in_struct
-            ));
-
-            // Calculate the size of this branch in the struct
+            );
             size_t branch_size_in_struct = sizeof_member_in_type_by_name(
                 hdf5_struct_name,
                 branch_path_in_struct
             );
+            if(branch_offset_in_struct == invalid_layout_value
+               || branch_size_in_struct == invalid_layout_value)
+            {
+                return false;
+            }
+            path_offset_stack.push_back(branch_offset_in_struct);
 
             // Create the new compound data type and push it onto the stack
             hid_t branch_type = H5Tcreate(
@@ -174,6 +184,10 @@ root2hdf5::tree::map_hdf5::hdf5_type_for_tree(TTree *tree)
                 hdf5_struct_name,
                 leaf_path_in_struct
             );
+            if(leaf_offset_in_struct == invalid_layout_value)
+            {
+                return false;
+            }
 
             // Calculate the offset of this branch relative to its parent
             size_t leaf_offset_in_parent
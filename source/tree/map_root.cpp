@@ -31,14 +31,16 @@ using namespace root2hdf5::tree::structure;
 using namespace root2hdf5::tree::leaf_converters;
 
 
-boost::tuple<bool, root_converter, root_resource_deallocator>
+boost::tuple<bool, root_converter, root_finalizer, root_resource_deallocator>
 root2hdf5::tree::map_root::map_root_tree_into_struct_and_build_converter(
     TTree *tree,
-    void *struct_instance
+    void *struct_instance,
+    root_converter_wrapper wrapper
 )
 {
-    // Create the deallocator and converter lists
+    // Create the deallocator, finalizer, and converter lists
     vector<root_converter> converters;
+    vector<root_finalizer> finalizers;
     vector<root_resource_deallocator> deallocators;
 
     // Compute the structure type name for the tree
@@ -62,9 +64,11 @@ root2hdf5::tree::map_root::map_root_tree_into_struct_and_build_converter(
         // Leaf process
         [&path_stack,
          &converters,
+         &finalizers,
          &deallocators,
          hdf5_struct_name,
-         struct_instance]
+         struct_instance,
+         wrapper]
         (TLeaf *leaf) -> bool {
             // First, find a leaf converter, and if we can't find one, just
             // ignore the leaf (a warning will have already been generated)
@@ -91,12 +95,26 @@ root2hdf5::tree::map_root::map_root_tree_into_struct_and_build_converter(
                 = (void *)(((char *)struct_instance) + leaf_offset_in_struct);
 
             // Set the address
-            return converter->map_leaf_and_build_converter(
-                leaf,
-                leaf_location,
-                converters,
-                deallocators
-            );
+            size_t n_converters = converters.size();
+            if(!converter->map_leaf_and_build_converter(leaf,
+                                                        leaf_location,
+                                                        converters,
+                                                        finalizers,
+                                                        deallocators))
+            {
+                return false;
+            }
+
+            // Wrap any converters the leaf registered
+            if(wrapper)
+            {
+                for(size_t i = n_converters; i < converters.size(); i++)
+                {
+                    converters[i] = wrapper(leaf, converters[i]);
+                }
+            }
+
+            return true;
         },
 
         // Branch close
@@ -137,6 +155,19 @@ root2hdf5::tree::map_root::map_root_tree_into_struct_and_build_converter(
 
             return true;
         },
+        [=](hid_t parent_destination) -> bool {
+            for(auto it = finalizers.begin();
+                it != finalizers.end();
+                it++)
+            {
+                if(!(*it)(parent_destination))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        },
         [=]() -> bool {
             // Iterate over deallocators in reverse so we close resources in the
             // opposite order of how we open them
@@ -10,8 +10,12 @@
 #include <boost/tuple/tuple.hpp>
 
 // ROOT includes
+#include <TLeaf.h>
 #include <TTree.h>
 
+// HDF5 includes
+#include <hdf5.h>
+
 
 namespace root2hdf5
 {
@@ -22,9 +26,20 @@ namespace root2hdf5
             // Callback type for executing ROOT converters
             typedef std::function<bool()> root_converter;
 
+            // Callback type for writing out anything a converter has
+            // accumulated over the whole tree (e.g. lookup tables) once all
+            // entries have been converted.  It receives the HDF5 location
+            // which holds the tree's dataset.
+            typedef std::function<bool(hid_t)> root_finalizer;
+
             // Callback type for deallocating ROOT conversion resources
             typedef std::function<bool()> root_resource_deallocator;
 
+            // Callback type for wrapping each converter registered for a leaf,
+            // e.g. to time it
+            typedef std::function<root_converter(TLeaf *, root_converter)>
+                root_converter_wrapper;
+
             // NOTE: Before calling this method, the
             // root2hdf5::structure::struct_code_for_tree method must have been
             // called to generate a CINT-known structure for mapping data into.
@@ -32,13 +47,21 @@ namespace root2hdf5
             // This function walks the leaves of a TTree, calling SetAddress on
             // each, mapping it either directly into the struct instance or
             // mapping it to some intermediate buffer and creating a converter
-            // and deallocator callback.  This method returns a tuple of the
-            // form:
-            //      (success, combined_converter, combined_deallocator)
-            boost::tuple<bool, root_converter, root_resource_deallocator>
+            // and deallocator callback.  If a wrapper is given, every
+            // converter is passed through it along with its leaf before being
+            // combined.  This method returns a tuple of the form:
+            //      (success,
+            //       combined_converter,
+            //       combined_finalizer,
+            //       combined_deallocator)
+            boost::tuple<bool,
+                         root_converter,
+                         root_finalizer,
+                         root_resource_deallocator>
             map_root_tree_into_struct_and_build_converter(
                 TTree *tree,
-                void *struct_instance
+                void *struct_instance,
+                root_converter_wrapper wrapper = root_converter_wrapper()
             );
         }
     }
@@ -0,0 +1,524 @@
+#include "tree/pack.h"
+
+// C Standard includes
+#include <cstring>
+#include <stdint.h>
+
+// Standard includes
+#include <algorithm>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+// root2hdf5 includes
+#include "options.h"
+#include "tree/booleans.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::pack;
+using namespace root2hdf5::options;
+using namespace root2hdf5::tree::split;
+using namespace root2hdf5::tree::booleans;
+
+
+// Private namespace members
+namespace root2hdf5
+{
+    namespace tree
+    {
+        namespace pack
+        {
+            // Adds the runs for each member of the packed type (other than
+            // the skipped one), matched by name to the memory type, with
+            // offsets relative to the given bases
+            bool add_member_runs(hid_t memory_type,
+                                 hid_t packed_type,
+                                 size_t source_base,
+                                 size_t destination_base,
+                                 const string & skipped_member,
+                                 vector<copy_run> & runs);
+
+            // Finds the offset of a member of a compound type by its path,
+            // with nested names separated by '.'
+            bool member_offset_by_path(hid_t type,
+                                       const string & path,
+                                       size_t & offset);
+
+            // The number of rows gathered at a time, which bounds the
+            // bitfield words built on the stack
+            const hsize_t block_rows = 256;
+
+            // Sets the bitfields of up to block_rows consecutive packed rows
+            // from the booleans of the padded rows
+            void pack_bits(const packed_layout & layout,
+                           const char *rows,
+                           hsize_t n_rows,
+                           char *destination);
+
+            // Stores the low bytes of a bitfield word, up to 8 of them
+            void store_bits(uint64_t word, size_t size, char *destination);
+
+            // Orders runs by their packed offset
+            bool destination_order(const copy_run & a, const copy_run & b);
+
+            // Copies a run whose size is known at compile time, which the
+            // compiler turns into plain (possibly vector) loads and stores
+            template<size_t Size>
+            inline void copy_fixed(const char *source, char *destination)
+            {
+                memcpy(destination, source, Size);
+            }
+        }
+    }
+}
+
+
+bool root2hdf5::tree::pack::add_member_runs(hid_t memory_type,
+                                            hid_t packed_type,
+                                            size_t source_base,
+                                            size_t destination_base,
+                                            const string & skipped_member,
+                                            vector<copy_run> & runs)
+{
+    int n_members = H5Tget_nmembers(packed_type);
+    if(n_members < 0)
+    {
+        return false;
+    }
+
+    for(unsigned i = 0; i < (unsigned)n_members; i++)
+    {
+        // Find the member in the memory type
+        char *name = H5Tget_member_name(packed_type, i);
+        if(name != NULL && !skipped_member.empty() && name == skipped_member)
+        {
+            H5free_memory(name);
+            continue;
+        }
+        int index = name != NULL ? H5Tget_member_index(memory_type, name) : -1;
+        H5free_memory(name);
+        if(index < 0)
+        {
+            return false;
+        }
+        size_t source_offset = source_base
+                               + H5Tget_member_offset(memory_type, index);
+        size_t destination_offset = destination_base
+                                    + H5Tget_member_offset(packed_type, i);
+
+        // Descend into nested compounds, and copy everything else whole
+        hid_t memory_member = H5Tget_member_type(memory_type, index);
+        hid_t packed_member = H5Tget_member_type(packed_type, i);
+        bool success = memory_member >= 0 && packed_member >= 0;
+        if(success
+           && H5Tget_class(memory_member) == H5T_COMPOUND
+           && H5Tget_class(packed_member) == H5T_COMPOUND)
+        {
+            success = add_member_runs(memory_member,
+                                      packed_member,
+                                      source_offset,
+                                      destination_offset,
+                                      string(),
+                                      runs);
+        }
+        else if(success
+                && H5Tget_size(memory_member) == H5Tget_size(packed_member))
+        {
+            copy_run run;
+            run.source_offset = source_offset;
+            run.destination_offset = destination_offset;
+            run.size = H5Tget_size(memory_member);
+            runs.push_back(run);
+        }
+        else
+        {
+            success = false;
+        }
+        if(memory_member >= 0)
+        {
+            H5Tclose(memory_member);
+        }
+        if(packed_member >= 0)
+        {
+            H5Tclose(packed_member);
+        }
+        if(!success)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+hid_t root2hdf5::tree::pack::packed_type(hid_t type)
+{
+    int n_members = H5Tget_nmembers(type);
+    if(n_members < 0)
+    {
+        return -1;
+    }
+
+    // Order the members by offset
+    vector<pair<size_t, unsigned> > order;
+    for(unsigned i = 0; i < (unsigned)n_members; i++)
+    {
+        order.push_back(make_pair(H5Tget_member_offset(type, i), i));
+    }
+    sort(order.begin(), order.end());
+
+    // Pack the member types, and add up their sizes
+    vector<hid_t> member_types;
+    size_t size = 0;
+    bool success = true;
+    for(auto it = order.begin(); success && it != order.end(); it++)
+    {
+        hid_t member_type = H5Tget_member_type(type, it->second);
+        if(member_type >= 0 && H5Tget_class(member_type) == H5T_COMPOUND)
+        {
+            hid_t packed_member = packed_type(member_type);
+            H5Tclose(member_type);
+            member_type = packed_member;
+        }
+        success = member_type >= 0;
+        if(success)
+        {
+            member_types.push_back(member_type);
+            size += H5Tget_size(member_type);
+        }
+    }
+
+    // Lay them out back to back
+    hid_t result = success && size > 0
+                   ? H5Tcreate(H5T_COMPOUND, size)
+                   : -1;
+    size_t offset = 0;
+    for(size_t i = 0; result >= 0 && i < member_types.size(); i++)
+    {
+        char *name = H5Tget_member_name(type, order[i].second);
+        if(name == NULL
+           || H5Tinsert(result, name, offset, member_types[i]) < 0)
+        {
+            H5Tclose(result);
+            result = -1;
+        }
+        H5free_memory(name);
+        offset += H5Tget_size(member_types[i]);
+    }
+    for(auto it = member_types.begin(); it != member_types.end(); it++)
+    {
+        H5Tclose(*it);
+    }
+
+    return result;
+}
+
+
+bool root2hdf5::tree::pack::destination_order(const copy_run & a,
+                                              const copy_run & b)
+{
+    return a.destination_offset < b.destination_offset;
+}
+
+
+bool root2hdf5::tree::pack::member_offset_by_path(hid_t type,
+                                                  const string & path,
+                                                  size_t & offset)
+{
+    size_t separator = path.find('.');
+    string name = path.substr(0, separator);
+    int index = H5Tget_class(type) == H5T_COMPOUND
+                ? H5Tget_member_index(type, name.c_str())
+                : -1;
+    if(index < 0)
+    {
+        return false;
+    }
+    offset += H5Tget_member_offset(type, index);
+    if(separator == string::npos)
+    {
+        return true;
+    }
+
+    hid_t member_type = H5Tget_member_type(type, index);
+    bool success = member_type >= 0
+                   && member_offset_by_path(member_type,
+                                            path.substr(separator + 1),
+                                            offset);
+    if(member_type >= 0)
+    {
+        H5Tclose(member_type);
+    }
+
+    return success;
+}
+
+
+bool root2hdf5::tree::pack::build_packed_layout(
+    hid_t memory_type,
+    hid_t packed_type,
+    packed_layout & layout,
+    const vector<string> & bit_paths,
+    const string & bits_member
+)
+{
+    layout.row_size = H5Tget_size(memory_type);
+    layout.packed_size = H5Tget_size(packed_type);
+    layout.runs.clear();
+    layout.bit_offsets.clear();
+    layout.bits_offset = 0;
+    layout.bits_size = 0;
+    layout.identity = false;
+
+    // Find the booleans and the bitfield they go in
+    bool success = layout.row_size > 0 && layout.packed_size > 0;
+    if(success && !bits_member.empty())
+    {
+        int index = H5Tget_member_index(packed_type, bits_member.c_str());
+        hid_t bits_type = index >= 0
+                          ? H5Tget_member_type(packed_type, index)
+                          : -1;
+        success = bits_type >= 0;
+        if(success)
+        {
+            layout.bits_offset = H5Tget_member_offset(packed_type, index);
+            layout.bits_size = H5Tget_size(bits_type);
+            H5Tclose(bits_type);
+        }
+        for(auto it = bit_paths.begin(); success && it != bit_paths.end(); it++)
+        {
+            size_t offset = 0;
+            success = member_offset_by_path(memory_type, *it, offset);
+            layout.bit_offsets.push_back(offset);
+        }
+        success = success && layout.bits_size * 8 >= bit_paths.size();
+    }
+
+    // Find the runs of every other member
+    vector<copy_run> runs;
+    if(!success
+       || !add_member_runs(memory_type,
+                           packed_type,
+                           0,
+                           0,
+                           bits_member,
+                           runs))
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Unable to compute packed layout of row type"
+                 << endl;
+        }
+
+        return false;
+    }
+
+    // Merge runs which are adjacent in both rows, so that stretches of
+    // unpadded members are copied in one go
+    sort(runs.begin(), runs.end(), destination_order);
+    for(auto it = runs.begin(); it != runs.end(); it++)
+    {
+        if(!layout.runs.empty())
+        {
+            copy_run & last = layout.runs.back();
+            if(last.source_offset + last.size == it->source_offset
+               && last.destination_offset + last.size
+                  == it->destination_offset)
+            {
+                last.size += it->size;
+                continue;
+            }
+        }
+        layout.runs.push_back(*it);
+    }
+
+    // Rows without padding need no gathering at all
+    layout.identity = layout.row_size == layout.packed_size
+                      && layout.bit_offsets.empty()
+                      && layout.runs.size() == 1
+                      && layout.runs[0].source_offset == 0
+                      && layout.runs[0].size == layout.row_size;
+
+    return true;
+}
+
+
+void root2hdf5::tree::pack::gather_rows(const packed_layout & layout,
+                                        const char *rows,
+                                        hsize_t n_rows,
+                                        char *destination)
+{
+    if(layout.identity)
+    {
+        memcpy(destination, rows, n_rows * layout.row_size);
+        return;
+    }
+
+    // Copy a block at a time, row by row, and then pack the block's
+    // booleans while its rows are still in cache.  Member-sized runs are the
+    // common case, and are dispatched to fixed size copies.
+    const copy_run *runs = layout.runs.empty() ? NULL : &layout.runs[0];
+    const size_t n_runs = layout.runs.size();
+    for(hsize_t r = 0; r < n_rows; r++)
+    {
+        const char *source = rows + r * layout.row_size;
+        char *packed = destination + r * layout.packed_size;
+        for(size_t i = 0; i < n_runs; i++)
+        {
+            const char *from = source + runs[i].source_offset;
+            char *to = packed + runs[i].destination_offset;
+            switch(runs[i].size)
+            {
+                case 1:
+                    copy_fixed<1>(from, to);
+                    break;
+                case 2:
+                    copy_fixed<2>(from, to);
+                    break;
+                case 4:
+                    copy_fixed<4>(from, to);
+                    break;
+                case 8:
+                    copy_fixed<8>(from, to);
+                    break;
+                case 16:
+                    copy_fixed<16>(from, to);
+                    break;
+                default:
+                    memcpy(to, from, runs[i].size);
+                    break;
+            }
+        }
+        if(!layout.bit_offsets.empty() && (r + 1) % block_rows == 0)
+        {
+            hsize_t first = r + 1 - block_rows;
+            pack_bits(layout,
+                      rows + first * layout.row_size,
+                      block_rows,
+                      destination + first * layout.packed_size);
+        }
+    }
+    hsize_t remainder = n_rows % block_rows;
+    if(!layout.bit_offsets.empty() && remainder > 0)
+    {
+        hsize_t first = n_rows - remainder;
+        pack_bits(layout,
+                  rows + first * layout.row_size,
+                  remainder,
+                  destination + first * layout.packed_size);
+    }
+}
+
+
+void root2hdf5::tree::pack::pack_bits(const packed_layout & layout,
+                                      const char *rows,
+                                      hsize_t n_rows,
+                                      char *destination)
+{
+    // Gather one boolean column at a time down the rows, OR-ing its bit into
+    // a word per row.  Iterations of the inner loop are independent, so it
+    // vectorizes, unlike building each row's word a bit at a time.
+    const size_t *offsets = &layout.bit_offsets[0];
+    const size_t n_bits = layout.bit_offsets.size();
+    const size_t row_size = layout.row_size;
+    const size_t word_size = min(layout.bits_size, sizeof(uint64_t));
+    uint64_t words[block_rows];
+    for(size_t first = 0; first < n_bits; first += 64)
+    {
+        size_t last = min(n_bits, first + 64);
+        fill(words, words + n_rows, (uint64_t)0);
+        for(size_t b = first; b < last; b++)
+        {
+            const char *column = rows + offsets[b];
+            const unsigned shift = (unsigned)(b - first);
+            for(hsize_t r = 0; r < n_rows; r++)
+            {
+                words[r] |= (uint64_t)(column[r * row_size] != 0) << shift;
+            }
+        }
+
+        // Store as much of each word as the bitfield holds
+        char *bits = destination + layout.bits_offset + first / 8;
+        for(hsize_t r = 0; r < n_rows; r++)
+        {
+            store_bits(words[r], word_size, bits + r * layout.packed_size);
+        }
+    }
+}
+
+
+void root2hdf5::tree::pack::store_bits(uint64_t word,
+                                       size_t size,
+                                       char *destination)
+{
+    switch(size)
+    {
+        case 1:
+        {
+            uint8_t value = (uint8_t)word;
+            memcpy(destination, &value, 1);
+            break;
+        }
+        case 2:
+        {
+            uint16_t value = (uint16_t)word;
+            memcpy(destination, &value, 2);
+            break;
+        }
+        case 4:
+        {
+            uint32_t value = (uint32_t)word;
+            memcpy(destination, &value, 4);
+            break;
+        }
+        default:
+            memcpy(destination, &word, 8);
+            break;
+    }
+}
+
+
+hid_t root2hdf5::tree::pack::file_type_for_column_group(
+    hid_t row_type,
+    const column_group & group,
+    const vector<string> & boolean_paths,
+    packed_layout & layout,
+    vector<string> & bit_paths
+)
+{
+    // Pack the group's members, and then its booleans
+    hid_t file_type = -1, memory_type = -1;
+    boost::tie(file_type, memory_type) = types_for_column_group(row_type,
+                                                                group);
+    hid_t result = -1;
+    if(file_type >= 0)
+    {
+        result = boolean_file_type(file_type, boolean_paths, bit_paths);
+        H5Tclose(file_type);
+    }
+
+    // Work out how to get the rows into it
+    if(result >= 0
+       && !build_packed_layout(memory_type,
+                               result,
+                               layout,
+                               bit_paths,
+                               bit_paths.empty()
+                               ? string()
+                               : string(bits_member_name)))
+    {
+        H5Tclose(result);
+        result = -1;
+    }
+    if(memory_type >= 0)
+    {
+        H5Tclose(memory_type);
+    }
+
+    return result;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+// Standard includes
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// HDF5 includes
+#include <hdf5.h>
+
+// root2hdf5 includes
+#include "tree/split.h"
+
+
+namespace root2hdf5
+{
+    namespace tree
+    {
+        namespace pack
+        {
+            // A contiguous run of bytes copied from each padded row into
+            // each packed row
+            struct copy_run
+            {
+                size_t source_offset;
+                size_t destination_offset;
+                size_t size;
+            };
+
+            // Describes how to gather the members of padded in-memory rows
+            // into rows of a packed type holding the same members
+            struct packed_layout
+            {
+                // The size of the padded and packed rows
+                size_t row_size;
+                size_t packed_size;
+
+                // The runs to copy, in packed order, with runs which are
+                // adjacent in both rows merged
+                std::vector<copy_run> runs;
+
+                // The one-byte booleans packed into the bitfield member, by
+                // their offset in the padded row and in bit order, along with
+                // the offset and size of the bitfield in the packed row
+                std::vector<size_t> bit_offsets;
+                size_t bits_offset;
+                size_t bits_size;
+
+                // Whether the packed rows are the padded rows verbatim, so
+                // that no gathering is needed
+                bool identity;
+            };
+
+            // Returns a copy of a compound type with its members laid out
+            // back to back in offset order, and likewise for any nested
+            // compound members.  Unlike H5Tpack, the element types of
+            // arrays and variable-length sequences are left alone, since
+            // their in-memory layout has to be kept.  Returns -1 on
+            // failure.  The caller should close the type with H5Tclose.
+            hid_t packed_type(hid_t type);
+
+            // Computes the layout for gathering rows of memory_type into
+            // rows of packed_type, which must hold (a subset of) the same
+            // members by name, e.g. as produced by packed_type.  Nested
+            // compound members are descended into, so their padding is
+            // dropped as well.  If a bits member is named, the members of
+            // memory_type at bit_paths (nested names separated by '.') are
+            // packed into that top-level member of packed_type, one bit
+            // each, rather than copied.  Returns false on failure.
+            bool build_packed_layout(
+                hid_t memory_type,
+                hid_t packed_type,
+                packed_layout & layout,
+                const std::vector<std::string> & bit_paths
+                    = std::vector<std::string>(),
+                const std::string & bits_member = std::string()
+            );
+
+            // Creates the file type for writing a column group from rows of
+            // the row type, along with the layout for packing rows into it.
+            // The group's members at boolean_paths are packed into a
+            // bitfield, and the paths of the packed ones are stored in
+            // bit_paths in bit order.  Returns -1 on failure.  The caller
+            // should close the type with H5Tclose.
+            hid_t file_type_for_column_group(
+                hid_t row_type,
+                const root2hdf5::tree::split::column_group & group,
+                const std::vector<std::string> & boolean_paths,
+                packed_layout & layout,
+                std::vector<std::string> & bit_paths
+            );
+
+            // Packs n_rows consecutive padded rows into the destination,
+            // which must have room for n_rows packed rows.  Variable-length
+            // members are copied as their in-memory descriptors, which HDF5
+            // still converts when they are written.  Booleans are set in the
+            // bitfield if they are non-zero.
+            void gather_rows(const packed_layout & layout,
+                             const char *rows,
+                             hsize_t n_rows,
+                             char *destination);
+        }
+    }
+}
@@ -0,0 +1,264 @@
+#include "tree/profile.h"
+
+// Standard includes
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+// ROOT includes
+#include <TFriendElement.h>
+
+// root2hdf5 includes
+#include "options.h"
+#include "tree/walk.h"
+#include "tree/map_hdf5.h"
+#include "tree/leaf_converters.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::profile;
+using namespace root2hdf5::tree::map_root;
+using namespace root2hdf5::tree::map_hdf5;
+using namespace root2hdf5::tree::walk;
+using namespace root2hdf5::tree::leaf_converters;
+
+
+// Private namespace members
+namespace root2hdf5
+{
+    namespace tree
+    {
+        namespace profile
+        {
+            typedef chrono::steady_clock profile_clock;
+
+            // Returns the total cost used to rank a branch
+            double total_seconds(const branch_profile & profile);
+
+            // Returns the profile of the top-level branch holding a leaf,
+            // adding it if it isn't known yet
+            branch_profile & profile_for_leaf(tree_profile & profile,
+                                              TLeaf *leaf);
+        }
+    }
+}
+
+
+bool root2hdf5::tree::profile::profiling_requested()
+{
+    return root2hdf5::options::options.count("profile-branches");
+}
+
+
+unsigned root2hdf5::tree::profile::profile_rows()
+{
+    if(!profiling_requested())
+    {
+        return 0;
+    }
+    return root2hdf5::options::options["profile-branches"].as<unsigned>();
+}
+
+
+double root2hdf5::tree::profile::total_seconds(const branch_profile & profile)
+{
+    return profile.read_seconds + profile.convert_seconds;
+}
+
+
+branch_profile &
+root2hdf5::tree::profile::profile_for_leaf(tree_profile & profile,
+                                           TLeaf *leaf)
+{
+    TBranch *branch = leaf->GetBranch()->GetMother();
+    auto existing = profile.positions.find(branch);
+    if(existing != profile.positions.end())
+    {
+        return profile.profiles[existing->second];
+    }
+
+    branch_profile result;
+    result.name = branch->GetName();
+    result.read_seconds = 0.0;
+    result.convert_seconds = 0.0;
+    result.bytes_read = 0;
+    result.zip_bytes = branch->GetZipBytes("*");
+    result.tot_bytes = branch->GetTotBytes("*");
+    result.row_bytes = 0;
+    profile.positions[branch] = profile.profiles.size();
+    profile.branches.push_back(branch);
+    profile.profiles.push_back(result);
+    return profile.profiles.back();
+}
+
+
+shared_ptr<tree_profile> root2hdf5::tree::profile::profile_tree(TTree *tree)
+{
+    shared_ptr<tree_profile> profile(new tree_profile);
+
+    // Walk the tree the same way conversion does, registering the branch of
+    // every leaf (even those without a converter, since they are still read)
+    // and sizing the output of those which are converted
+    bool success = walk_tree(
+        tree,
+        [](TBranch *branch) -> bool {
+            (void)branch;
+            return true;
+        },
+        [&profile](TLeaf *leaf) -> bool {
+            branch_profile & result = profile_for_leaf(*profile, leaf);
+            leaf_converter *converter = find_converter(leaf);
+            if(converter == NULL)
+            {
+                return true;
+            }
+
+            vector<hdf5_type_deallocator> deallocators;
+            hid_t type = converter->hdf5_type_for_leaf(leaf, deallocators);
+            if(type >= 0)
+            {
+                result.row_bytes += H5Tget_size(type);
+            }
+            for(auto it = deallocators.rbegin();
+                it != deallocators.rend();
+                it++)
+            {
+                if(!(*it)())
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        },
+        [](TBranch *branch) -> bool {
+            (void)branch;
+            return true;
+        }
+    );
+    if(!success && root2hdf5::options::verbose)
+    {
+        cerr << "WARNING: Unable to profile all branches of tree \""
+             << tree->GetName() << "\"" << endl;
+    }
+
+    return profile;
+}
+
+
+root_converter_wrapper
+root2hdf5::tree::profile::profiling_wrapper(shared_ptr<tree_profile> profile)
+{
+    return [profile](TLeaf *leaf, root_converter converter)
+        -> root_converter {
+        // Look the branch up now rather than on every call
+        size_t position = profile->positions.find(
+            leaf->GetBranch()->GetMother()
+        )->second;
+
+        return [profile, position, converter]() -> bool {
+            profile_clock::time_point start = profile_clock::now();
+            bool result = converter();
+            profile->profiles[position].convert_seconds
+                += chrono::duration<double>(
+                    profile_clock::now() - start
+                ).count();
+            return result;
+        };
+    };
+}
+
+
+Int_t root2hdf5::tree::profile::read_entry(tree_profile & profile,
+                                           TTree *tree,
+                                           Long64_t entry)
+{
+    // Loading the entry also loads the matching entries of any friends, so
+    // each branch can then be read at the entry its own tree is positioned at
+    if(tree->LoadTree(entry) < 0)
+    {
+        return -1;
+    }
+
+    Int_t n_bytes = 0;
+    for(size_t i = 0; i < profile.branches.size(); i++)
+    {
+        TBranch *branch = profile.branches[i];
+        profile_clock::time_point start = profile_clock::now();
+        Int_t n_branch_bytes
+            = branch->GetEntry(branch->GetTree()->GetReadEntry());
+        profile.profiles[i].read_seconds += chrono::duration<double>(
+            profile_clock::now() - start
+        ).count();
+        if(n_branch_bytes < 0)
+        {
+            return -1;
+        }
+        profile.profiles[i].bytes_read += n_branch_bytes;
+        n_bytes += n_branch_bytes;
+    }
+
+    return n_bytes;
+}
+
+
+vector<branch_profile> root2hdf5::tree::profile::most_expensive_branches(
+    const vector<branch_profile> & profiles,
+    unsigned n
+)
+{
+    vector<branch_profile> result(profiles);
+    stable_sort(result.begin(),
+                result.end(),
+                [](const branch_profile & a, const branch_profile & b) {
+                    return total_seconds(a) > total_seconds(b);
+                });
+    if(result.size() > n)
+    {
+        result.resize(n);
+    }
+
+    return result;
+}
+
+
+void root2hdf5::tree::profile::print_profile(TTree *tree,
+                                             const tree_profile & profile,
+                                             hsize_t n_rows)
+{
+    // Compute the totals for the percentage column
+    double total = 0.0;
+    for(auto it = profile.profiles.begin(); it != profile.profiles.end(); it++)
+    {
+        total += total_seconds(*it);
+    }
+
+    vector<branch_profile> expensive
+        = most_expensive_branches(profile.profiles, profile_rows());
+    cout << "profile of tree " << tree->GetName() << " (top "
+         << expensive.size() << " of " << profile.profiles.size()
+         << " branches, " << n_rows << " rows):" << endl
+         << "  " << setw(10) << "read s" << setw(10) << "convert s"
+         << setw(8) << "share" << setw(12) << "zip MB" << setw(12)
+         << "tot MB" << setw(12) << "read MB" << setw(12) << "output MB"
+         << "  branch" << endl;
+    for(auto it = expensive.begin(); it != expensive.end(); it++)
+    {
+        const double megabyte = 1024.0 * 1024.0;
+        cout << "  " << fixed << setprecision(3)
+             << setw(10) << it->read_seconds
+             << setw(10) << it->convert_seconds
+             << setprecision(1) << setw(7)
+             << (total > 0.0 ? 100.0 * total_seconds(*it) / total : 0.0)
+             << "%" << setprecision(2)
+             << setw(12) << it->zip_bytes / megabyte
+             << setw(12) << it->tot_bytes / megabyte
+             << setw(12) << it->bytes_read / megabyte
+             << setw(12) << (double)it->row_bytes * n_rows / megabyte
+             << "  " << it->name << endl;
+    }
+}
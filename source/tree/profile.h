@@ -0,0 +1,89 @@
+#pragma once
+
+// Standard includes
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ROOT includes
+#include <TBranch.h>
+#include <TLeaf.h>
+#include <TTree.h>
+
+// HDF5 includes
+#include <hdf5.h>
+
+// root2hdf5 includes
+#include "tree/map_root.h"
+
+
+namespace root2hdf5
+{
+    namespace tree
+    {
+        namespace profile
+        {
+            // The number of branches reported when --profile-branches is
+            // given without a count
+            const unsigned default_profile_rows = 20;
+
+            // The cost attributed to a single top-level branch.  Sub-branches
+            // and leaves are accounted to the top-level branch they belong
+            // to, since that is the unit that can be projected out.
+            struct branch_profile
+            {
+                std::string name;
+                double read_seconds; // Time spent in TBranch::GetEntry
+                double convert_seconds; // Time spent in leaf converters
+                unsigned long long bytes_read; // Uncompressed bytes read
+                Long64_t zip_bytes; // Compressed size in the ROOT file
+                Long64_t tot_bytes; // Uncompressed size in the ROOT file
+                size_t row_bytes; // Fixed-size bytes in each output row
+            };
+
+            // The costs collected so far for a tree
+            struct tree_profile
+            {
+                std::vector<TBranch *> branches;
+                std::vector<branch_profile> profiles;
+                std::map<TBranch *, size_t> positions;
+            };
+
+            // Returns true if --profile-branches was given
+            bool profiling_requested();
+
+            // Returns the number of branches to report
+            unsigned profile_rows();
+
+            // Creates an empty profile of the top-level branches of a tree,
+            // including those of its friends, recording their storage sizes
+            // and how many bytes of each output row they produce
+            std::shared_ptr<tree_profile> profile_tree(TTree *tree);
+
+            // Returns a converter wrapper which times each converter and
+            // attributes the time to the branch of its leaf
+            root2hdf5::tree::map_root::root_converter_wrapper
+            profiling_wrapper(std::shared_ptr<tree_profile> profile);
+
+            // Loads an entry like TTree::GetEntry, but reads each profiled
+            // branch individually, timing it.  Returns the number of bytes
+            // read, or -1 on failure.
+            Int_t read_entry(tree_profile & profile,
+                             TTree *tree,
+                             Long64_t entry);
+
+            // Returns the n branches with the highest total cost, most
+            // expensive first
+            std::vector<branch_profile> most_expensive_branches(
+                const std::vector<branch_profile> & profiles,
+                unsigned n
+            );
+
+            // Prints the most expensive branches of a tree as a table
+            void print_profile(TTree *tree,
+                               const tree_profile & profile,
+                               hsize_t n_rows);
+        }
+    }
+}
@@ -0,0 +1,294 @@
+#include "tree/split.h"
+
+// Standard includes
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <sstream>
+
+// root2hdf5 includes
+#include "options.h"
+#include "tree/pack.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::split;
+using namespace root2hdf5::tree::pack;
+using namespace root2hdf5::options;
+
+
+// Private namespace members
+namespace root2hdf5
+{
+    namespace tree
+    {
+        namespace split
+        {
+            // Returns the name of a member of a compound type
+            string member_name(hid_t type, unsigned index);
+
+            // Group suffixes which are taken by the side datasets written
+            // next to a tree's dataset (see index_dataset_name and
+            // statistics_dataset_name)
+            const char * const reserved_suffixes[] = {"index", "statistics"};
+
+            // Returns the size of a member of a compound type
+            size_t member_size(hid_t type, unsigned index);
+
+            // Returns the size of the encoded description of a compound type
+            // holding just one member of a compound type, or 0 on failure
+            size_t member_description_size(hid_t type, unsigned index);
+
+            // Numbers groups of consecutive members, starting a new group
+            // whenever adding a member would take the current group's total
+            // past target_bytes
+            vector<column_group> group_consecutive(
+                hid_t type,
+                size_t target_bytes,
+                const function<size_t(hid_t, unsigned)> & member_bytes
+            );
+        }
+    }
+}
+
+
+string root2hdf5::tree::split::member_name(hid_t type, unsigned index)
+{
+    char *name = H5Tget_member_name(type, index);
+    string result = name != NULL ? name : "";
+    H5free_memory(name);
+    return result;
+}
+
+
+size_t root2hdf5::tree::split::member_size(hid_t type, unsigned index)
+{
+    hid_t member_type = H5Tget_member_type(type, index);
+    size_t result = member_type >= 0 ? H5Tget_size(member_type) : 0;
+    if(member_type >= 0)
+    {
+        H5Tclose(member_type);
+    }
+    return result;
+}
+
+
+size_t root2hdf5::tree::split::member_description_size(hid_t type,
+                                                       unsigned index)
+{
+    hid_t member_type = H5Tget_member_type(type, index);
+    if(member_type < 0)
+    {
+        return 0;
+    }
+    size_t result = 0;
+    hid_t single = H5Tcreate(H5T_COMPOUND, H5Tget_size(member_type));
+    if(single >= 0
+       && H5Tinsert(single,
+                    member_name(type, index).c_str(),
+                    0,
+                    member_type) >= 0
+       && H5Tencode(single, NULL, &result) < 0)
+    {
+        result = 0;
+    }
+    if(single >= 0)
+    {
+        H5Tclose(single);
+    }
+    H5Tclose(member_type);
+    return result;
+}
+
+
+vector<column_group> root2hdf5::tree::split::group_by_prefix(hid_t type)
+{
+    vector<column_group> result;
+    map<string, size_t> positions;
+    int n_members = H5Tget_nmembers(type);
+    for(unsigned i = 0; i < (unsigned)max(n_members, 0); i++)
+    {
+        string name = member_name(type, i);
+        size_t separator = name.find('_');
+        string prefix = separator != string::npos && separator > 0
+                        ? name.substr(0, separator)
+                        : "";
+
+        auto existing = positions.find(prefix);
+        if(existing == positions.end())
+        {
+            column_group group;
+            group.suffix = prefix;
+            existing = positions.insert(make_pair(prefix, result.size())).first;
+            result.push_back(group);
+        }
+        result[existing->second].members.push_back(i);
+    }
+
+    // Keep groups from clashing with the side datasets
+    for(auto group = result.begin(); group != result.end(); group++)
+    {
+        for(auto reserved = begin(reserved_suffixes);
+            reserved != end(reserved_suffixes);
+            reserved++)
+        {
+            if(group->suffix == *reserved)
+            {
+                if(verbose)
+                {
+                    cout << "Column group \"" << group->suffix << "\" "
+                         << "clashes with a side dataset - writing it as \""
+                         << group->suffix << "_\"" << endl;
+                }
+                group->suffix += "_";
+            }
+        }
+    }
+
+    return result;
+}
+
+
+vector<column_group> root2hdf5::tree::split::group_consecutive(
+    hid_t type,
+    size_t target_bytes,
+    const function<size_t(hid_t, unsigned)> & member_bytes
+)
+{
+    vector<column_group> result;
+    size_t total = 0;
+    int n_members = H5Tget_nmembers(type);
+    for(unsigned i = 0; i < (unsigned)max(n_members, 0); i++)
+    {
+        size_t size = member_bytes(type, i);
+        if(result.empty()
+           || (total > 0 && total + size > target_bytes))
+        {
+            stringstream suffix;
+            suffix << result.size();
+            column_group group;
+            group.suffix = suffix.str();
+            result.push_back(group);
+            total = 0;
+        }
+        result.back().members.push_back(i);
+        total += size;
+    }
+
+    return result;
+}
+
+
+vector<column_group> root2hdf5::tree::split::group_by_width(
+    hid_t type,
+    size_t target_bytes
+)
+{
+    return group_consecutive(type, target_bytes, member_size);
+}
+
+
+vector<column_group> root2hdf5::tree::split::group_by_description_size(
+    hid_t type,
+    size_t target_bytes
+)
+{
+    return group_consecutive(type, target_bytes, member_description_size);
+}
+
+
+vector<column_group>
+root2hdf5::tree::split::column_groups_for_type(hid_t type)
+{
+    if(root2hdf5::options::options.count("split-by-prefix"))
+    {
+        return group_by_prefix(type);
+    }
+    if(root2hdf5::options::options.count("split-row-bytes"))
+    {
+        return group_by_width(
+            type,
+            root2hdf5::options::options["split-row-bytes"].as<unsigned>()
+        );
+    }
+
+    // Check whether the type can be described in an object header at all
+    size_t description_bytes = 0;
+    if(H5Tencode(type, NULL, &description_bytes) >= 0
+       && description_bytes > max_type_description_bytes)
+    {
+        if(verbose)
+        {
+            cout << "Row type description is " << description_bytes
+                 << " bytes, splitting into groups described in about "
+                 << default_group_description_bytes << " bytes each" << endl;
+        }
+
+        return group_by_description_size(type,
+                                         default_group_description_bytes);
+    }
+
+    return vector<column_group>(1);
+}
+
+
+string root2hdf5::tree::split::column_group_dataset_name(
+    TTree *tree,
+    const column_group & group
+)
+{
+    return group.suffix.empty()
+           ? string(tree->GetName())
+           : string(tree->GetName()) + "." + group.suffix;
+}
+
+
+boost::tuple<hid_t, hid_t>
+root2hdf5::tree::split::types_for_column_group(hid_t type,
+                                               const column_group & group)
+{
+    // A group of every column reads straight from the row type, and
+    // otherwise the group's members are picked out of the row
+    hid_t memory_type = group.members.empty()
+                        ? H5Tcopy(type)
+                        : H5Tcreate(H5T_COMPOUND, H5Tget_size(type));
+    bool success = memory_type >= 0;
+    for(auto it = group.members.begin();
+        success && it != group.members.end();
+        it++)
+    {
+        hid_t member_type = H5Tget_member_type(type, *it);
+        success = member_type >= 0
+                  && H5Tinsert(memory_type,
+                               member_name(type, *it).c_str(),
+                               H5Tget_member_offset(type, *it),
+                               member_type) >= 0;
+        if(member_type >= 0)
+        {
+            H5Tclose(member_type);
+        }
+    }
+
+    // Pack a copy of it for the file
+    hid_t file_type = success ? packed_type(memory_type) : -1;
+    if(file_type < 0)
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Unable to create types for column group \""
+                 << group.suffix << "\"" << endl;
+        }
+        if(memory_type >= 0)
+        {
+            H5Tclose(memory_type);
+        }
+
+        return boost::make_tuple(-1, -1);
+    }
+
+    return boost::make_tuple(file_type, memory_type);
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+// Standard includes
+#include <string>
+#include <vector>
+
+// HACK: Use Boost.Tuple instead of std::tuple because at the moment, the LLVM-
+// provided libc++ doesn't support the std::tuple, and Boost.Tuple is
+// effectively the same thing.
+// Boost includes
+#include <boost/tuple/tuple.hpp>
+
+// ROOT includes
+#include <TTree.h>
+
+// HDF5 includes
+#include <hdf5.h>
+
+
+namespace root2hdf5
+{
+    namespace tree
+    {
+        namespace split
+        {
+            // Row types whose encoded description is larger than this are
+            // split automatically, since the description has to fit in the
+            // dataset's object header (which is limited to 64 KB)
+            const size_t max_type_description_bytes = 60 * 1024;
+
+            // The target size of the encoded type description of each group
+            // when splitting automatically, which leaves room in the object
+            // header for the dataset's other messages and attributes
+            const size_t default_group_description_bytes = 32 * 1024;
+
+            // A group of columns written to a dataset of its own.  Every
+            // group of a tree has the same rows.
+            struct column_group
+            {
+                // The group's dataset is named "<tree>.<suffix>", or just
+                // "<tree>" if the suffix is empty
+                std::string suffix;
+
+                // The indices of the group's top-level members in the row
+                // type, or empty for all of them
+                std::vector<unsigned> members;
+            };
+
+            // Groups the top-level members of a row type by the part of
+            // their name before the first underscore, e.g. jet_pt and
+            // jet_eta go to the "jet" group.  Members without a prefix stay
+            // in the tree's own dataset.  Groups are ordered by their first
+            // member.  Prefixes which would name the same dataset as one of
+            // the tree's side datasets (e.g. "index" or "statistics") get a
+            // trailing underscore, e.g. "<tree>.index_".
+            std::vector<column_group> group_by_prefix(hid_t type);
+
+            // Groups consecutive top-level members of a row type so that
+            // each group's row is at most target_bytes wide (unless a single
+            // member is wider).  Groups are numbered from 0.
+            std::vector<column_group> group_by_width(hid_t type,
+                                                     size_t target_bytes);
+
+            // Groups consecutive top-level members of a row type so that the
+            // encoded type description of each group is at most target_bytes
+            // (unless a single member's is larger).  Each member is counted
+            // as the description of a compound holding just that member,
+            // which slightly overestimates its share.  Groups are numbered
+            // from 0.
+            std::vector<column_group> group_by_description_size(
+                hid_t type,
+                size_t target_bytes
+            );
+
+            // Chooses the column groups for a tree's row type: by prefix with
+            // --split-by-prefix, by width with --split-row-bytes, and by the
+            // size of their type descriptions if the row type is too large to
+            // describe in an object header.  Otherwise there is a single group
+            // holding every column.
+            std::vector<column_group> column_groups_for_type(hid_t type);
+
+            // Returns the name of a column group's dataset
+            std::string column_group_dataset_name(TTree *tree,
+                                                  const column_group & group);
+
+            // Creates the types for writing a column group from rows of the
+            // full row type.  The memory type has the size of a full row with
+            // the group's members at their offsets in it, while the file type
+            // holds just the group's members, packed (even for a group of
+            // every column, so no padding is stored).  Both should be closed
+            // with H5Tclose.  This method returns a tuple of the form:
+            //      (file_type, memory_type)
+            // where both are -1 on failure.
+            boost::tuple<hid_t, hid_t>
+            types_for_column_group(hid_t type, const column_group & group);
+        }
+    }
+}
@@ -0,0 +1,635 @@
+#include "tree/statistics.h"
+
+// C Standard includes
+#include <cstring>
+
+// Standard includes
+#include <algorithm>
+#include <iostream>
+#include <memory>
+
+// Boost includes
+#include <boost/algorithm/string.hpp>
+
+// root2hdf5 includes
+#include "options.h"
+#include "tree/byte_order.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// Boost namespaces
+using namespace boost;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::statistics;
+using namespace root2hdf5::tree::map_root;
+using namespace root2hdf5::tree::byte_order;
+using namespace root2hdf5::options;
+
+
+// Private namespace members
+namespace root2hdf5
+{
+    namespace tree
+    {
+        namespace statistics
+        {
+            // Marks absent members of a statistics record
+            const size_t no_offset = (size_t)-1;
+
+            // Callback type for computing the statistics of one column over a
+            // block of rows into a statistics record
+            typedef std::function<void(const char *, hsize_t, char *)>
+                column_kernel;
+
+            // A single column for which statistics are computed
+            struct statistics_column
+            {
+                string name;
+                size_t row_offset; // Offset of the column in a row
+                hid_t type; // Predefined native type of the column
+                bool is_float;
+                bool swap; // Whether values are stored in non-native order
+                size_t record_offset; // Offset of the column's statistics
+                size_t min_offset; // The rest are relative to record_offset
+                size_t max_offset;
+                size_t nan_offset;
+                size_t bloom_offset;
+                size_t size; // Size of the column's statistics
+                column_kernel kernel;
+            };
+
+            // The statistics collected so far for a tree
+            struct statistics_state
+            {
+                vector<statistics_column> columns;
+                size_t row_size;
+                size_t record_size;
+                hsize_t n_records;
+                vector<char> records;
+            };
+
+            // Returns the predefined native type matching a numeric type in
+            // everything but byte order, or -1 if it isn't numeric.  swap is
+            // set if the type's byte order isn't the native one, e.g. for
+            // columns kept big-endian with --big-endian.
+            hid_t predefined_numeric_type(hid_t type,
+                                          bool & is_float,
+                                          bool & swap);
+
+            // Returns the predefined native type equal to a type, or -1 if
+            // there isn't one
+            hid_t predefined_native_type(hid_t type, bool & is_float);
+
+            // Finds the numeric members of a type and adds a column for each
+            void find_numeric_columns(hid_t type,
+                                      size_t offset,
+                                      const string & prefix,
+                                      vector<statistics_column> & columns);
+
+            // Builds the kernel for a column with values of type T
+            template<typename T>
+            column_kernel make_column_kernel(const statistics_column & column,
+                                             size_t row_size);
+
+            // Builds the kernel for a column based on its type
+            column_kernel kernel_for_column(const statistics_column & column,
+                                            size_t row_size);
+
+            // Creates the HDF5 type of a statistics record
+            hid_t create_record_type(const statistics_state & state);
+
+            // Writes the statistics dataset
+            bool write_statistics(const statistics_state & state,
+                                  hsize_t rows_per_chunk,
+                                  hid_t parent_destination,
+                                  const string & name);
+
+            // Hashes a value for bloom filters
+            unsigned long long bloom_filter_hash(Long64_t value);
+        }
+    }
+}
+
+
+bool root2hdf5::tree::statistics::statistics_requested()
+{
+    return root2hdf5::options::options.count("statistics") > 0;
+}
+
+
+vector<string> root2hdf5::tree::statistics::bloom_filter_columns()
+{
+    vector<string> columns;
+    if(root2hdf5::options::options.count("bloom-filter") == 0)
+    {
+        return columns;
+    }
+
+    string specification
+        = root2hdf5::options::options["bloom-filter"].as<string>();
+    split(columns, specification, is_any_of(","));
+    for(auto it = columns.begin(); it != columns.end(); it++)
+    {
+        trim(*it);
+    }
+
+    return columns;
+}
+
+
+string root2hdf5::tree::statistics::statistics_dataset_name(TTree *tree)
+{
+    return string(tree->GetName()) + ".statistics";
+}
+
+
+unsigned long long root2hdf5::tree::statistics::bloom_filter_hash(
+    Long64_t value
+)
+{
+    unsigned long long hash = (unsigned long long)value;
+    hash += 0x9e3779b97f4a7c15ULL;
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+    return hash ^ (hash >> 31);
+}
+
+
+void root2hdf5::tree::statistics::bloom_filter_insert(
+    unsigned long long *filter,
+    Long64_t value
+)
+{
+    const unsigned long long n_bits = 64ULL * bloom_filter_words;
+    unsigned long long hash = bloom_filter_hash(value);
+    unsigned long long h1 = hash & 0xffffffffULL;
+    unsigned long long h2 = (hash >> 32) | 1ULL;
+    for(unsigned i = 0; i < bloom_filter_hashes; i++)
+    {
+        unsigned long long bit = (h1 + i * h2) % n_bits;
+        filter[bit / 64] |= 1ULL << (bit % 64);
+    }
+}
+
+
+bool root2hdf5::tree::statistics::bloom_filter_may_contain(
+    const unsigned long long *filter,
+    Long64_t value
+)
+{
+    const unsigned long long n_bits = 64ULL * bloom_filter_words;
+    unsigned long long hash = bloom_filter_hash(value);
+    unsigned long long h1 = hash & 0xffffffffULL;
+    unsigned long long h2 = (hash >> 32) | 1ULL;
+    for(unsigned i = 0; i < bloom_filter_hashes; i++)
+    {
+        unsigned long long bit = (h1 + i * h2) % n_bits;
+        if((filter[bit / 64] & (1ULL << (bit % 64))) == 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+hid_t root2hdf5::tree::statistics::predefined_numeric_type(hid_t type,
+                                                          bool & is_float,
+                                                          bool & swap)
+{
+    // Compare a native-order copy of atomic types, so that swapped columns
+    // still match
+    H5T_class_t type_class = H5Tget_class(type);
+    if(type_class != H5T_INTEGER && type_class != H5T_FLOAT)
+    {
+        return -1;
+    }
+    H5T_order_t native_order = H5Tget_order(H5T_NATIVE_INT);
+    swap = H5Tget_order(type) != native_order;
+    hid_t native_type = H5Tcopy(type);
+    if(native_type < 0)
+    {
+        return -1;
+    }
+    hid_t result = -1;
+    if(!swap || H5Tset_order(native_type, native_order) >= 0)
+    {
+        result = predefined_native_type(native_type, is_float);
+    }
+    H5Tclose(native_type);
+
+    return result;
+}
+
+
+hid_t root2hdf5::tree::statistics::predefined_native_type(hid_t type,
+                                                         bool & is_float)
+{
+    const hid_t integer_types[] = {
+        H5T_NATIVE_SCHAR, H5T_NATIVE_UCHAR,
+        H5T_NATIVE_SHORT, H5T_NATIVE_USHORT,
+        H5T_NATIVE_INT, H5T_NATIVE_UINT,
+        H5T_NATIVE_LLONG, H5T_NATIVE_ULLONG
+    };
+    const hid_t float_types[] = {H5T_NATIVE_FLOAT, H5T_NATIVE_DOUBLE};
+
+    for(unsigned i = 0; i < sizeof(integer_types) / sizeof(hid_t); i++)
+    {
+        if(H5Tequal(type, integer_types[i]) > 0)
+        {
+            is_float = false;
+            return integer_types[i];
+        }
+    }
+    for(unsigned i = 0; i < sizeof(float_types) / sizeof(hid_t); i++)
+    {
+        if(H5Tequal(type, float_types[i]) > 0)
+        {
+            is_float = true;
+            return float_types[i];
+        }
+    }
+
+    return -1;
+}
+
+
+void root2hdf5::tree::statistics::find_numeric_columns(
+    hid_t type,
+    size_t offset,
+    const string & prefix,
+    vector<statistics_column> & columns
+)
+{
+    int n_members = H5Tget_nmembers(type);
+    for(int i = 0; i < n_members; i++)
+    {
+        char *name = H5Tget_member_name(type, i);
+        hid_t member_type = H5Tget_member_type(type, i);
+        size_t member_offset = offset + H5Tget_member_offset(type, i);
+        string path = prefix + name;
+        H5free_memory(name);
+
+        if(H5Tget_class(member_type) == H5T_COMPOUND)
+        {
+            find_numeric_columns(member_type,
+                                 member_offset,
+                                 path + ".",
+                                 columns);
+        }
+        else
+        {
+            statistics_column column;
+            column.type = predefined_numeric_type(member_type,
+                                                  column.is_float,
+                                                  column.swap);
+            if(column.type >= 0)
+            {
+                column.name = path;
+                column.row_offset = member_offset;
+                columns.push_back(column);
+            }
+        }
+
+        H5Tclose(member_type);
+    }
+}
+
+
+template<typename T>
+column_kernel root2hdf5::tree::statistics::make_column_kernel(
+    const statistics_column & column,
+    size_t row_size
+)
+{
+    // The column is gathered into a contiguous buffer for the kernels, which
+    // is kept across blocks so that it is only allocated once
+    std::shared_ptr<vector<T> > scratch(new vector<T>());
+    return [=](const char *rows, hsize_t n_rows, char *record) {
+        vector<T> & values = *scratch;
+        if(values.size() < n_rows)
+        {
+            values.resize(n_rows);
+        }
+        const char *source = rows + column.row_offset;
+        for(hsize_t i = 0; i < n_rows; i++, source += row_size)
+        {
+            memcpy(&values[i], source, sizeof(T));
+        }
+        if(column.swap)
+        {
+            swap_byte_order((const char *)&values[0],
+                            (char *)&values[0],
+                            n_rows,
+                            sizeof(T));
+        }
+
+        T minimum, maximum;
+        unsigned long long n_nans = value_range(&values[0],
+                                                n_rows,
+                                                minimum,
+                                                maximum);
+        char *statistics = record + column.record_offset;
+        memcpy(statistics + column.min_offset, &minimum, sizeof(T));
+        memcpy(statistics + column.max_offset, &maximum, sizeof(T));
+        if(column.nan_offset != no_offset)
+        {
+            memcpy(statistics + column.nan_offset, &n_nans, sizeof(n_nans));
+        }
+        if(column.bloom_offset != no_offset)
+        {
+            unsigned long long filter[bloom_filter_words] = {0};
+            for(hsize_t i = 0; i < n_rows; i++)
+            {
+                bloom_filter_insert(filter, (Long64_t)values[i]);
+            }
+            memcpy(statistics + column.bloom_offset, filter, sizeof(filter));
+        }
+    };
+}
+
+
+column_kernel root2hdf5::tree::statistics::kernel_for_column(
+    const statistics_column & column,
+    size_t row_size
+)
+{
+    if(column.type == H5T_NATIVE_SCHAR)
+    {
+        return make_column_kernel<signed char>(column, row_size);
+    }
+    else if(column.type == H5T_NATIVE_UCHAR)
+    {
+        return make_column_kernel<unsigned char>(column, row_size);
+    }
+    else if(column.type == H5T_NATIVE_SHORT)
+    {
+        return make_column_kernel<short>(column, row_size);
+    }
+    else if(column.type == H5T_NATIVE_USHORT)
+    {
+        return make_column_kernel<unsigned short>(column, row_size);
+    }
+    else if(column.type == H5T_NATIVE_INT)
+    {
+        return make_column_kernel<int>(column, row_size);
+    }
+    else if(column.type == H5T_NATIVE_UINT)
+    {
+        return make_column_kernel<unsigned int>(column, row_size);
+    }
+    else if(column.type == H5T_NATIVE_LLONG)
+    {
+        return make_column_kernel<long long>(column, row_size);
+    }
+    else if(column.type == H5T_NATIVE_ULLONG)
+    {
+        return make_column_kernel<unsigned long long>(column, row_size);
+    }
+    else if(column.type == H5T_NATIVE_FLOAT)
+    {
+        return make_column_kernel<float>(column, row_size);
+    }
+
+    return make_column_kernel<double>(column, row_size);
+}
+
+
+hid_t root2hdf5::tree::statistics::create_record_type(
+    const statistics_state & state
+)
+{
+    hid_t record_type = H5Tcreate(H5T_COMPOUND, state.record_size);
+    hsize_t bloom_words = bloom_filter_words;
+    hid_t bloom_type = H5Tarray_create2(H5T_NATIVE_ULLONG, 1, &bloom_words);
+    bool success = record_type >= 0 && bloom_type >= 0;
+    for(auto it = state.columns.begin();
+        success && it != state.columns.end();
+        it++)
+    {
+        hid_t column_type = H5Tcreate(H5T_COMPOUND, it->size);
+        success = column_type >= 0
+                  && H5Tinsert(column_type,
+                               "min",
+                               it->min_offset,
+                               it->type) >= 0
+                  && H5Tinsert(column_type,
+                               "max",
+                               it->max_offset,
+                               it->type) >= 0
+                  && (it->nan_offset == no_offset
+                      || H5Tinsert(column_type,
+                                   "nan_count",
+                                   it->nan_offset,
+                                   H5T_NATIVE_ULLONG) >= 0)
+                  && (it->bloom_offset == no_offset
+                      || H5Tinsert(column_type,
+                                   "bloom",
+                                   it->bloom_offset,
+                                   bloom_type) >= 0)
+                  && H5Tinsert(record_type,
+                               it->name.c_str(),
+                               it->record_offset,
+                               column_type) >= 0;
+        if(column_type >= 0)
+        {
+            H5Tclose(column_type);
+        }
+    }
+
+    if(bloom_type >= 0)
+    {
+        H5Tclose(bloom_type);
+    }
+    if(!success)
+    {
+        if(record_type >= 0)
+        {
+            H5Tclose(record_type);
+        }
+
+        return -1;
+    }
+
+    return record_type;
+}
+
+
+bool root2hdf5::tree::statistics::write_statistics(
+    const statistics_state & state,
+    hsize_t rows_per_chunk,
+    hid_t parent_destination,
+    const string & name
+)
+{
+    // Create the dataset
+    hid_t type = create_record_type(state);
+    hsize_t n_records = state.n_records;
+    hid_t space = H5Screate_simple(1, &n_records, NULL);
+    hid_t dataset = -1;
+    if(type >= 0 && space >= 0)
+    {
+        dataset = H5Dcreate2(parent_destination,
+                             name.c_str(),
+                             type,
+                             space,
+                             H5P_DEFAULT,
+                             H5P_DEFAULT,
+                             H5P_DEFAULT);
+    }
+
+    // Write the records
+    bool success = dataset >= 0
+                   && (n_records == 0
+                       || H5Dwrite(dataset,
+                                   type,
+                                   H5S_ALL,
+                                   H5S_ALL,
+                                   H5P_DEFAULT,
+                                   &state.records[0]) >= 0);
+
+    // Record the chunking and bloom filter parameters readers need
+    const char *attribute_names[] = {
+        "rows_per_chunk",
+        "bloom_filter_bits",
+        "bloom_filter_hashes"
+    };
+    const unsigned long long attribute_values[] = {
+        rows_per_chunk,
+        64ULL * bloom_filter_words,
+        bloom_filter_hashes
+    };
+    hid_t attribute_space = H5Screate(H5S_SCALAR);
+    for(unsigned i = 0; success && i < 3; i++)
+    {
+        hid_t attribute = H5Acreate2(dataset,
+                                     attribute_names[i],
+                                     H5T_NATIVE_ULLONG,
+                                     attribute_space,
+                                     H5P_DEFAULT,
+                                     H5P_DEFAULT);
+        success = attribute >= 0
+                  && H5Awrite(attribute,
+                              H5T_NATIVE_ULLONG,
+                              &attribute_values[i]) >= 0;
+        if(attribute >= 0 && H5Aclose(attribute) < 0)
+        {
+            success = false;
+        }
+    }
+    H5Sclose(attribute_space);
+
+    // Clean up
+    if(dataset >= 0 && H5Dclose(dataset) < 0)
+    {
+        success = false;
+    }
+    if(space >= 0)
+    {
+        H5Sclose(space);
+    }
+    if(type >= 0)
+    {
+        H5Tclose(type);
+    }
+
+    if(!success && verbose)
+    {
+        cerr << "ERROR: Unable to write statistics dataset \"" << name << "\""
+             << endl;
+    }
+
+    return success;
+}
+
+
+boost::tuple<bool, block_observer, root_finalizer>
+root2hdf5::tree::statistics::build_statistics(TTree *tree,
+                                              hid_t row_type,
+                                              hsize_t rows_per_chunk)
+{
+    std::shared_ptr<statistics_state> state(new statistics_state());
+    state->row_size = H5Tget_size(row_type);
+    state->n_records = 0;
+    find_numeric_columns(row_type, 0, "", state->columns);
+
+    // Lay out the statistics records
+    vector<string> bloom_columns = bloom_filter_columns();
+    state->record_size = 0;
+    for(auto it = state->columns.begin(); it != state->columns.end(); it++)
+    {
+        size_t value_size = H5Tget_size(it->type);
+        bool has_bloom = find(bloom_columns.begin(),
+                              bloom_columns.end(),
+                              it->name) != bloom_columns.end();
+        if(has_bloom && it->is_float)
+        {
+            if(verbose)
+            {
+                cerr << "WARNING: Bloom filters are only built for integer "
+                     << "columns - skipping \"" << it->name << "\"" << endl;
+            }
+            has_bloom = false;
+        }
+
+        it->record_offset = state->record_size;
+        it->min_offset = 0;
+        it->max_offset = value_size;
+        it->size = 2 * value_size;
+        it->nan_offset = no_offset;
+        if(it->is_float)
+        {
+            it->nan_offset = it->size;
+            it->size += sizeof(unsigned long long);
+        }
+        it->bloom_offset = no_offset;
+        if(has_bloom)
+        {
+            it->bloom_offset = it->size;
+            it->size += bloom_filter_words * sizeof(unsigned long long);
+        }
+        state->record_size += it->size;
+
+        it->kernel = kernel_for_column(*it, state->row_size);
+    }
+
+    string name = statistics_dataset_name(tree);
+    return boost::make_tuple(
+        true,
+        [=](const char *rows, hsize_t n_rows) -> bool {
+            if(state->columns.empty() || n_rows == 0)
+            {
+                return true;
+            }
+
+            // Compute the record for this chunk
+            state->records.resize(state->records.size() + state->record_size);
+            char *record = &state->records[0]
+                           + state->n_records * state->record_size;
+            for(auto it = state->columns.begin();
+                it != state->columns.end();
+                it++)
+            {
+                it->kernel(rows, n_rows, record);
+            }
+            state->n_records++;
+
+            return true;
+        },
+        [=](hid_t parent_destination) -> bool {
+            if(state->columns.empty())
+            {
+                return true;
+            }
+
+            return write_statistics(*state,
+                                    rows_per_chunk,
+                                    parent_destination,
+                                    name);
+        }
+    );
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+// Standard includes
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+// HACK: Use Boost.Tuple instead of std::tuple because at the moment, the LLVM-
+// provided libc++ doesn't support the std::tuple, and Boost.Tuple is
+// effectively the same thing.
+// Boost includes
+#include <boost/tuple/tuple.hpp>
+
+// ROOT includes
+#include <TTree.h>
+
+// HDF5 includes
+#include <hdf5.h>
+
+// root2hdf5 includes
+#include "tree/map_root.h"
+
+
+namespace root2hdf5
+{
+    namespace tree
+    {
+        namespace statistics
+        {
+            // Bloom filters are this many 64-bit words long
+            const unsigned bloom_filter_words = 16;
+
+            // The number of bits set in a bloom filter for each value
+            const unsigned bloom_filter_hashes = 3;
+
+            // Callback type for observing each block of rows written to a
+            // tree's dataset.  The rows are laid out exactly as in the
+            // dataset's compound type.
+            typedef std::function<bool(const char *, hsize_t)> block_observer;
+
+            // Returns true if --statistics was given
+            bool statistics_requested();
+
+            // Returns the columns given with --bloom-filter
+            std::vector<std::string> bloom_filter_columns();
+
+            // Returns the name of the statistics dataset for a tree, which is
+            // written next to the tree's dataset, e.g. "events.statistics"
+            std::string statistics_dataset_name(TTree *tree);
+
+            // Computes the minimum and maximum of contiguous values, ignoring
+            // NaNs, and returns the number of NaNs.  If every value is NaN,
+            // the minimum and maximum are NaN too.  The loop is kept free of
+            // branches so that the compiler can vectorize it.
+            template<typename T>
+            hsize_t value_range(const T *values,
+                                size_t n_values,
+                                T & minimum,
+                                T & maximum)
+            {
+                typedef std::numeric_limits<T> limits;
+                T lowest = limits::has_infinity
+                           ? limits::infinity()
+                           : limits::max();
+                T highest = limits::has_infinity
+                            ? -limits::infinity()
+                            : limits::lowest();
+                hsize_t n_nans = 0;
+                for(size_t i = 0; i < n_values; i++)
+                {
+                    T value = values[i];
+                    n_nans += (value != value);
+                    lowest = value < lowest ? value : lowest;
+                    highest = value > highest ? value : highest;
+                }
+
+                if(limits::has_quiet_NaN && n_values > 0 && n_nans == n_values)
+                {
+                    lowest = highest = limits::quiet_NaN();
+                }
+                minimum = lowest;
+                maximum = highest;
+
+                return n_nans;
+            }
+
+            // Adds a value to a bloom filter of bloom_filter_words words.  The
+            // value is hashed with the SplitMix64 finalizer, and bit
+            // (h1 + i * h2) mod (64 * bloom_filter_words) is set for each i
+            // below bloom_filter_hashes, where h1 and h2 are the low and high
+            // (forced odd) 32 bits of the hash.  Bit b is bit (b mod 64) of
+            // word (b / 64).
+            void bloom_filter_insert(unsigned long long *filter,
+                                     Long64_t value);
+
+            // Returns false if a value is definitely not in a bloom filter
+            bool bloom_filter_may_contain(const unsigned long long *filter,
+                                          Long64_t value);
+
+            // Sets up statistics for each numeric member of a tree's row type
+            // (nested members are named by their dotted path).  The observer
+            // should be called with each block of rows as it is written, and
+            // every block except the last must hold exactly rows_per_chunk
+            // rows, so that record i of the statistics dataset describes
+            // chunk i of the tree's dataset.  Each record holds a compound
+            // member per column with "min" and "max" members of the column's
+            // type, a "nan_count" member for floating point columns, and a
+            // "bloom" filter member for integer columns given with
+            // --bloom-filter.  This method returns a tuple of the form:
+            //      (success, observer, finalizer)
+            boost::tuple<bool, block_observer, map_root::root_finalizer>
+            build_statistics(TTree *tree,
+                             hid_t row_type,
+                             hsize_t rows_per_chunk);
+        }
+    }
+}
@@ -1,6 +1,11 @@
 #include "tree/structure.h"
 
+// C Standard includes
+#include <cstdlib>
+
 // Standard includes
+#include <map>
+#include <set>
 #include <sstream>
 
 // ROOT includes
@@ -11,6 +16,7 @@
 // root2hdf5 includes
 #include "options.h"
 #include "cint.h"
+#include "cache.h"
 #include "tree/walk.h"
 #include "tree/leaf_converters.h"
 
@@ -22,31 +28,98 @@ using namespace std;
 using namespace root2hdf5::tree::structure;
 using namespace root2hdf5::options;
 using namespace root2hdf5::cint;
+using namespace root2hdf5::cache;
 using namespace root2hdf5::tree::walk;
 using namespace root2hdf5::tree::leaf_converters;
 
 
-string root2hdf5::tree::structure::struct_type_name_for_tree(TTree *tree)
+// Private namespace members
+namespace root2hdf5
+{
+    namespace tree
+    {
+        namespace structure
+        {
+            // Version of the conversion plan, which is mixed into every
+            // struct name.  Bump this whenever the way structs are generated
+            // or laid out changes, so that stale cached layouts are ignored.
+            const char * const plan_version = "1";
+
+            // Names of the structs which CINT has already been informed of
+            set<string> _declared_structs;
+
+            // Code of the structs whose layout is already cached, so that
+            // CINT is only informed of them if a value turns out to be
+            // missing from the cache
+            map<string, string> _undeclared_structs;
+
+            // Generates the members of the conversion struct for the tree,
+            // optionally warning about leaves which will be skipped.  Returns
+            // true on success, false on failure.
+            bool struct_members_for_tree(TTree *tree,
+                                         string & members,
+                                         bool warn);
+
+            // Returns the struct name for the tree's signature and members
+            string struct_type_name_for_members(const string & signature,
+                                                const string & members);
+
+            // Informs CINT of a struct whose declaration was skipped because
+            // its layout was cached.  Returns true on success (including if
+            // there was nothing to declare), false on failure.
+            bool declare_struct(const string & type_name);
+
+            // Looks up a size-like value in the layout cache, computing it
+            // with the provided CINT expression if it isn't there yet.  Only
+            // successfully computed values are cached.  Returns
+            // invalid_layout_value on failure.
+            size_t cached_layout_value(const string & type_name,
+                                       const string & key,
+                                       const string & expression);
+        }
+    }
+}
+
+
+string root2hdf5::tree::structure::schema_signature_for_tree(TTree *tree)
 {
     // Create a stringstream to build the result
-    stringstream result;
+    stringstream signature;
 
-    // Create a unique name
-    result << "tree_" << (long int)tree;
+    // Walk the tree, recording everything which influences the generated
+    // struct
+    walk_tree(
+        tree,
+        [&signature](TBranch *branch) -> bool {
+            signature << branch->GetName() << "{";
+            return true;
+        },
+        [&signature](TLeaf *leaf) -> bool {
+            leaf_converter *converter = find_converter(leaf);
+            signature << leaf->GetName() << ":" << leaf->GetTitle() << ":"
+                      << leaf->GetTypeName() << ":"
+                      << (converter != NULL ? converter->name : "-") << ";";
+            return true;
+        },
+        [&signature](TBranch *branch) -> bool {
+            // Hide unused variable warning
+            (void)branch;
+            signature << "}";
+            return true;
+        }
+    );
 
-    return result.str();
+    return signature.str();
 }
 
 
-bool root2hdf5::tree::structure::create_struct_code_for_tree(TTree *tree,
-                                                             string *code)
+bool root2hdf5::tree::structure::struct_members_for_tree(TTree *tree,
+                                                         string & members,
+                                                         bool warn)
 {
-    // Create a stringstream to build the structure
+    // Create a stringstream to build the members
     stringstream structure;
 
-    // Create the outer structure
-    structure << "struct " << struct_type_name_for_tree(tree) << "{";
-
     // Walk the tree and add submembers
     bool success = walk_tree(
         tree,
@@ -58,7 +131,7 @@ bool root2hdf5::tree::structure::create_struct_code_for_tree(TTree *tree,
             return true;
         },
         // Leaf process
-        [&structure](TLeaf *leaf) -> bool {
+        [&structure, warn](TLeaf *leaf) -> bool {
             // Find a leaf converter
             leaf_converter *converter = find_converter(leaf);
 
@@ -74,7 +147,7 @@ bool root2hdf5::tree::structure::create_struct_code_for_tree(TTree *tree,
             // fail due to empty generated structs.
             if(converter == NULL)
             {
-                if(verbose)
+                if(warn && verbose)
                 {
                     cerr << "WARNING: Leaf \"" << leaf->GetName() << "\" has "
                          << "an unknown type \"" << leaf->GetTypeName()
@@ -96,8 +169,40 @@ bool root2hdf5::tree::structure::create_struct_code_for_tree(TTree *tree,
         }
     );
 
-    // If things failed during walking, return a bogus structure
-    if(!success)
+    members = structure.str();
+    return success;
+}
+
+
+string root2hdf5::tree::structure::struct_type_name_for_members(
+    const string & signature,
+    const string & members
+)
+{
+    // The members are part of the name, so that a converter whose output
+    // changes without its name changing (e.g. a rebuilt plugin) never picks
+    // up the cached layout of the old struct
+    return string("tree_") + hash_string(string(plan_version) + "\n"
+                                         + signature + "\n"
+                                         + members);
+}
+
+
+string root2hdf5::tree::structure::struct_type_name_for_tree(TTree *tree)
+{
+    string members;
+    struct_members_for_tree(tree, members, false);
+    return struct_type_name_for_members(schema_signature_for_tree(tree),
+                                        members);
+}
+
+
+bool root2hdf5::tree::structure::create_struct_code_for_tree(TTree *tree,
+                                                             string *code)
+{
+    // Generate the members
+    string members;
+    if(!struct_members_for_tree(tree, members, true))
     {
         if(verbose)
         {
@@ -108,19 +213,44 @@ bool root2hdf5::tree::structure::create_struct_code_for_tree(TTree *tree,
         return false;
     }
 
-    // Close the outer structure
-    structure << "};";
+    // Wrap them in the outer structure
+    string struct_name = struct_type_name_for_members(
+        schema_signature_for_tree(tree),
+        members
+    );
+    string structure = string("struct ") + struct_name + "{" + members + "};";
 
     // If the user wants a copy of the code, give it to them, regardless of
     // whether or not it compiles
     if(code != NULL)
     {
-        *code = structure.str();
+        *code = structure;
+    }
+
+    // If another tree with the same schema has already been converted, CINT
+    // already knows about the structure, and redeclaring it would be an error
+    if(_declared_structs.count(struct_name))
+    {
+        return true;
+    }
+
+    // If a previous run cached the layout of the structure, there's no need
+    // to inform CINT about it at all, since instances are allocated as plain
+    // memory.  Hold on to the code in case a layout value is missing.
+    size_t cached_size = 0;
+    if(lookup_layout_value(struct_name, "sizeof", cached_size))
+    {
+        _undeclared_structs[struct_name] = structure;
+        return true;
     }
 
     // Inform CINT about the structure
-    bool result = process_long_line(structure.str());
-    if(!result && verbose)
+    bool result = process_long_line(structure);
+    if(result)
+    {
+        _declared_structs.insert(struct_name);
+    }
+    else if(verbose)
     {
         cerr << "ERROR: Unable to compile temporary struct for converting tree "
              << "\"" << tree->GetName() << "\"";
@@ -130,6 +260,52 @@ bool root2hdf5::tree::structure::create_struct_code_for_tree(TTree *tree,
 }
 
 
+bool root2hdf5::tree::structure::declare_struct(const string & type_name)
+{
+    auto pending = _undeclared_structs.find(type_name);
+    if(pending == _undeclared_structs.end())
+    {
+        return true;
+    }
+
+    string structure = pending->second;
+    _undeclared_structs.erase(pending);
+    if(!process_long_line(structure))
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Unable to compile temporary struct \"" << type_name
+                 << "\"" << endl;
+        }
+
+        return false;
+    }
+    _declared_structs.insert(type_name);
+
+    return true;
+}
+
+
+void * root2hdf5::tree::structure::allocate_conversion_struct(
+    const string & type_name
+)
+{
+    size_t size = sizeof_type_by_name(type_name);
+    if(size == invalid_layout_value)
+    {
+        return NULL;
+    }
+
+    return calloc(1, size);
+}
+
+
+void root2hdf5::tree::structure::deallocate_conversion_struct(void *location)
+{
+    free(location);
+}
+
+
 void * root2hdf5::tree::structure::allocate_instance_by_name(string type_name)
 {
     return (void *)gROOT->ProcessLine(
@@ -154,13 +330,55 @@ void root2hdf5::tree::structure::deallocate_instance_by_name_and_location(
 }
 
 
+size_t root2hdf5::tree::structure::cached_layout_value(
+    const string & type_name,
+    const string & key,
+    const string & expression
+)
+{
+    // Check the cache first, since asking CINT is slow
+    size_t result = 0;
+    if(lookup_layout_value(type_name, key, result))
+    {
+        return result;
+    }
+
+    // Otherwise compute it, making sure CINT knows the type
+    if(!declare_struct(type_name))
+    {
+        return invalid_layout_value;
+    }
+    Int_t error = 0;
+    result = (size_t)gROOT->ProcessLine(expression.c_str(), &error);
+
+    // A failed evaluation also comes back as 0, so make sure it isn't
+    // recorded, or every later run would build a broken layout from it.
+    // Sizes are never legitimately 0 either.
+    if(error != 0 || (result == 0 && key.compare(0, 6, "sizeof") == 0))
+    {
+        if(verbose)
+        {
+            cerr << "ERROR: Unable to evaluate \"" << expression
+                 << "\" for struct \"" << type_name << "\"" << endl;
+        }
+
+        return invalid_layout_value;
+    }
+    store_layout_value(type_name, key, result);
+
+    return result;
+}
+
+
 size_t root2hdf5::tree::structure::offsetof_member_in_type_by_name(
     string type_name,
     string member_name
 )
 {
-    return (size_t)gROOT->ProcessLine(
-        (string("offsetof(") + type_name + "," + member_name + ");").c_str()
+    return cached_layout_value(
+        type_name,
+        string("offsetof:") + member_name,
+        string("offsetof(") + type_name + "," + member_name + ");"
     );
 }
 
@@ -172,20 +390,23 @@ size_t root2hdf5::tree::structure::sizeof_member_in_type_by_name(
 {
     // HACK: This may look like a null-pointer deference, but no dereference
     // ever actually happens, and this is the recommended way of doing this.
-    return (size_t)gROOT->ProcessLine(
-        (string("sizeof(((") 
-         + type_name 
-         + "*)0)->" 
-         + member_name 
-         + ");").c_str()
+    return cached_layout_value(
+        type_name,
+        string("sizeof:") + member_name,
+        string("sizeof(((") 
+        + type_name 
+        + "*)0)->" 
+        + member_name 
+        + ");"
     );
 }
 
 
 size_t root2hdf5::tree::structure::sizeof_type_by_name(string type_name)
 {
-    return (size_t)gROOT->ProcessLine(
-        (string("sizeof(") + type_name + ");").c_str()
+    return cached_layout_value(
+        type_name,
+        "sizeof",
+        string("sizeof(") + type_name + ");"
     );
 }
-
@@ -13,20 +13,44 @@ namespace root2hdf5
     {
         namespace structure
         {
-            // This method returns the unique struct typename that will be used
-            // in the code generated by struct_code_for_tree.
+            // This method returns a string describing the schema of the tree
+            // (its branch nesting and the names, types and converters of its
+            // leaves).
+            std::string schema_signature_for_tree(TTree *tree);
+
+            // This method returns the struct typename that will be used in the
+            // code generated by struct_code_for_tree.  The name is derived
+            // from a hash of the tree's schema signature and of the generated
+            // struct members, so it is stable across runs and shared by trees
+            // which map to identical structs, which lets layout information be
+            // cached persistently.
             std::string struct_type_name_for_tree(TTree *tree);
 
             // This method will generate C++ code representing a struct suitable
             // for mapping a TTree into and writing an HDF5 dataset from, and
-            // inform CINT of its existence.  Unsupported branch datatypes are 
-            // ignored.  Return true on success, false on failure.  One can
-            // optionally pass a non-NULL value to the "code" parameter and have
-            // it filled with the generated code, although this is mostly for
-            // testing the generated code and not strictly-necessary
+            // inform CINT of its existence.  If a struct with the same name
+            // has already been declared in this process, or its layout is
+            // already cached, CINT is not informed (unless a layout value
+            // turns out to be missing from the cache later on).  Unsupported
+            // branch datatypes are ignored.  Return true
+            // on success, false on failure.  One can optionally pass a
+            // non-NULL value to the "code" parameter and have it filled with
+            // the generated code, although this is mostly for testing the
+            // generated code and not strictly-necessary
             bool create_struct_code_for_tree(TTree *tree,
                                              std::string *code = NULL);
 
+            // This method allocates a zeroed instance of a conversion struct
+            // generated by create_struct_code_for_tree, using only its
+            // (cached) size, so that CINT isn't needed to create it.  This
+            // works because conversion struct members are always plain data.
+            // Returns NULL on failure.
+            void * allocate_conversion_struct(const std::string & type_name);
+
+            // This method deallocates a conversion struct allocated by
+            // allocate_conversion_struct.
+            void deallocate_conversion_struct(void *location);
+
             // This method will allocate an instance of the type specified by
             // name and return its location in memory.
             void * allocate_instance_by_name(std::string type_name);
@@ -36,8 +60,14 @@ namespace root2hdf5
             void deallocate_instance_by_name_and_location(std::string type_name,
                                                           void *location);
 
+            // The value returned by the size methods below when CINT is
+            // unable to evaluate the size or offset
+            const size_t invalid_layout_value = (size_t)-1;
+
             // This method returns the offset of the member in a struct using
-            // CINT.
+            // CINT.  Results are cached persistently (see root2hdf5::cache),
+            // as are those of the other size methods below, and on failure
+            // it returns invalid_layout_value.
             // E.g. with the struct
             //
             //      struct TestStruct
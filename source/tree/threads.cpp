@@ -0,0 +1,94 @@
+#include "tree/threads.h"
+
+// Standard includes
+#include <iostream>
+
+// ROOT includes
+#include <RVersion.h>
+#include <TROOT.h>
+
+// root2hdf5 includes
+#include "options.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::threads;
+using namespace root2hdf5::options;
+
+
+unsigned root2hdf5::tree::threads::read_threads()
+{
+    if(root2hdf5::options::options.count("read-threads") == 0)
+    {
+        return 0;
+    }
+
+    return root2hdf5::options::options["read-threads"].as<unsigned>();
+}
+
+
+bool root2hdf5::tree::threads::enable_read_threads()
+{
+    unsigned n_threads = read_threads();
+    if(n_threads == 0)
+    {
+        return true;
+    }
+
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 8, 0)
+    if(!ROOT::IsImplicitMTEnabled())
+    {
+        ROOT::EnableImplicitMT(n_threads);
+        if(!ROOT::IsImplicitMTEnabled())
+        {
+            if(verbose)
+            {
+                cerr << "WARNING: ROOT was built without implicit "
+                     << "multi-threading - reading on a single thread" << endl;
+            }
+
+            return false;
+        }
+
+        if(verbose)
+        {
+            cout << "Reading with " << ROOT::GetImplicitMTPoolSize()
+                 << " threads" << endl;
+        }
+    }
+
+    return true;
+#else
+    if(verbose)
+    {
+        cerr << "WARNING: Parallel reading requires ROOT 6.08 or newer - "
+             << "reading on a single thread" << endl;
+    }
+
+    return false;
+#endif
+}
+
+
+void root2hdf5::tree::threads::prefetch_clusters(TTree *tree)
+{
+    if(read_threads() == 0)
+    {
+        return;
+    }
+
+    // Unzip the cached baskets on the thread pool ahead of GetEntry.  This
+    // decides whether the cache created below unzips in parallel, so drop
+    // any cache created before it.
+    tree->SetCacheSize(0);
+    tree->SetParallelUnzip(kTRUE);
+
+    // Cache every branch of each cluster in a single read, rather than
+    // waiting for the learning phase to discover them
+    tree->SetCacheSize();
+    tree->AddBranchToCache("*", kTRUE);
+    tree->StopCacheLearningPhase();
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+// ROOT includes
+#include <TTree.h>
+
+
+namespace root2hdf5
+{
+    namespace tree
+    {
+        namespace threads
+        {
+            // Returns the --read-threads budget, or 0 if reading should stay
+            // on the main thread
+            unsigned read_threads();
+
+            // Enables ROOT's implicit multi-threading with the --read-threads
+            // budget, so that TTree::GetEntry reads and unzips the baskets of
+            // different branches in parallel.  This only happens once per
+            // process, and must happen after any fork, since the thread pool
+            // doesn't survive one.  Returns false if a budget was given but
+            // ROOT can't use it.
+            bool enable_read_threads();
+
+            // Sets up the tree cache so that the same thread pool unzips the
+            // baskets of the upcoming cluster while the current one is being
+            // converted.  ROOT picks the kind of cache when it is created, so
+            // this must be called before the cache is configured any further
+            // (e.g. for an entry list), which then refines this one.
+            void prefetch_clusters(TTree *tree);
+        }
+    }
+}
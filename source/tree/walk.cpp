@@ -1,14 +1,24 @@
 #include "tree/walk.h"
 
+// Standard includes
+#include <iostream>
+#include <set>
+#include <string>
+
 // ROOT includes
+#include <TFriendElement.h>
 #include <TObjArray.h>
 
+// root2hdf5 includes
+#include "options.h"
+
 
 // Standard namespaces
 using namespace std;
 
 // root2hdf5 namespaces
 using namespace root2hdf5::tree::walk;
+using namespace root2hdf5::options;
 
 
 // Private namespace members
@@ -84,16 +94,56 @@ bool root2hdf5::tree::walk::walk_tree(TTree *tree,
                                       leaf_processor leaf_handler,
                                       branch_processor branch_closer)
 {
-    // Loop over each branch at the root level of the tree and do its walking
+    // Loop over each branch at the root level of the tree and do its walking,
+    // keeping track of the names we've seen
+    set<string> branch_names;
     TIter next_branch(tree->GetListOfBranches());
     TBranch *branch = NULL;
     while((branch = (TBranch *)next_branch()))
     {
+        branch_names.insert(branch->GetName());
         if(!walk_branch(branch, branch_opener, leaf_handler, branch_closer))
         {
             return false;
         }
     }
 
+    // Walk the friends' branches as well, unless they're unwanted
+    if(tree->GetListOfFriends() == NULL
+       || root2hdf5::options::options.count("ignore-friends"))
+    {
+        return true;
+    }
+    TIter next_friend(tree->GetListOfFriends());
+    TFriendElement *friend_element = NULL;
+    while((friend_element = (TFriendElement *)next_friend()))
+    {
+        TTree *friend_tree = friend_element->GetTree();
+        if(friend_tree == NULL)
+        {
+            if(verbose)
+            {
+                cerr << "WARNING: Unable to load friend \""
+                     << friend_element->GetName() << "\" of tree \""
+                     << tree->GetName() << "\" - skipping" << endl;
+            }
+
+            continue;
+        }
+
+        TIter next_friend_branch(friend_tree->GetListOfBranches());
+        while((branch = (TBranch *)next_friend_branch()))
+        {
+            if(!branch_names.insert(branch->GetName()).second)
+            {
+                continue;
+            }
+            if(!walk_branch(branch, branch_opener, leaf_handler, branch_closer))
+            {
+                return false;
+            }
+        }
+    }
+
     return true;
 }
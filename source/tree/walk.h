@@ -29,7 +29,13 @@ namespace root2hdf5
             // call the branch opener, then call the leaf handler for each leaf,
             // and then recurse into each subbranch, finally calling the branch
             // closer on the branch after all leaves and subbranches have been
-            // processed.
+            // processed.  Unless --ignore-friends was given, the branches of
+            // any friend trees are walked after those of the tree itself, as
+            // if they belonged to it.  Friend branches with the same name as
+            // a branch already walked (typically shared keys such as run and
+            // event numbers) are skipped.  Reading an entry of the tree reads
+            // the matching entry of each friend, either by entry number or,
+            // if the friend has a TTreeIndex, by index value.
             bool walk_tree(TTree *tree,
                            branch_processor branch_opener,
                            leaf_processor leaf_handler,
@@ -102,3 +102,9 @@ root2hdf5::type::root_type_name_to_scalar_hdf5_type(string type_name)
     // If it does, give it to the user
     return _root_type_name_to_scalar_hdf5_type[type_name];
 }
+
+
+bool root2hdf5::type::is_boolean_type_name(const string & type_name)
+{
+    return type_name == "bool" || type_name == "Bool_t";
+}
@@ -14,5 +14,9 @@ namespace root2hdf5
         // Converts a ROOT type name to an HDF5 scalar (atomic) type.  If no
         // conversion exists, this function will return -1.
         hid_t root_type_name_to_scalar_hdf5_type(std::string type_name);
+
+        // Returns true if the ROOT type name is a boolean type.  Booleans
+        // are converted to (one byte) signed characters.
+        bool is_boolean_type_name(const std::string & type_name);
     }
 }
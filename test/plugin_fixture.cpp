@@ -0,0 +1,75 @@
+// A converter plugin loaded by test_plugin.  It is built once for each of the
+// following variants, each into its own directory:
+//      PLUGIN_FIXTURE_GOOD - A working plugin
+//      PLUGIN_FIXTURE_ABI - A plugin built against another ABI version
+//      PLUGIN_FIXTURE_SYMBOL - A library without the registration function
+//      PLUGIN_FIXTURE_INCOMPLETE - A plugin registering a converter which is
+//          missing a required callback
+
+
+// Standard includes
+#include <string>
+#include <vector>
+
+// root2hdf5 includes
+#include "plugin.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::map_hdf5;
+using namespace root2hdf5::tree::map_root;
+using namespace root2hdf5::tree::leaf_converters;
+
+
+#ifdef PLUGIN_FIXTURE_SYMBOL
+
+extern "C" unsigned root2hdf5_plugin_abi_version()
+{
+    return ROOT2HDF5_PLUGIN_ABI_VERSION;
+}
+
+#else
+
+#ifdef PLUGIN_FIXTURE_ABI
+#undef ROOT2HDF5_PLUGIN_ABI_VERSION
+#define ROOT2HDF5_PLUGIN_ABI_VERSION 0
+#endif
+
+ROOT2HDF5_CONVERTER_PLUGIN(registrar)
+{
+    // Handle leaves named after the fixture, storing them as integers
+    leaf_converter converter;
+    converter.name = "plugin_fixture";
+    converter.can_handle = [](TLeaf *leaf) -> bool {
+        return string(leaf->GetName()) == "plugin_fixture";
+    };
+    converter.member_for_conversion_struct = [](TLeaf *leaf) -> string {
+        return "Int_t " + string(leaf->GetName()) + ";";
+    };
+    converter.hdf5_type_for_leaf = [](
+        TLeaf *,
+        vector<hdf5_type_deallocator> &
+    ) -> hid_t {
+        return H5T_NATIVE_INT;
+    };
+#ifndef PLUGIN_FIXTURE_INCOMPLETE
+    converter.map_leaf_and_build_converter = [](
+        TLeaf *leaf,
+        void *address,
+        vector<root_converter> &,
+        vector<root_finalizer> &,
+        vector<root_resource_deallocator> &
+    ) -> bool {
+        leaf->SetAddress(address);
+        return true;
+    };
+#endif
+
+    registrar(converter);
+    return true;
+}
+
+#endif
@@ -0,0 +1,143 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_api
+#include <boost/test/unit_test.hpp>
+
+
+// C Standard includes
+#include <cstring>
+
+// Standard includes
+#include <string>
+#include <vector>
+
+// Boost includes
+#include <boost/filesystem.hpp>
+
+// ROOT includes
+#include <TFile.h>
+#include <TTree.h>
+
+// HDF5 includes
+#include <hdf5.h>
+
+// root2hdf5 includes
+#include "api.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// Boost namespace aliases
+namespace fs = boost::filesystem;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::api;
+
+
+BOOST_AUTO_TEST_CASE(test_convert_into_sink)
+{
+    // Write a ROOT file with a simple tree
+    fs::path input_path = fs::temp_directory_path()
+                          / fs::unique_path("%%%%-%%%%-%%%%-%%%%.root");
+    TFile *file = TFile::Open(input_path.c_str(), "RECREATE");
+    BOOST_REQUIRE(file != NULL);
+    TTree *tree = new TTree("Numbers", "Testing Tree");
+    int x;
+    tree->Branch("x", &x, "x/I");
+    for(x = 0; x < 10; x++)
+    {
+        tree->Fill();
+    }
+    file->Write();
+    file->Close();
+    delete file;
+
+    // Convert it straight into a sink, without writing any HDF5 file
+    converter_config config;
+    config.no_cache = true;
+    converter instance(config);
+    size_t row_size = 0, x_offset = 0;
+    hsize_t n_expected = 0, n_received = 0;
+    long long sum = 0;
+    block_sink sink;
+    sink.begin = [&](TTree *converted, hid_t type, hsize_t n_rows) -> bool {
+        BOOST_CHECK_EQUAL(string(converted->GetName()), string("Numbers"));
+        row_size = H5Tget_size(type);
+        x_offset = H5Tget_member_offset(type,
+                                        H5Tget_member_index(type, "x"));
+        n_expected = n_rows;
+        return true;
+    };
+    sink.block = [&](const char *rows, hsize_t n_rows) -> bool {
+        for(hsize_t i = 0; i < n_rows; i++)
+        {
+            int value;
+            memcpy(&value, rows + i * row_size + x_offset, sizeof(int));
+            sum += value;
+        }
+        n_received += n_rows;
+        return true;
+    };
+    conversion_result result = instance.convert_file(input_path.native(),
+                                                     "",
+                                                     sink);
+    BOOST_CHECK(result.success);
+    BOOST_CHECK_EQUAL(n_expected, 10U);
+    BOOST_CHECK_EQUAL(n_received, 10U);
+    BOOST_CHECK_EQUAL(sum, 45);
+
+    // Clean up
+    fs::remove(input_path);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_conversion_errors_are_reported)
+{
+    // A missing input file is reported in the result instead of exiting
+    converter_config config;
+    config.no_cache = true;
+    converter instance(config);
+    fs::path missing_path = fs::temp_directory_path()
+                            / fs::unique_path("%%%%-%%%%-%%%%-%%%%.root");
+    conversion_result result = instance.convert_file(missing_path.native(),
+                                                     "");
+    BOOST_CHECK(!result.success);
+    BOOST_CHECK(result.messages.find("Unable to open input file")
+                != string::npos);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_message_handler)
+{
+    // With a handler, messages are handed over a line at a time instead of
+    // being collected
+    vector<string> lines;
+    converter_config config;
+    config.no_cache = true;
+    config.on_message = [&](const string & line) {
+        lines.push_back(line);
+    };
+    converter instance(config);
+    fs::path missing_path = fs::temp_directory_path()
+                            / fs::unique_path("%%%%-%%%%-%%%%-%%%%.root");
+    conversion_result result = instance.convert_file(missing_path.native(),
+                                                     "");
+    BOOST_CHECK(!result.success);
+    BOOST_CHECK(result.messages.empty());
+    BOOST_REQUIRE(!lines.empty());
+    BOOST_CHECK(lines[0].find("Unable to open input file") != string::npos);
+    BOOST_CHECK(lines[0].find('\n') == string::npos);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_progress_is_refused)
+{
+    // Terminal progress would only pile up in the captured messages
+    converter_config config;
+    config.no_cache = true;
+    config.progress = true;
+    converter instance(config);
+    conversion_result result = instance.convert_file("missing.root", "");
+    BOOST_CHECK(!result.success);
+    BOOST_CHECK(result.messages.find("progress") != string::npos);
+}
@@ -0,0 +1,58 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_batch
+#include <boost/test/unit_test.hpp>
+
+
+// Standard includes
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Boost includes
+#include <boost/filesystem.hpp>
+
+// root2hdf5 includes
+#include "batch.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// Boost namespace aliases
+namespace fs = boost::filesystem;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::batch;
+
+
+BOOST_AUTO_TEST_CASE(test_read_manifest)
+{
+    // Write a manifest with comments and blank lines
+    fs::path manifest_path = fs::temp_directory_path()
+                             / fs::unique_path("%%%%-%%%%-%%%%-%%%%.txt");
+    ofstream manifest(manifest_path.c_str());
+    manifest << "# Comment" << endl
+             << "a.root a.h5" << endl
+             << endl
+             << "   b.root\tb.h5   " << endl;
+    manifest.close();
+
+    // Read it
+    vector<job> jobs;
+    BOOST_REQUIRE(read_manifest(manifest_path.native(), jobs));
+    BOOST_REQUIRE_EQUAL(jobs.size(), 2U);
+    BOOST_CHECK_EQUAL(jobs[0].input_url, string("a.root"));
+    BOOST_CHECK_EQUAL(jobs[0].output_url, string("a.h5"));
+    BOOST_CHECK_EQUAL(jobs[1].input_url, string("b.root"));
+    BOOST_CHECK_EQUAL(jobs[1].output_url, string("b.h5"));
+
+    // A line with a missing output path is malformed
+    manifest.open(manifest_path.c_str());
+    manifest << "c.root" << endl;
+    manifest.close();
+    jobs.clear();
+    BOOST_CHECK(!read_manifest(manifest_path.native(), jobs));
+
+    // Clean up
+    fs::remove(manifest_path);
+}
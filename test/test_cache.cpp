@@ -0,0 +1,115 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_cache
+#include <boost/test/unit_test.hpp>
+
+
+// Standard includes
+#include <fstream>
+#include <string>
+#include <utility>
+
+// Boost includes
+#include <boost/any.hpp>
+#include <boost/program_options.hpp>
+
+// root2hdf5 includes
+#include "options.h"
+#include "cache.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// Boost namespace aliases
+namespace fs = boost::filesystem;
+namespace po = boost::program_options;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::cache;
+
+
+BOOST_AUTO_TEST_CASE(test_hash_string)
+{
+    // Reference values for 64-bit FNV-1a
+    BOOST_CHECK_EQUAL(hash_string(""), string("cbf29ce484222325"));
+    BOOST_CHECK_EQUAL(hash_string("a"), string("af63dc4c8601ec8c"));
+
+    // Different inputs should give different keys
+    BOOST_CHECK(hash_string("vector<int>") != hash_string("vector<float>"));
+}
+
+
+BOOST_AUTO_TEST_CASE(test_layout_round_trip)
+{
+    // Point the cache at a fresh directory
+    fs::path base = fs::temp_directory_path() / fs::unique_path();
+    root2hdf5::options::options.insert(
+        make_pair("cache-dir",
+                  po::variable_value(boost::any(base.native()), false))
+    );
+    fs::path directory = cache_directory();
+    BOOST_REQUIRE(!directory.empty());
+
+    // Nothing should be there to begin with
+    size_t value = 0;
+    BOOST_CHECK(!lookup_layout_value("tree_test", "sizeof", value));
+
+    // Store a couple of values and look them up again
+    store_layout_value("tree_test", "sizeof", 24);
+    store_layout_value("tree_test", "offsetof:branch.x", 8);
+    BOOST_REQUIRE(lookup_layout_value("tree_test", "sizeof", value));
+    BOOST_CHECK_EQUAL(value, 24u);
+    BOOST_REQUIRE(lookup_layout_value("tree_test", "offsetof:branch.x", value));
+    BOOST_CHECK_EQUAL(value, 8u);
+    BOOST_CHECK(!lookup_layout_value("tree_other", "sizeof", value));
+
+    // And they should have been written through to disk for the next run
+    ifstream input(
+        (directory / (hash_string("tree_test") + ".layout")).c_str()
+    );
+    string key;
+    size_t stored = 0;
+    BOOST_REQUIRE(input >> key >> stored);
+    BOOST_CHECK_EQUAL(key, "sizeof");
+    BOOST_CHECK_EQUAL(stored, 24u);
+    BOOST_REQUIRE(input >> key >> stored);
+    BOOST_CHECK_EQUAL(key, "offsetof:branch.x");
+    BOOST_CHECK_EQUAL(stored, 8u);
+    input.close();
+
+    fs::remove_all(base);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_cache_directory_follows_options)
+{
+    // Each change of options should be picked up, as happens when the API
+    // converts with different configurations in one process
+    fs::path first = fs::temp_directory_path() / fs::unique_path();
+    fs::path second = fs::temp_directory_path() / fs::unique_path();
+    root2hdf5::options::options.clear();
+    root2hdf5::options::options.insert(
+        make_pair("cache-dir",
+                  po::variable_value(boost::any(first.native()), false))
+    );
+    fs::path directory = cache_directory();
+    BOOST_CHECK_EQUAL(directory.parent_path(), first);
+
+    root2hdf5::options::options.clear();
+    root2hdf5::options::options.insert(
+        make_pair("cache-dir",
+                  po::variable_value(boost::any(second.native()), false))
+    );
+    directory = cache_directory();
+    BOOST_CHECK_EQUAL(directory.parent_path(), second);
+
+    // Disabling the cache leaves no directory
+    root2hdf5::options::options.insert(
+        make_pair("no-cache", po::variable_value(boost::any(), false))
+    );
+    BOOST_CHECK(cache_directory().empty());
+
+    root2hdf5::options::options.clear();
+    fs::remove_all(first);
+    fs::remove_all(second);
+}
@@ -0,0 +1,196 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_histogram
+#include <boost/test/unit_test.hpp>
+
+
+// Standard includes
+#include <string>
+#include <vector>
+
+// ROOT includes
+#include <TH1F.h>
+#include <TH2D.h>
+#include <THnSparse.h>
+#include <TProfile.h>
+
+// HDF5 includes
+#include <hdf5.h>
+
+// root2hdf5 includes
+#include "histogram.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::histogram;
+
+
+// Creates an HDF5 file which only lives in memory
+hid_t create_memory_file()
+{
+    hid_t access = H5Pcreate(H5P_FILE_ACCESS);
+    H5Pset_fapl_core(access, 64 * 1024, 0);
+    hid_t file = H5Fcreate("test_histogram",
+                           H5F_ACC_TRUNC,
+                           H5P_DEFAULT,
+                           access);
+    H5Pclose(access);
+    return file;
+}
+
+
+// Reads a dataset as doubles, along with its shape
+vector<double> read_doubles(hid_t file,
+                            const string & path,
+                            vector<hsize_t> & dimensions)
+{
+    vector<double> result;
+    hid_t dataset = H5Dopen2(file, path.c_str(), H5P_DEFAULT);
+    BOOST_REQUIRE(dataset >= 0);
+    hid_t space = H5Dget_space(dataset);
+    dimensions.resize(H5Sget_simple_extent_ndims(space));
+    H5Sget_simple_extent_dims(space, &dimensions[0], NULL);
+    result.resize(H5Sget_simple_extent_npoints(space));
+    BOOST_REQUIRE(H5Dread(dataset,
+                          H5T_NATIVE_DOUBLE,
+                          H5S_ALL,
+                          H5S_ALL,
+                          H5P_DEFAULT,
+                          &result[0]) >= 0);
+    H5Sclose(space);
+    H5Dclose(dataset);
+    return result;
+}
+
+
+BOOST_AUTO_TEST_CASE(test_convert_th1f)
+{
+    TH1F histogram("h1", "Testing Histogram", 4, 0.0, 4.0);
+    histogram.Sumw2();
+    histogram.Fill(0.5);
+    histogram.Fill(1.5, 2.0);
+    histogram.Fill(7.0);
+
+    hid_t file = create_memory_file();
+    BOOST_REQUIRE(file >= 0);
+    BOOST_REQUIRE(convert(&histogram, file));
+
+    // Contents and squared weights include the underflow and overflow bins
+    vector<hsize_t> dimensions;
+    vector<double> contents = read_doubles(file, "h1/contents", dimensions);
+    BOOST_REQUIRE_EQUAL(dimensions.size(), 1u);
+    BOOST_CHECK_EQUAL(dimensions[0], 6u);
+    double expected_contents[6] = {0.0, 1.0, 2.0, 0.0, 0.0, 1.0};
+    BOOST_CHECK_EQUAL_COLLECTIONS(contents.begin(), contents.end(),
+                                  expected_contents, expected_contents + 6);
+    vector<double> sumw2 = read_doubles(file, "h1/sumw2", dimensions);
+    double expected_sumw2[6] = {0.0, 1.0, 4.0, 0.0, 0.0, 1.0};
+    BOOST_CHECK_EQUAL_COLLECTIONS(sumw2.begin(), sumw2.end(),
+                                  expected_sumw2, expected_sumw2 + 6);
+
+    // The edges cover the regular bins only
+    vector<double> edges = read_doubles(file, "h1/x_edges", dimensions);
+    double expected_edges[5] = {0.0, 1.0, 2.0, 3.0, 4.0};
+    BOOST_CHECK_EQUAL_COLLECTIONS(edges.begin(), edges.end(),
+                                  expected_edges, expected_edges + 5);
+
+    H5Fclose(file);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_convert_th2d)
+{
+    TH2D histogram("h2", "Testing Histogram", 2, 0.0, 2.0, 3, 0.0, 3.0);
+    histogram.Sumw2();
+    histogram.Fill(0.5, 2.5, 3.0);
+
+    hid_t file = create_memory_file();
+    BOOST_REQUIRE(file >= 0);
+    BOOST_REQUIRE(convert(&histogram, file));
+
+    // The y axis varies slowest, so bin (x = 1, y = 3) is at [3][1]
+    vector<hsize_t> dimensions;
+    vector<double> contents = read_doubles(file, "h2/contents", dimensions);
+    BOOST_REQUIRE_EQUAL(dimensions.size(), 2u);
+    BOOST_CHECK_EQUAL(dimensions[0], 5u);
+    BOOST_CHECK_EQUAL(dimensions[1], 4u);
+    for(size_t i = 0; i < contents.size(); i++)
+    {
+        BOOST_CHECK_EQUAL(contents[i], i == 3 * 4 + 1 ? 3.0 : 0.0);
+    }
+    vector<double> sumw2 = read_doubles(file, "h2/sumw2", dimensions);
+    BOOST_CHECK_EQUAL(sumw2[3 * 4 + 1], 9.0);
+
+    vector<double> x_edges = read_doubles(file, "h2/x_edges", dimensions);
+    BOOST_CHECK_EQUAL(x_edges.size(), 3u);
+    vector<double> y_edges = read_doubles(file, "h2/y_edges", dimensions);
+    BOOST_REQUIRE_EQUAL(y_edges.size(), 4u);
+    BOOST_CHECK_EQUAL(y_edges[3], 3.0);
+
+    H5Fclose(file);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_convert_thnsparse)
+{
+    Int_t bins[2] = {4, 4};
+    Double_t minima[2] = {0.0, 0.0};
+    Double_t maxima[2] = {4.0, 4.0};
+    THnSparseD histogram("hn", "Testing Histogram", 2, bins, minima, maxima);
+    histogram.Sumw2();
+    Double_t point[2] = {1.5, 2.5};
+    histogram.Fill(point, 2.0);
+
+    hid_t file = create_memory_file();
+    BOOST_REQUIRE(file >= 0);
+    BOOST_REQUIRE(convert(&histogram, file));
+
+    // Only the filled bin is written, with its bin index along each axis
+    vector<hsize_t> dimensions;
+    vector<double> coordinates = read_doubles(file,
+                                              "hn/coordinates",
+                                              dimensions);
+    BOOST_REQUIRE_EQUAL(dimensions.size(), 2u);
+    BOOST_CHECK_EQUAL(dimensions[0], 1u);
+    BOOST_CHECK_EQUAL(dimensions[1], 2u);
+    BOOST_CHECK_EQUAL(coordinates[0], 2.0);
+    BOOST_CHECK_EQUAL(coordinates[1], 3.0);
+    vector<double> values = read_doubles(file, "hn/values", dimensions);
+    BOOST_REQUIRE_EQUAL(values.size(), 1u);
+    BOOST_CHECK_EQUAL(values[0], 2.0);
+    vector<double> sumw2 = read_doubles(file, "hn/sumw2", dimensions);
+    BOOST_REQUIRE_EQUAL(sumw2.size(), 1u);
+    BOOST_CHECK_EQUAL(sumw2[0], 4.0);
+    vector<double> edges = read_doubles(file, "hn/axis_1_edges", dimensions);
+    BOOST_CHECK_EQUAL(edges.size(), 5u);
+
+    H5Fclose(file);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_convert_tprofile)
+{
+    TProfile histogram("hp", "Testing Profile", 2, 0.0, 2.0);
+    histogram.Fill(0.5, 3.0);
+    histogram.Fill(0.5, 5.0);
+
+    hid_t file = create_memory_file();
+    BOOST_REQUIRE(file >= 0);
+    BOOST_REQUIRE(convert(&histogram, file));
+
+    // The raw sums are kept apart from the means and sums of weights
+    vector<hsize_t> dimensions;
+    vector<double> sum_wy = read_doubles(file, "hp/sum_wy", dimensions);
+    BOOST_CHECK_EQUAL(sum_wy[1], 8.0);
+    vector<double> sum_wy2 = read_doubles(file, "hp/sum_wy2", dimensions);
+    BOOST_CHECK_EQUAL(sum_wy2[1], 34.0);
+    vector<double> contents = read_doubles(file, "hp/contents", dimensions);
+    BOOST_CHECK_EQUAL(contents[1], 4.0);
+    vector<double> entries = read_doubles(file, "hp/entries", dimensions);
+    BOOST_CHECK_EQUAL(entries[1], 2.0);
+    BOOST_CHECK_EQUAL(entries[2], 0.0);
+
+    H5Fclose(file);
+}
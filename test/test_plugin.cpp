@@ -0,0 +1,146 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_plugin
+#include <boost/test/unit_test.hpp>
+
+
+// Standard includes
+#include <string>
+#include <utility>
+
+// Boost includes
+// HACK: Need to define this macro to tell Boost not to use deprecated
+// Boost.System constructs which result in unused-variable errors.
+#ifndef BOOST_SYSTEM_NO_DEPRECATED
+#define BOOST_SYSTEM_NO_DEPRECATED 1
+#endif
+#include <boost/any.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+// ROOT includes
+#include <TTree.h>
+#include <TLeaf.h>
+
+// root2hdf5 includes
+#include "options.h"
+#include "plugin.h"
+#include "tree/leaf_converters.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// Boost namespace aliases
+namespace fs = boost::filesystem;
+namespace po = boost::program_options;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::plugin;
+using namespace root2hdf5::tree::leaf_converters;
+
+
+void set_plugin_dir(const string & directory)
+{
+    root2hdf5::options::options.clear();
+    root2hdf5::options::options.insert(
+        make_pair("converter-plugin-dir",
+                  po::variable_value(boost::any(directory), false))
+    );
+}
+
+
+BOOST_AUTO_TEST_CASE(test_plugin_directory)
+{
+    // Without --converter-plugin-dir, there is nothing to load
+    root2hdf5::options::options.clear();
+    BOOST_CHECK(converter_plugin_dir().empty());
+    BOOST_CHECK(load_converter_plugins());
+
+    // A directory without any libraries is fine
+    fs::path directory = fs::temp_directory_path() / fs::unique_path();
+    fs::create_directories(directory);
+    set_plugin_dir(directory.native());
+    BOOST_CHECK_EQUAL(converter_plugin_dir(), directory.native());
+    BOOST_CHECK(load_converter_plugins());
+
+    // But one that can't be listed isn't
+    fs::remove_all(directory);
+    BOOST_CHECK(!load_converter_plugins());
+    root2hdf5::options::options.clear();
+}
+
+
+BOOST_AUTO_TEST_CASE(test_registered_converter_priority)
+{
+    TTree *tree = new TTree("PluginTree", "Testing Tree");
+    int x = 0;
+    float y = 0;
+    tree->Branch("x", &x, "x/I");
+    tree->Branch("y", &y, "y/F");
+    tree->Fill();
+    TLeaf *x_leaf = tree->GetLeaf("x");
+    TLeaf *y_leaf = tree->GetLeaf("y");
+
+    // The built-in scalar converter handles both leaves to begin with
+    leaf_converter *converter = find_converter(x_leaf);
+    BOOST_REQUIRE(converter != NULL);
+    BOOST_CHECK_EQUAL(converter->name, "scalar");
+
+    // A registered converter takes over the leaves it can handle, and only
+    // those
+    leaf_converter custom = *converter;
+    custom.name = "custom_int";
+    custom.can_handle = [](TLeaf *leaf) -> bool {
+        return string(leaf->GetTypeName()) == "Int_t";
+    };
+    register_converter(custom);
+    converter = find_converter(x_leaf);
+    BOOST_REQUIRE(converter != NULL);
+    BOOST_CHECK_EQUAL(converter->name, "custom_int");
+    converter = find_converter(y_leaf);
+    BOOST_REQUIRE(converter != NULL);
+    BOOST_CHECK_EQUAL(converter->name, "scalar");
+
+    delete tree;
+}
+
+
+BOOST_AUTO_TEST_CASE(test_plugin_fixtures)
+{
+    fs::path fixtures(PLUGIN_FIXTURE_DIR);
+
+    // Plugins built against another ABI version are refused
+    set_plugin_dir((fixtures / "abi").native());
+    BOOST_CHECK(!load_converter_plugins());
+
+    // As are libraries without the registration function
+    set_plugin_dir((fixtures / "symbol").native());
+    BOOST_CHECK(!load_converter_plugins());
+
+    // And plugins handing over converters without every required callback
+    set_plugin_dir((fixtures / "incomplete").native());
+    BOOST_CHECK(!load_converter_plugins());
+
+    // A working plugin's converter takes over the leaves it handles
+    set_plugin_dir((fixtures / "good").native());
+    BOOST_REQUIRE(load_converter_plugins());
+    TTree *tree = new TTree("FixtureTree", "Testing Tree");
+    float fixture = 0, y = 0;
+    tree->Branch("plugin_fixture", &fixture, "plugin_fixture/F");
+    tree->Branch("y", &y, "y/F");
+    tree->Fill();
+    leaf_converter *converter = find_converter(
+        tree->GetLeaf("plugin_fixture")
+    );
+    BOOST_REQUIRE(converter != NULL);
+    BOOST_CHECK_EQUAL(converter->name, "plugin_fixture");
+    converter = find_converter(tree->GetLeaf("y"));
+    BOOST_REQUIRE(converter != NULL);
+    BOOST_CHECK_EQUAL(converter->name, "scalar");
+
+    // Libraries are only loaded once
+    BOOST_CHECK(load_converter_plugins());
+
+    delete tree;
+    root2hdf5::options::options.clear();
+}
@@ -0,0 +1,76 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_progress
+#include <boost/test/unit_test.hpp>
+
+
+// Standard includes
+#include <fstream>
+#include <string>
+#include <utility>
+
+// Boost includes
+#include <boost/any.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+// root2hdf5 includes
+#include "options.h"
+#include "progress.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// Boost namespace aliases
+namespace fs = boost::filesystem;
+namespace po = boost::program_options;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::progress;
+
+
+// Reads the state line of a status file
+string status_state(const fs::path & path)
+{
+    ifstream status(path.c_str());
+    string line;
+    while(getline(status, line))
+    {
+        if(line.compare(0, 6, "state ") == 0)
+        {
+            return line.substr(6);
+        }
+    }
+
+    return string();
+}
+
+
+BOOST_AUTO_TEST_CASE(test_status_file_outcome)
+{
+    fs::path path = fs::temp_directory_path()
+                    / fs::unique_path("%%%%-%%%%-%%%%-%%%%.status");
+    root2hdf5::options::options.clear();
+    root2hdf5::options::options.insert(
+        make_pair("status-file",
+                  po::variable_value(boost::any(path.native()), false))
+    );
+
+    // A scope which ends early, e.g. by an error return, reports failure
+    {
+        progress_scope progress("Failing", 10);
+        add_entries(3);
+    }
+    BOOST_CHECK_EQUAL(status_state(path), "failed");
+
+    // One which is marked as succeeded reports that it is done
+    {
+        progress_scope progress("Succeeding", 10);
+        add_entries(10);
+        progress.succeeded();
+    }
+    BOOST_CHECK_EQUAL(status_state(path), "done");
+
+    root2hdf5::options::options.clear();
+    fs::remove(path);
+}
@@ -0,0 +1,107 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_rollover
+#include <boost/test/unit_test.hpp>
+
+
+// Standard includes
+#include <string>
+#include <vector>
+
+// Boost includes
+#include <boost/filesystem.hpp>
+
+// ROOT includes
+#include <TTree.h>
+
+// HDF5 includes
+#include <hdf5.h>
+
+// root2hdf5 includes
+#include "rollover.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// Boost namespace aliases
+namespace fs = boost::filesystem;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree;
+using namespace root2hdf5::rollover;
+
+
+BOOST_AUTO_TEST_CASE(test_part_path)
+{
+    BOOST_CHECK_EQUAL(part_path("out.h5", 1), "out.0001.h5");
+    BOOST_CHECK_EQUAL(part_path("/data/run.h5", 12), "/data/run.0012.h5");
+}
+
+
+BOOST_AUTO_TEST_CASE(test_rollover_sink)
+{
+    // Create the index file
+    fs::path directory = fs::temp_directory_path()
+                         / fs::unique_path("%%%%-%%%%-%%%%-%%%%");
+    fs::create_directory(directory);
+    string output_url = (directory / "out.h5").native();
+    hid_t index_file = H5Fcreate(output_url.c_str(),
+                                 H5F_ACC_TRUNC,
+                                 H5P_DEFAULT,
+                                 H5P_DEFAULT);
+    BOOST_REQUIRE(index_file >= 0);
+
+    // With a tiny limit, every block after the first starts a new part
+    tree_sink sink;
+    rollover_closer closer;
+    boost::tie(sink, closer) = build_rollover_sink(output_url,
+                                                   index_file,
+                                                   1,
+                                                   tree_sink());
+    BOOST_CHECK(!sink.write_dataset);
+    TTree *tree = new TTree("RollTree", "Testing Tree");
+    hid_t row_type = H5Tcreate(H5T_COMPOUND, sizeof(int));
+    H5Tinsert(row_type, "x", 0, H5T_NATIVE_INT);
+    BOOST_REQUIRE(sink.begin(tree, row_type, 30));
+    vector<int> rows(10);
+    for(int block = 0; block < 3; block++)
+    {
+        for(int i = 0; i < 10; i++)
+        {
+            rows[i] = 10 * block + i;
+        }
+        BOOST_REQUIRE(sink.block((const char *)&rows[0], 10));
+    }
+    BOOST_REQUIRE(sink.end(tree));
+    BOOST_CHECK(closer());
+    for(unsigned part = 1; part <= 3; part++)
+    {
+        BOOST_CHECK(fs::exists(part_path(output_url, part)));
+    }
+    BOOST_CHECK(!fs::exists(part_path(output_url, 4)));
+
+    // The virtual dataset reads back as one continuous tree
+    BOOST_REQUIRE(H5Fclose(index_file) >= 0);
+    index_file = H5Fopen(output_url.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    BOOST_REQUIRE(index_file >= 0);
+    hid_t dataset = H5Dopen2(index_file, "RollTree", H5P_DEFAULT);
+    BOOST_REQUIRE(dataset >= 0);
+    vector<int> values(30, -1);
+    BOOST_REQUIRE(H5Dread(dataset,
+                          row_type,
+                          H5S_ALL,
+                          H5S_ALL,
+                          H5P_DEFAULT,
+                          &values[0]) >= 0);
+    for(int i = 0; i < 30; i++)
+    {
+        BOOST_CHECK_EQUAL(values[i], i);
+    }
+
+    // Clean up
+    H5Dclose(dataset);
+    H5Fclose(index_file);
+    H5Tclose(row_type);
+    delete tree;
+    fs::remove_all(directory);
+}
@@ -0,0 +1,61 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_tree_array_converter
+#include <boost/test/unit_test.hpp>
+
+
+// Standard includes
+#include <string>
+#include <vector>
+
+// ROOT includes
+#include <TTree.h>
+
+// root2hdf5 includes
+#include "tree/leaf_converters/array_converter.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::leaf_converters::array_converter;
+
+
+BOOST_AUTO_TEST_CASE(test_static_dimensions_for_leaf)
+{
+    // First, create a TTree to experiment with
+    TTree *tree = new TTree("TestTree", "Testing Tree");
+
+    // Create some array branches
+    float x[16];
+    tree->Branch("x", x, "x[16]/F");
+    double cov[5][5];
+    tree->Branch("cov", cov, "cov[5][5]/D");
+    int scalar;
+    tree->Branch("scalar", &scalar, "scalar/I");
+
+    // 1-D
+    TLeaf *leaf = tree->GetLeaf("x");
+    BOOST_REQUIRE(can_handle(leaf));
+    vector<hsize_t> dimensions = static_dimensions_for_leaf(leaf);
+    BOOST_REQUIRE_EQUAL(dimensions.size(), 1U);
+    BOOST_CHECK_EQUAL(dimensions[0], 16U);
+    BOOST_CHECK_EQUAL(member_for_conversion_struct(leaf),
+                      string("Float_t x[16];"));
+
+    // 2-D
+    leaf = tree->GetLeaf("cov");
+    BOOST_REQUIRE(can_handle(leaf));
+    dimensions = static_dimensions_for_leaf(leaf);
+    BOOST_REQUIRE_EQUAL(dimensions.size(), 2U);
+    BOOST_CHECK_EQUAL(dimensions[0], 5U);
+    BOOST_CHECK_EQUAL(dimensions[1], 5U);
+    BOOST_CHECK_EQUAL(member_for_conversion_struct(leaf),
+                      string("Double_t cov[5][5];"));
+
+    // Scalars aren't arrays
+    BOOST_CHECK(!can_handle(tree->GetLeaf("scalar")));
+
+    // Clean up the tree
+    delete tree;
+}
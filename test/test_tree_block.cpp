@@ -0,0 +1,90 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_tree_block
+#include <boost/test/unit_test.hpp>
+
+
+// C Standard includes
+#include <cstring>
+
+// Standard includes
+#include <string>
+#include <vector>
+
+// root2hdf5 includes
+#include "tree/block.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::block;
+
+
+struct Row
+{
+    int scalar;
+    hvl_t values;
+    char *label;
+};
+
+
+BOOST_AUTO_TEST_CASE(test_rows_per_block)
+{
+    BOOST_CHECK_EQUAL(rows_per_block(16, 10), 10U);
+    BOOST_CHECK_EQUAL(rows_per_block(16, 1000000), target_block_bytes / 16);
+    BOOST_CHECK_EQUAL(rows_per_block(2 * target_block_bytes, 10), 1U);
+    BOOST_CHECK_EQUAL(rows_per_block(16, 0), 1U);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_stage_variable_length_data)
+{
+    // Create an HDF5 type matching the row
+    hid_t values_type = H5Tvlen_create(H5T_NATIVE_FLOAT);
+    hid_t label_type = H5Tcopy(H5T_C_S1);
+    H5Tset_size(label_type, H5T_VARIABLE);
+    hid_t row_type = H5Tcreate(H5T_COMPOUND, sizeof(Row));
+    H5Tinsert(row_type, "scalar", HOFFSET(Row, scalar), H5T_NATIVE_INT);
+    H5Tinsert(row_type, "values", HOFFSET(Row, values), values_type);
+    H5Tinsert(row_type, "label", HOFFSET(Row, label), label_type);
+
+    // Check that the variable-length members are found
+    vector<variable_length_member> members = variable_length_members(row_type);
+    BOOST_REQUIRE_EQUAL(members.size(), 2U);
+    BOOST_CHECK_EQUAL(members[0].offset, HOFFSET(Row, values));
+    BOOST_CHECK(!members[0].is_string);
+    BOOST_CHECK_EQUAL(members[0].element_size, sizeof(float));
+    BOOST_CHECK_EQUAL(members[1].offset, HOFFSET(Row, label));
+    BOOST_CHECK(members[1].is_string);
+
+    // Stage a row and make sure it no longer points at the original data
+    float values[3] = {1.0f, 2.0f, 3.0f};
+    char label[] = "muon";
+    Row row;
+    row.scalar = 7;
+    row.values.len = 3;
+    row.values.p = values;
+    row.label = label;
+    variable_length_arena arena;
+    stage_variable_length_data(members, (char *)&row, arena);
+    values[0] = 0.0f;
+    label[0] = 'x';
+    BOOST_CHECK_EQUAL(row.scalar, 7);
+    BOOST_REQUIRE_EQUAL(row.values.len, 3U);
+    BOOST_CHECK(row.values.p != values);
+    BOOST_CHECK_EQUAL(((float *)row.values.p)[0], 1.0f);
+    BOOST_CHECK_EQUAL(((float *)row.values.p)[2], 3.0f);
+    BOOST_CHECK(row.label != label);
+    BOOST_CHECK_EQUAL(string(row.label), string("muon"));
+
+    // Memory is reused after a reset
+    arena_reset(arena);
+    BOOST_CHECK(arena_allocate(arena, 8) == &arena.chunks[0][0]);
+    BOOST_CHECK_EQUAL(arena.chunks.size(), 1U);
+
+    // Clean up
+    H5Tclose(row_type);
+    H5Tclose(label_type);
+    H5Tclose(values_type);
+}
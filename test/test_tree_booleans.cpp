@@ -0,0 +1,227 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_tree_booleans
+#include <boost/test/unit_test.hpp>
+
+
+// C Standard includes
+#include <cstring>
+#include <stdint.h>
+
+// Standard includes
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// ROOT includes
+#include <TTree.h>
+
+// HDF5 includes
+#include <hdf5.h>
+
+// root2hdf5 includes
+#include "tree/booleans.h"
+#include "tree/pack.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::split;
+using namespace root2hdf5::tree::pack;
+using namespace root2hdf5::tree::booleans;
+
+
+struct Quality
+{
+    char good;
+    char bad;
+};
+
+
+struct Row
+{
+    char trigger;
+    double x;
+    Quality quality;
+};
+
+
+hid_t create_row_type()
+{
+    hid_t quality = H5Tcreate(H5T_COMPOUND, sizeof(Quality));
+    H5Tinsert(quality, "good", offsetof(Quality, good), H5T_NATIVE_SCHAR);
+    H5Tinsert(quality, "bad", offsetof(Quality, bad), H5T_NATIVE_SCHAR);
+    hid_t type = H5Tcreate(H5T_COMPOUND, sizeof(Row));
+    H5Tinsert(type, "trigger", offsetof(Row, trigger), H5T_NATIVE_SCHAR);
+    H5Tinsert(type, "x", offsetof(Row, x), H5T_NATIVE_DOUBLE);
+    H5Tinsert(type, "quality", offsetof(Row, quality), quality);
+    H5Tclose(quality);
+    return type;
+}
+
+
+BOOST_AUTO_TEST_CASE(test_boolean_leaf_paths)
+{
+    // Single-leaf branches are just their leaf, while the leaves of other
+    // branches are nested under the branch
+    TTree *tree = new TTree("BooleanTree", "Testing Tree");
+    bool trigger = false;
+    int n = 0;
+    Quality quality = {0, 0};
+    tree->Branch("trigger", &trigger, "trigger/O");
+    tree->Branch("n", &n, "n/I");
+    tree->Branch("quality", &quality, "good/O:bad/O");
+    vector<string> paths = boolean_leaf_paths(tree);
+    BOOST_REQUIRE_EQUAL(paths.size(), 3U);
+    BOOST_CHECK_EQUAL(paths[0], "trigger");
+    BOOST_CHECK_EQUAL(paths[1], "quality.good");
+    BOOST_CHECK_EQUAL(paths[2], "quality.bad");
+    delete tree;
+}
+
+
+BOOST_AUTO_TEST_CASE(test_bitfield_type)
+{
+    size_t sizes[][2] = {{1, 1}, {8, 1}, {9, 2}, {32, 4}, {64, 8}, {65, 16}};
+    for(size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        hid_t type = bitfield_type(sizes[i][0]);
+        BOOST_REQUIRE(type >= 0);
+        BOOST_CHECK_EQUAL(H5Tget_size(type), sizes[i][1]);
+        H5Tclose(type);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(test_pack_booleans)
+{
+    // Every boolean goes, taking the now empty quality compound with it
+    hid_t type = create_row_type();
+    vector<string> paths;
+    paths.push_back("trigger");
+    paths.push_back("quality.good");
+    paths.push_back("quality.bad");
+    packed_layout layout;
+    vector<string> bit_paths;
+    hid_t file_type = file_type_for_column_group(type,
+                                                 column_group(),
+                                                 paths,
+                                                 layout,
+                                                 bit_paths);
+    BOOST_REQUIRE(file_type >= 0);
+    BOOST_CHECK_EQUAL(H5Tget_nmembers(file_type), 2);
+    BOOST_CHECK_EQUAL(H5Tget_size(file_type), sizeof(double) + 1);
+    BOOST_CHECK(H5Tget_member_index(file_type, "quality") < 0);
+    BOOST_REQUIRE_EQUAL(bit_paths.size(), 3U);
+    BOOST_CHECK_EQUAL(bit_paths[0], "trigger");
+    BOOST_CHECK_EQUAL(bit_paths[2], "quality.bad");
+
+    // Gather rows and check the bits
+    Row rows[4];
+    memset(rows, 0, sizeof(rows));
+    for(int i = 0; i < 4; i++)
+    {
+        rows[i].trigger = (char)(i & 1);
+        rows[i].x = 0.25 * i;
+        rows[i].quality.good = (char)((i >> 1) & 1);
+        rows[i].quality.bad = (char)(i == 3 ? 7 : 0);
+    }
+    vector<char> buffer(4 * layout.packed_size);
+    gather_rows(layout, (const char *)rows, 4, &buffer[0]);
+    const uint8_t expected[4] = {0x0, 0x1, 0x2, 0x7};
+    for(int i = 0; i < 4; i++)
+    {
+        double x = 0.0;
+        memcpy(&x, &buffer[i * layout.packed_size], sizeof(double));
+        BOOST_CHECK_EQUAL(x, rows[i].x);
+        BOOST_CHECK_EQUAL(
+            (unsigned)(uint8_t)buffer[i * layout.packed_size + sizeof(double)],
+            (unsigned)expected[i]
+        );
+    }
+
+    H5Tclose(file_type);
+    H5Tclose(type);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_pack_booleans_across_blocks)
+{
+    // Gather enough rows that the bits are packed in several blocks, the
+    // last one partial
+    hid_t type = create_row_type();
+    vector<string> paths;
+    paths.push_back("trigger");
+    paths.push_back("quality.good");
+    paths.push_back("quality.bad");
+    packed_layout layout;
+    vector<string> bit_paths;
+    hid_t file_type = file_type_for_column_group(type,
+                                                 column_group(),
+                                                 paths,
+                                                 layout,
+                                                 bit_paths);
+    BOOST_REQUIRE(file_type >= 0);
+    const int n_rows = 1000;
+    vector<Row> rows(n_rows);
+    for(int i = 0; i < n_rows; i++)
+    {
+        memset(&rows[i], 0, sizeof(Row));
+        rows[i].trigger = (char)(i % 3 == 0);
+        rows[i].x = i;
+        rows[i].quality.good = (char)(i % 5 == 0);
+        rows[i].quality.bad = (char)(i % 7 == 0 ? 2 : 0);
+    }
+    vector<char> buffer(n_rows * layout.packed_size);
+    gather_rows(layout, (const char *)&rows[0], n_rows, &buffer[0]);
+    for(int i = 0; i < n_rows; i++)
+    {
+        unsigned expected = (i % 3 == 0) | (i % 5 == 0) << 1
+                            | (i % 7 == 0) << 2;
+        BOOST_CHECK_EQUAL(
+            (unsigned)(uint8_t)buffer[i * layout.packed_size + sizeof(double)],
+            expected
+        );
+    }
+
+    H5Tclose(file_type);
+    H5Tclose(type);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_bits_attribute)
+{
+    hid_t access = H5Pcreate(H5P_FILE_ACCESS);
+    H5Pset_fapl_core(access, 1024 * 1024, 0);
+    hid_t file = H5Fcreate("test_tree_booleans.h5",
+                           H5F_ACC_TRUNC,
+                           H5P_DEFAULT,
+                           access);
+    BOOST_REQUIRE(file >= 0);
+    hsize_t n_rows = 1;
+    hid_t space = H5Screate_simple(1, &n_rows, NULL);
+    hid_t dataset = H5Dcreate2(file,
+                               "flags",
+                               H5T_NATIVE_B8,
+                               space,
+                               H5P_DEFAULT,
+                               H5P_DEFAULT,
+                               H5P_DEFAULT);
+    BOOST_REQUIRE(dataset >= 0);
+    vector<string> paths;
+    paths.push_back("trigger");
+    paths.push_back("quality.good");
+    BOOST_REQUIRE(write_bits_attribute(dataset, paths));
+    hid_t attribute = H5Aopen(dataset, bits_attribute_name, H5P_DEFAULT);
+    BOOST_REQUIRE(attribute >= 0);
+    hid_t attribute_space = H5Aget_space(attribute);
+    BOOST_CHECK_EQUAL(H5Sget_simple_extent_npoints(attribute_space), 2);
+
+    H5Sclose(attribute_space);
+    H5Aclose(attribute);
+    H5Dclose(dataset);
+    H5Sclose(space);
+    H5Fclose(file);
+    H5Pclose(access);
+}
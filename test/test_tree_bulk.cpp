@@ -0,0 +1,199 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_tree_bulk
+#include <boost/test/unit_test.hpp>
+
+
+// Standard includes
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Boost includes
+#include <boost/filesystem.hpp>
+
+// ROOT includes
+#include <TFile.h>
+#include <TLeaf.h>
+#include <TTree.h>
+
+// HDF5 includes
+#include <hdf5.h>
+
+// root2hdf5 includes
+#include "tree/bulk.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// Boost namespace aliases
+namespace fs = boost::filesystem;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::map_root;
+using namespace root2hdf5::tree::bulk;
+
+
+struct Row
+{
+    int x;
+    float y;
+};
+
+
+BOOST_AUTO_TEST_CASE(test_bulk_read_scalar_branches)
+{
+    // Write a flat tree with small baskets, so that reads span several
+    fs::path path = fs::temp_directory_path()
+                    / fs::unique_path("%%%%-%%%%-%%%%-%%%%.root");
+    TFile *file = TFile::Open(path.c_str(), "RECREATE");
+    BOOST_REQUIRE(file != NULL);
+    TTree *tree = new TTree("BulkTree", "Testing Tree");
+    int x;
+    float y;
+    tree->Branch("x", &x, "x/I", 64);
+    tree->Branch("y", &y, "y/F", 64);
+    for(x = 0; x < 100; x++)
+    {
+        y = 0.5f * x;
+        tree->Fill();
+    }
+    file->Write();
+    file->Close();
+    delete file;
+
+    // Read it back
+    file = TFile::Open(path.c_str(), "READ");
+    BOOST_REQUIRE(file != NULL);
+    tree = (TTree *)file->Get("BulkTree");
+    BOOST_REQUIRE(tree != NULL);
+    hid_t row_type = H5Tcreate(H5T_COMPOUND, sizeof(Row));
+    H5Tinsert(row_type, "x", offsetof(Row, x), H5T_NATIVE_INT);
+    H5Tinsert(row_type, "y", offsetof(Row, y), H5T_NATIVE_FLOAT);
+
+    // Every branch is scalar, so entries needn't be read one by one
+    bool success = false, needs_entry_reads = true;
+    block_filler filler;
+    root_resource_deallocator deallocator;
+    hid_t written_type = -1;
+    boost::tie(success, filler, deallocator, needs_entry_reads, written_type)
+        = build_bulk_reader(tree, row_type, vector<string>(), false);
+    BOOST_REQUIRE(success);
+    BOOST_REQUIRE(filler);
+    BOOST_CHECK(!needs_entry_reads);
+    BOOST_CHECK(written_type < 0);
+
+    // Fill rows out of order and across baskets
+    const Long64_t entries[] = {3, 97, 40, 41, 0};
+    Row rows[5];
+    BOOST_REQUIRE(filler(entries, 5, (char *)rows));
+    for(int i = 0; i < 5; i++)
+    {
+        BOOST_CHECK_EQUAL(rows[i].x, entries[i]);
+        BOOST_CHECK_EQUAL(rows[i].y, 0.5f * entries[i]);
+    }
+    BOOST_CHECK(deallocator());
+
+    // Big-endian output leaves the values as ROOT stores them, and says so
+    // in the written type
+    boost::tie(success, filler, deallocator, needs_entry_reads, written_type)
+        = build_bulk_reader(tree, row_type, vector<string>(), true);
+    BOOST_REQUIRE(success);
+    BOOST_REQUIRE(written_type >= 0);
+    hid_t x_type = H5Tget_member_type(written_type,
+                                      H5Tget_member_index(written_type, "x"));
+    BOOST_CHECK_EQUAL(H5Tget_order(x_type), H5T_ORDER_BE);
+    H5Tclose(x_type);
+    BOOST_REQUIRE(filler(entries, 5, (char *)rows));
+    BOOST_CHECK_EQUAL(rows[1].x, (int)__builtin_bswap32(97));
+    BOOST_CHECK(deallocator());
+    H5Tclose(written_type);
+
+    // Excluded leaves are left to the per-entry path
+    vector<string> excluded;
+    excluded.push_back("x");
+    boost::tie(success, filler, deallocator, needs_entry_reads, written_type)
+        = build_bulk_reader(tree, row_type, excluded, false);
+    BOOST_REQUIRE(success);
+    BOOST_CHECK(needs_entry_reads);
+    BOOST_CHECK(deallocator());
+
+    // Clean up
+    H5Tclose(row_type);
+    file->Close();
+    delete file;
+    fs::remove(path);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_counter_branches_stay_entry_read)
+{
+    // Write a tree with a variable-length array and its counter
+    fs::path path = fs::temp_directory_path()
+                    / fs::unique_path("%%%%-%%%%-%%%%-%%%%.root");
+    TFile *file = TFile::Open(path.c_str(), "RECREATE");
+    BOOST_REQUIRE(file != NULL);
+    TTree *tree = new TTree("CounterTree", "Testing Tree");
+    int n;
+    float y;
+    float x[10];
+    tree->Branch("n", &n, "n/I", 64);
+    tree->Branch("y", &y, "y/F", 64);
+    tree->Branch("x", x, "x[n]/F", 64);
+    for(int i = 0; i < 100; i++)
+    {
+        n = i % 10;
+        y = 0.5f * i;
+        for(int j = 0; j < n; j++)
+        {
+            x[j] = j;
+        }
+        tree->Fill();
+    }
+    file->Write();
+    file->Close();
+    delete file;
+
+    // Read it back, offering both scalars for bulk reading
+    file = TFile::Open(path.c_str(), "READ");
+    BOOST_REQUIRE(file != NULL);
+    tree = (TTree *)file->Get("CounterTree");
+    BOOST_REQUIRE(tree != NULL);
+    hid_t row_type = H5Tcreate(H5T_COMPOUND, sizeof(Row));
+    H5Tinsert(row_type, "n", offsetof(Row, x), H5T_NATIVE_INT);
+    H5Tinsert(row_type, "y", offsetof(Row, y), H5T_NATIVE_FLOAT);
+
+    // The counter is left to TTree::GetEntry, while y is still bulk-read
+    bool success = false, needs_entry_reads = false;
+    block_filler filler;
+    root_resource_deallocator deallocator;
+    hid_t written_type = -1;
+    boost::tie(success, filler, deallocator, needs_entry_reads, written_type)
+        = build_bulk_reader(tree, row_type, vector<string>(), false);
+    BOOST_REQUIRE(success);
+    BOOST_REQUIRE(filler);
+    BOOST_CHECK(needs_entry_reads);
+    const Long64_t entries[] = {13, 57};
+    Row rows[2];
+    BOOST_REQUIRE(filler(entries, 2, (char *)rows));
+    for(int i = 0; i < 2; i++)
+    {
+        BOOST_CHECK_EQUAL(rows[i].y, 0.5f * entries[i]);
+    }
+
+    // So the array's length follows the counter entry by entry
+    TLeaf *x_leaf = tree->GetLeaf("x");
+    BOOST_REQUIRE(x_leaf != NULL);
+    for(int i = 0; i < 2; i++)
+    {
+        tree->GetEntry(entries[i]);
+        BOOST_CHECK_EQUAL(x_leaf->GetLen(), entries[i] % 10);
+    }
+    BOOST_CHECK(deallocator());
+
+    // Clean up
+    H5Tclose(row_type);
+    file->Close();
+    delete file;
+    fs::remove(path);
+}
@@ -0,0 +1,92 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_tree_byte_order
+#include <boost/test/unit_test.hpp>
+
+
+// C Standard includes
+#include <stdint.h>
+
+// Standard includes
+#include <string>
+#include <vector>
+
+// HDF5 includes
+#include <hdf5.h>
+
+// root2hdf5 includes
+#include "tree/byte_order.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::byte_order;
+
+
+BOOST_AUTO_TEST_CASE(test_swap_byte_order)
+{
+    // Use an odd count so that any vectorized loop has a remainder
+    const size_t n_values = 37;
+    vector<uint16_t> shorts(n_values), swapped_shorts(n_values);
+    vector<uint32_t> ints(n_values), swapped_ints(n_values);
+    vector<uint64_t> longs(n_values), swapped_longs(n_values);
+    for(size_t i = 0; i < n_values; i++)
+    {
+        shorts[i] = (uint16_t)(0x0102 + i);
+        ints[i] = (uint32_t)(0x01020304 + i);
+        longs[i] = 0x0102030405060708ULL + i;
+    }
+
+    swap_byte_order((const char *)&shorts[0],
+                    (char *)&swapped_shorts[0],
+                    n_values,
+                    2);
+    swap_byte_order((const char *)&ints[0],
+                    (char *)&swapped_ints[0],
+                    n_values,
+                    4);
+    swap_byte_order((const char *)&longs[0],
+                    (char *)&swapped_longs[0],
+                    n_values,
+                    8);
+    for(size_t i = 0; i < n_values; i++)
+    {
+        BOOST_CHECK_EQUAL(swapped_shorts[i], __builtin_bswap16(shorts[i]));
+        BOOST_CHECK_EQUAL(swapped_ints[i], __builtin_bswap32(ints[i]));
+        BOOST_CHECK_EQUAL(swapped_longs[i], __builtin_bswap64(longs[i]));
+    }
+
+    // Single bytes are just copied
+    const char bytes[3] = {1, 2, 3};
+    char copied[3] = {0, 0, 0};
+    swap_byte_order(bytes, copied, 3, 1);
+    BOOST_CHECK_EQUAL(copied[2], 3);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_big_endian_row_type)
+{
+    hid_t row_type = H5Tcreate(H5T_COMPOUND, 16);
+    H5Tinsert(row_type, "a", 0, H5T_NATIVE_INT);
+    H5Tinsert(row_type, "b", 8, H5T_NATIVE_DOUBLE);
+
+    vector<string> members;
+    members.push_back("b");
+    hid_t big_endian_type = big_endian_row_type(row_type, members);
+    BOOST_REQUIRE(big_endian_type >= 0);
+    BOOST_CHECK_EQUAL(H5Tget_size(big_endian_type), 16U);
+
+    // Only the named member changes
+    hid_t a_type = H5Tget_member_type(big_endian_type, 0);
+    hid_t b_type = H5Tget_member_type(big_endian_type, 1);
+    BOOST_CHECK(H5Tequal(a_type, H5T_NATIVE_INT) > 0);
+    BOOST_CHECK(H5Tequal(b_type, H5T_IEEE_F64BE) > 0);
+    BOOST_CHECK_EQUAL(H5Tget_member_offset(big_endian_type, 1), 8U);
+
+    // Clean up
+    H5Tclose(a_type);
+    H5Tclose(b_type);
+    H5Tclose(big_endian_type);
+    H5Tclose(row_type);
+}
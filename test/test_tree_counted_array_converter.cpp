@@ -0,0 +1,91 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_tree_counted_array_converter
+#include <boost/test/unit_test.hpp>
+
+
+// Standard includes
+#include <vector>
+
+// ROOT includes
+#include <TTree.h>
+
+// root2hdf5 includes
+#include "tree/leaf_converters/counted_array_converter.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::map_hdf5;
+using namespace root2hdf5::tree::map_root;
+using namespace root2hdf5::tree::leaf_converters::counted_array_converter;
+
+
+BOOST_AUTO_TEST_CASE(test_counted_array_conversion)
+{
+    // First, create a TTree to experiment with
+    TTree *tree = new TTree("TestTree", "Testing Tree");
+
+    // Create a counter and a counted array branch, and fill a few entries of
+    // different lengths
+    int n = 0;
+    float x[8];
+    tree->Branch("n", &n, "n/I");
+    tree->Branch("x", x, "x[n]/F");
+    for(n = 0; n < 4; n++)
+    {
+        for(int i = 0; i < n; i++)
+        {
+            x[i] = 10 * n + i;
+        }
+        tree->Fill();
+    }
+
+    // The counter is a scalar, the array is ours
+    TLeaf *leaf = tree->GetLeaf("x");
+    BOOST_REQUIRE(can_handle(leaf));
+    BOOST_CHECK(!can_handle(tree->GetLeaf("n")));
+
+    // Check the HDF5 type
+    vector<hdf5_type_deallocator> type_deallocators;
+    hid_t type = hdf5_type_for_leaf(leaf, type_deallocators);
+    BOOST_REQUIRE(type >= 0);
+    BOOST_CHECK_EQUAL(H5Tget_class(type), H5T_VLEN);
+    for(auto it = type_deallocators.rbegin();
+        it != type_deallocators.rend();
+        it++)
+    {
+        BOOST_CHECK((*it)());
+    }
+
+    // Map the leaf and check that each entry's used prefix comes through
+    hvl_t member;
+    vector<root_converter> converters;
+    vector<root_finalizer> finalizers;
+    vector<root_resource_deallocator> deallocators;
+    BOOST_REQUIRE(map_leaf_and_build_converter(leaf,
+                                               &member,
+                                               converters,
+                                               finalizers,
+                                               deallocators));
+    BOOST_REQUIRE_EQUAL(converters.size(), 1U);
+    for(Long64_t entry = 0; entry < tree->GetEntries(); entry++)
+    {
+        tree->GetEntry(entry);
+        BOOST_REQUIRE(converters[0]());
+        BOOST_REQUIRE_EQUAL(member.len, (size_t)entry);
+        for(size_t i = 0; i < member.len; i++)
+        {
+            BOOST_CHECK_EQUAL(((float *)member.p)[i], 10.0f * entry + i);
+        }
+    }
+    tree->ResetBranchAddresses();
+    for(auto it = deallocators.begin(); it != deallocators.end(); it++)
+    {
+        BOOST_CHECK((*it)());
+    }
+
+    // Clean up the tree
+    delete tree;
+}
@@ -0,0 +1,184 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_tree_entry_list
+#include <boost/test/unit_test.hpp>
+
+
+// Standard includes
+#include <string>
+#include <utility>
+#include <vector>
+
+// Boost includes
+// HACK: Need to define this macro to tell Boost not to use deprecated
+// Boost.System constructs which result in unused-variable errors.
+#ifndef BOOST_SYSTEM_NO_DEPRECATED
+#define BOOST_SYSTEM_NO_DEPRECATED 1
+#endif
+#include <boost/any.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+// ROOT includes
+#include <TROOT.h>
+#include <TEntryList.h>
+#include <TFile.h>
+#include <TTree.h>
+
+// HDF5 includes
+#include <hdf5.h>
+
+// root2hdf5 includes
+#include "options.h"
+#include "tree.h"
+#include "tree/index.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// Boost namespace aliases
+namespace fs = boost::filesystem;
+namespace po = boost::program_options;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::index;
+
+
+// Sets an option in the global options map
+void set_option(const string & name, const string & value)
+{
+    root2hdf5::options::options.erase(name);
+    root2hdf5::options::options.insert(
+        make_pair(name, po::variable_value(boost::any(value), false))
+    );
+}
+
+
+// Writes a side file holding a list named "selected" with the entries
+void write_entry_list_file(const fs::path & path,
+                           const vector<Long64_t> & entries)
+{
+    TFile *file = TFile::Open(path.native().c_str(), "RECREATE");
+    BOOST_REQUIRE(file != NULL);
+    TEntryList list("selected", "Selected entries");
+    for(auto it = entries.begin(); it != entries.end(); it++)
+    {
+        list.Enter(*it);
+    }
+    file->WriteTObject(&list);
+    file->Close();
+    delete file;
+    gROOT->cd();
+}
+
+
+// Converts the tree into an in-memory file and reads back its x column and
+// the entry numbers recorded in its index
+void convert_selected(TTree *tree,
+                      vector<int> & values,
+                      vector<Long64_t> & index_rows)
+{
+    hid_t access = H5Pcreate(H5P_FILE_ACCESS);
+    H5Pset_fapl_core(access, 1024 * 1024, 0);
+    hid_t file = H5Fcreate("test_tree_entry_list.h5",
+                           H5F_ACC_TRUNC,
+                           H5P_DEFAULT,
+                           access);
+    H5Pclose(access);
+    BOOST_REQUIRE(file >= 0);
+    BOOST_REQUIRE(root2hdf5::tree::convert(tree, file));
+
+    // Read the x column of the rows
+    hid_t dataset = H5Dopen2(file, tree->GetName(), H5P_DEFAULT);
+    BOOST_REQUIRE(dataset >= 0);
+    hid_t space = H5Dget_space(dataset);
+    values.resize(H5Sget_simple_extent_npoints(space));
+    H5Sclose(space);
+    hid_t type = H5Tcreate(H5T_COMPOUND, sizeof(int));
+    H5Tinsert(type, "x", 0, H5T_NATIVE_INT);
+    BOOST_REQUIRE(values.empty()
+                  || H5Dread(dataset,
+                             type,
+                             H5S_ALL,
+                             H5S_ALL,
+                             H5P_DEFAULT,
+                             &values[0]) >= 0);
+    H5Tclose(type);
+    H5Dclose(dataset);
+
+    // Read the rows recorded in the index, which is sorted by x
+    dataset = H5Dopen2(file, index_dataset_name(tree).c_str(), H5P_DEFAULT);
+    BOOST_REQUIRE(dataset >= 0);
+    space = H5Dget_space(dataset);
+    index_rows.resize(H5Sget_simple_extent_npoints(space));
+    H5Sclose(space);
+    type = H5Tcreate(H5T_COMPOUND, sizeof(Long64_t));
+    H5Tinsert(type, "entry", 0, H5T_NATIVE_LLONG);
+    BOOST_REQUIRE(index_rows.empty()
+                  || H5Dread(dataset,
+                             type,
+                             H5S_ALL,
+                             H5S_ALL,
+                             H5P_DEFAULT,
+                             &index_rows[0]) >= 0);
+    H5Tclose(type);
+    H5Dclose(dataset);
+
+    H5Fclose(file);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_entry_list_conversion)
+{
+    // Write two side files selecting different entries
+    fs::path directory = fs::temp_directory_path() / fs::unique_path();
+    fs::create_directories(directory);
+    vector<Long64_t> first_entries = {1, 3, 4};
+    vector<Long64_t> second_entries = {0, 5};
+    write_entry_list_file(directory / "first.root", first_entries);
+    write_entry_list_file(directory / "second.root", second_entries);
+
+    // Create a tree whose x values count down, so that the index order
+    // differs from the row order
+    TTree *tree = new TTree("EntryListTree", "Testing Tree");
+    int x = 0;
+    tree->Branch("x", &x, "x/I");
+    for(int i = 0; i < 6; i++)
+    {
+        x = 100 - i;
+        tree->Fill();
+    }
+
+    // Only the selected entries become rows, in order, and the index refers
+    // to rows rather than to entries
+    set_option("entry-list", "selected");
+    set_option("entry-list-file", (directory / "first.root").native());
+    set_option("index", "x");
+    vector<int> values;
+    vector<Long64_t> index_rows;
+    convert_selected(tree, values, index_rows);
+    BOOST_REQUIRE_EQUAL(values.size(), 3u);
+    BOOST_CHECK_EQUAL(values[0], 99);
+    BOOST_CHECK_EQUAL(values[1], 97);
+    BOOST_CHECK_EQUAL(values[2], 96);
+    BOOST_REQUIRE_EQUAL(index_rows.size(), 3u);
+    BOOST_CHECK_EQUAL(index_rows[0], 2);
+    BOOST_CHECK_EQUAL(index_rows[1], 1);
+    BOOST_CHECK_EQUAL(index_rows[2], 0);
+
+    // A later conversion with another side file takes its lists from that
+    // file instead
+    set_option("entry-list-file", (directory / "second.root").native());
+    convert_selected(tree, values, index_rows);
+    BOOST_REQUIRE_EQUAL(values.size(), 2u);
+    BOOST_CHECK_EQUAL(values[0], 100);
+    BOOST_CHECK_EQUAL(values[1], 95);
+    BOOST_REQUIRE_EQUAL(index_rows.size(), 2u);
+    BOOST_CHECK_EQUAL(index_rows[0], 1);
+    BOOST_CHECK_EQUAL(index_rows[1], 0);
+
+    // Clean up
+    root2hdf5::options::options.clear();
+    delete tree;
+    fs::remove_all(directory);
+}
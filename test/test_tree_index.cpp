@@ -0,0 +1,106 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_tree_index
+#include <boost/test/unit_test.hpp>
+
+
+// Standard includes
+#include <string>
+#include <vector>
+
+// ROOT includes
+#include <TTree.h>
+
+// HDF5 includes
+#include <hdf5.h>
+
+// root2hdf5 includes
+#include "tree/index.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::map_root;
+using namespace root2hdf5::tree::index;
+
+
+BOOST_AUTO_TEST_CASE(test_sorted_index_with_spilling)
+{
+    // First, create a TTree to experiment with, with entries out of order
+    TTree *tree = new TTree("IndexTree", "Testing Tree");
+    int run, event;
+    tree->Branch("run", &run, "run/I");
+    tree->Branch("event", &event, "event/I");
+    const int runs[] = {2, 1, 2, 1, 1};
+    const int events[] = {5, 9, 1, 3, 4};
+    for(int i = 0; i < 5; i++)
+    {
+        run = runs[i];
+        event = events[i];
+        tree->Fill();
+    }
+
+    // Build the index with room for only two records in memory, so that it
+    // has to spill and merge
+    vector<string> columns;
+    columns.push_back("run");
+    columns.push_back("event");
+    bool success = false;
+    index_collector collector;
+    root_finalizer finalizer;
+    boost::tie(success, collector, finalizer)
+        = build_index(tree, columns, 2 * sizeof(index_record));
+    BOOST_REQUIRE(success);
+    for(Long64_t entry = 0; entry < tree->GetEntries(); entry++)
+    {
+        tree->GetEntry(entry);
+        BOOST_REQUIRE(collector(entry));
+    }
+
+    // Write it to an in-memory HDF5 file
+    hid_t access = H5Pcreate(H5P_FILE_ACCESS);
+    H5Pset_fapl_core(access, 1024 * 1024, 0);
+    hid_t file = H5Fcreate("test_tree_index.h5",
+                           H5F_ACC_TRUNC,
+                           H5P_DEFAULT,
+                           access);
+    BOOST_REQUIRE(file >= 0);
+    BOOST_REQUIRE(finalizer(file));
+
+    // Read it back and check the order
+    hid_t dataset = H5Dopen2(file,
+                             index_dataset_name(tree).c_str(),
+                             H5P_DEFAULT);
+    BOOST_REQUIRE(dataset >= 0);
+    struct
+    {
+        Long64_t run;
+        Long64_t event;
+        Long64_t entry;
+    } records[5];
+    hid_t type = H5Tcreate(H5T_COMPOUND, sizeof(records[0]));
+    H5Tinsert(type, "run", 0, H5T_NATIVE_LLONG);
+    H5Tinsert(type, "event", sizeof(Long64_t), H5T_NATIVE_LLONG);
+    H5Tinsert(type, "entry", 2 * sizeof(Long64_t), H5T_NATIVE_LLONG);
+    BOOST_REQUIRE(H5Dread(dataset,
+                          type,
+                          H5S_ALL,
+                          H5S_ALL,
+                          H5P_DEFAULT,
+                          records) >= 0);
+    const Long64_t expected_entries[] = {3, 4, 1, 2, 0};
+    for(int i = 0; i < 5; i++)
+    {
+        BOOST_CHECK_EQUAL(records[i].entry, expected_entries[i]);
+        BOOST_CHECK_EQUAL(records[i].run, runs[expected_entries[i]]);
+        BOOST_CHECK_EQUAL(records[i].event, events[expected_entries[i]]);
+    }
+
+    // Clean up
+    H5Tclose(type);
+    H5Dclose(dataset);
+    H5Fclose(file);
+    H5Pclose(access);
+    delete tree;
+}
@@ -0,0 +1,132 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_tree_pack
+#include <boost/test/unit_test.hpp>
+
+
+// C Standard includes
+#include <cstring>
+
+// Standard includes
+#include <cstddef>
+#include <vector>
+
+// HDF5 includes
+#include <hdf5.h>
+
+// root2hdf5 includes
+#include "tree/pack.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::pack;
+
+
+struct Inner
+{
+    char a;
+    int b;
+};
+
+
+struct Row
+{
+    char flag;
+    double x;
+    short s;
+    Inner inner;
+};
+
+
+hid_t create_row_type()
+{
+    hid_t inner = H5Tcreate(H5T_COMPOUND, sizeof(Inner));
+    H5Tinsert(inner, "a", offsetof(Inner, a), H5T_NATIVE_SCHAR);
+    H5Tinsert(inner, "b", offsetof(Inner, b), H5T_NATIVE_INT);
+    hid_t type = H5Tcreate(H5T_COMPOUND, sizeof(Row));
+    H5Tinsert(type, "flag", offsetof(Row, flag), H5T_NATIVE_SCHAR);
+    H5Tinsert(type, "x", offsetof(Row, x), H5T_NATIVE_DOUBLE);
+    H5Tinsert(type, "s", offsetof(Row, s), H5T_NATIVE_SHORT);
+    H5Tinsert(type, "inner", offsetof(Row, inner), inner);
+    H5Tclose(inner);
+    return type;
+}
+
+
+BOOST_AUTO_TEST_CASE(test_packed_type)
+{
+    // Padding is dropped, including inside the nested compound
+    hid_t type = create_row_type();
+    hid_t packed = packed_type(type);
+    BOOST_REQUIRE(packed >= 0);
+    BOOST_CHECK_EQUAL(H5Tget_size(packed), 1U + 8U + 2U + 1U + 4U);
+    BOOST_CHECK_EQUAL(H5Tget_member_offset(packed, 1), 1U);
+    BOOST_CHECK_EQUAL(H5Tget_member_offset(packed, 3), 11U);
+    H5Tclose(packed);
+    H5Tclose(type);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_gather_rows)
+{
+    hid_t type = create_row_type();
+    hid_t packed = packed_type(type);
+    packed_layout layout;
+    BOOST_REQUIRE(build_packed_layout(type, packed, layout));
+    BOOST_CHECK(!layout.identity);
+    BOOST_CHECK_EQUAL(layout.packed_size, H5Tget_size(packed));
+
+    // Gather some rows and let HDF5 read them back into the padded layout,
+    // which checks that the gathered bytes match the packed type
+    Row rows[3];
+    memset(rows, 0, sizeof(rows));
+    for(int i = 0; i < 3; i++)
+    {
+        rows[i].flag = (char)i;
+        rows[i].x = 1.5 * i;
+        rows[i].s = (short)(-i);
+        rows[i].inner.a = (char)(10 + i);
+        rows[i].inner.b = 1000 * i;
+    }
+    vector<char> buffer(3 * layout.packed_size);
+    gather_rows(layout, (const char *)rows, 3, &buffer[0]);
+    Row converted[3], background[3];
+    memset(converted, 0, sizeof(converted));
+    memset(background, 0, sizeof(background));
+    memcpy(converted, &buffer[0], buffer.size());
+    BOOST_REQUIRE(H5Tconvert(packed,
+                             type,
+                             3,
+                             converted,
+                             background,
+                             H5P_DEFAULT) >= 0);
+    for(int i = 0; i < 3; i++)
+    {
+        BOOST_CHECK_EQUAL(converted[i].flag, rows[i].flag);
+        BOOST_CHECK_EQUAL(converted[i].x, rows[i].x);
+        BOOST_CHECK_EQUAL(converted[i].s, rows[i].s);
+        BOOST_CHECK_EQUAL(converted[i].inner.a, rows[i].inner.a);
+        BOOST_CHECK_EQUAL(converted[i].inner.b, rows[i].inner.b);
+    }
+
+    H5Tclose(packed);
+    H5Tclose(type);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_identity_layout)
+{
+    // Rows without padding are written as they are
+    hid_t type = H5Tcreate(H5T_COMPOUND, 2 * sizeof(int));
+    H5Tinsert(type, "a", 0, H5T_NATIVE_INT);
+    H5Tinsert(type, "b", sizeof(int), H5T_NATIVE_INT);
+    hid_t packed = packed_type(type);
+    packed_layout layout;
+    BOOST_REQUIRE(build_packed_layout(type, packed, layout));
+    BOOST_CHECK(layout.identity);
+    BOOST_CHECK_EQUAL(layout.runs.size(), 1U);
+    H5Tclose(packed);
+    H5Tclose(type);
+}
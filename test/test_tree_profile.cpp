@@ -0,0 +1,57 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_tree_profile
+#include <boost/test/unit_test.hpp>
+
+
+// Standard includes
+#include <string>
+#include <vector>
+
+// root2hdf5 includes
+#include "tree/profile.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::profile;
+
+
+branch_profile make_profile(const string & name,
+                            double read_seconds,
+                            double convert_seconds)
+{
+    branch_profile result;
+    result.name = name;
+    result.read_seconds = read_seconds;
+    result.convert_seconds = convert_seconds;
+    result.bytes_read = 0;
+    result.zip_bytes = 0;
+    result.tot_bytes = 0;
+    result.row_bytes = 0;
+    return result;
+}
+
+
+BOOST_AUTO_TEST_CASE(test_most_expensive_branches)
+{
+    vector<branch_profile> profiles;
+    profiles.push_back(make_profile("cheap", 0.1, 0.0));
+    profiles.push_back(make_profile("slow_read", 2.0, 0.5));
+    profiles.push_back(make_profile("slow_convert", 0.5, 1.5));
+    profiles.push_back(make_profile("also_cheap", 0.1, 0.0));
+
+    // Branches are ranked by their combined read and conversion time
+    vector<branch_profile> top = most_expensive_branches(profiles, 2);
+    BOOST_REQUIRE_EQUAL(top.size(), 2U);
+    BOOST_CHECK_EQUAL(top[0].name, "slow_read");
+    BOOST_CHECK_EQUAL(top[1].name, "slow_convert");
+
+    // Asking for more than there are returns them all, with ties kept in
+    // their original order
+    top = most_expensive_branches(profiles, 10);
+    BOOST_REQUIRE_EQUAL(top.size(), 4U);
+    BOOST_CHECK_EQUAL(top[2].name, "cheap");
+    BOOST_CHECK_EQUAL(top[3].name, "also_cheap");
+}
@@ -0,0 +1,186 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_tree_split
+#include <boost/test/unit_test.hpp>
+
+
+// Standard includes
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// HDF5 includes
+#include <hdf5.h>
+
+// root2hdf5 includes
+#include "tree/split.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::split;
+
+
+struct Row
+{
+    int run;
+    float jet_pt;
+    double el_pt;
+    float jet_eta;
+};
+
+
+hid_t create_row_type()
+{
+    hid_t type = H5Tcreate(H5T_COMPOUND, sizeof(Row));
+    H5Tinsert(type, "run", offsetof(Row, run), H5T_NATIVE_INT);
+    H5Tinsert(type, "jet_pt", offsetof(Row, jet_pt), H5T_NATIVE_FLOAT);
+    H5Tinsert(type, "el_pt", offsetof(Row, el_pt), H5T_NATIVE_DOUBLE);
+    H5Tinsert(type, "jet_eta", offsetof(Row, jet_eta), H5T_NATIVE_FLOAT);
+    return type;
+}
+
+
+BOOST_AUTO_TEST_CASE(test_group_by_prefix)
+{
+    hid_t type = create_row_type();
+    vector<column_group> groups = group_by_prefix(type);
+    BOOST_REQUIRE_EQUAL(groups.size(), 3U);
+    BOOST_CHECK_EQUAL(groups[0].suffix, string(""));
+    BOOST_CHECK_EQUAL(groups[1].suffix, string("jet"));
+    BOOST_CHECK_EQUAL(groups[2].suffix, string("el"));
+    BOOST_REQUIRE_EQUAL(groups[1].members.size(), 2U);
+    BOOST_CHECK_EQUAL(groups[1].members[0], 1U);
+    BOOST_CHECK_EQUAL(groups[1].members[1], 3U);
+    H5Tclose(type);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_group_by_width)
+{
+    // Members are 4, 4, 8 and 4 bytes wide
+    hid_t type = create_row_type();
+    vector<column_group> groups = group_by_width(type, 8);
+    BOOST_REQUIRE_EQUAL(groups.size(), 3U);
+    BOOST_CHECK_EQUAL(groups[0].suffix, string("0"));
+    BOOST_CHECK_EQUAL(groups[0].members.size(), 2U);
+    BOOST_CHECK_EQUAL(groups[1].members.size(), 1U);
+    BOOST_CHECK_EQUAL(groups[2].suffix, string("2"));
+    BOOST_CHECK_EQUAL(groups[2].members.size(), 1U);
+    H5Tclose(type);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_write_column_group)
+{
+    hid_t type = create_row_type();
+    vector<column_group> groups = group_by_prefix(type);
+
+    // The memory type spans whole rows, and the file type is packed
+    hid_t file_type = -1, memory_type = -1;
+    boost::tie(file_type, memory_type) = types_for_column_group(type,
+                                                                groups[1]);
+    BOOST_REQUIRE(file_type >= 0 && memory_type >= 0);
+    BOOST_CHECK_EQUAL(H5Tget_size(memory_type), sizeof(Row));
+    BOOST_CHECK_EQUAL(H5Tget_size(file_type), 2 * sizeof(float));
+
+    // Write rows through it to an in-memory file and read the group back
+    hid_t access = H5Pcreate(H5P_FILE_ACCESS);
+    H5Pset_fapl_core(access, 1024 * 1024, 0);
+    hid_t file = H5Fcreate("test_tree_split.h5",
+                           H5F_ACC_TRUNC,
+                           H5P_DEFAULT,
+                           access);
+    BOOST_REQUIRE(file >= 0);
+    hsize_t n_rows = 2;
+    hid_t space = H5Screate_simple(1, &n_rows, NULL);
+    hid_t dataset = H5Dcreate2(file,
+                               "events.jet",
+                               file_type,
+                               space,
+                               H5P_DEFAULT,
+                               H5P_DEFAULT,
+                               H5P_DEFAULT);
+    BOOST_REQUIRE(dataset >= 0);
+    Row rows[2] = {{1, 10.0f, 5.0, 0.5f}, {2, 20.0f, 6.0, -0.5f}};
+    BOOST_REQUIRE(H5Dwrite(dataset,
+                           memory_type,
+                           H5S_ALL,
+                           H5S_ALL,
+                           H5P_DEFAULT,
+                           rows) >= 0);
+    float read_back[4];
+    BOOST_REQUIRE(H5Dread(dataset,
+                          file_type,
+                          H5S_ALL,
+                          H5S_ALL,
+                          H5P_DEFAULT,
+                          read_back) >= 0);
+    BOOST_CHECK_EQUAL(read_back[0], 10.0f);
+    BOOST_CHECK_EQUAL(read_back[1], 0.5f);
+    BOOST_CHECK_EQUAL(read_back[2], 20.0f);
+    BOOST_CHECK_EQUAL(read_back[3], -0.5f);
+
+    // Clean up
+    H5Dclose(dataset);
+    H5Sclose(space);
+    H5Fclose(file);
+    H5Pclose(access);
+    H5Tclose(file_type);
+    H5Tclose(memory_type);
+    H5Tclose(type);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_group_by_prefix_avoids_side_datasets)
+{
+    hid_t type = H5Tcreate(H5T_COMPOUND, 2 * sizeof(int));
+    H5Tinsert(type, "index_run", 0, H5T_NATIVE_INT);
+    H5Tinsert(type, "statistics_n", sizeof(int), H5T_NATIVE_INT);
+    vector<column_group> groups = group_by_prefix(type);
+    BOOST_REQUIRE_EQUAL(groups.size(), 2U);
+    BOOST_CHECK_EQUAL(groups[0].suffix, string("index_"));
+    BOOST_CHECK_EQUAL(groups[1].suffix, string("statistics_"));
+    H5Tclose(type);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_group_by_description_size)
+{
+    // Many one-byte flags with long names make a narrow row with a huge
+    // type description
+    const unsigned n_flags = 2048;
+    hid_t type = H5Tcreate(H5T_COMPOUND, n_flags);
+    for(unsigned i = 0; i < n_flags; i++)
+    {
+        stringstream name;
+        name << "trigger_flag_with_a_rather_long_descriptive_name_" << i;
+        H5Tinsert(type, name.str().c_str(), i, H5T_NATIVE_SCHAR);
+    }
+    size_t description_bytes = 0;
+    BOOST_REQUIRE(H5Tencode(type, NULL, &description_bytes) >= 0);
+    BOOST_REQUIRE(description_bytes > max_type_description_bytes);
+
+    // Splitting by width wouldn't split it at all, but every automatic group
+    // must be small enough to describe
+    BOOST_CHECK_EQUAL(group_by_width(type, n_flags).size(), 1U);
+    vector<column_group> groups = column_groups_for_type(type);
+    BOOST_REQUIRE(groups.size() > 1);
+    unsigned n_members = 0;
+    for(auto it = groups.begin(); it != groups.end(); it++)
+    {
+        hid_t file_type = -1, memory_type = -1;
+        boost::tie(file_type, memory_type) = types_for_column_group(type, *it);
+        BOOST_REQUIRE(file_type >= 0 && memory_type >= 0);
+        size_t group_bytes = 0;
+        BOOST_REQUIRE(H5Tencode(file_type, NULL, &group_bytes) >= 0);
+        BOOST_CHECK(group_bytes <= default_group_description_bytes);
+        n_members += it->members.size();
+        H5Tclose(file_type);
+        H5Tclose(memory_type);
+    }
+    BOOST_CHECK_EQUAL(n_members, n_flags);
+    H5Tclose(type);
+}
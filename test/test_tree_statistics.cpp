@@ -0,0 +1,144 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_tree_statistics
+#include <boost/test/unit_test.hpp>
+
+
+// C Standard includes
+#include <cmath>
+
+// Standard includes
+#include <cstddef>
+#include <limits>
+
+// ROOT includes
+#include <TTree.h>
+
+// HDF5 includes
+#include <hdf5.h>
+
+// root2hdf5 includes
+#include "tree/statistics.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::map_root;
+using namespace root2hdf5::tree::statistics;
+
+
+BOOST_AUTO_TEST_CASE(test_value_range)
+{
+    // Integers
+    const int integers[] = {4, -2, 9, 0};
+    int integer_minimum, integer_maximum;
+    BOOST_CHECK_EQUAL(
+        value_range(integers, 4, integer_minimum, integer_maximum),
+        0U
+    );
+    BOOST_CHECK_EQUAL(integer_minimum, -2);
+    BOOST_CHECK_EQUAL(integer_maximum, 9);
+
+    // Floats with NaNs, which are ignored
+    const double nan = numeric_limits<double>::quiet_NaN();
+    const double floats[] = {nan, 1.5, -3.0, nan, 2.0};
+    double float_minimum, float_maximum;
+    BOOST_CHECK_EQUAL(value_range(floats, 5, float_minimum, float_maximum),
+                      2U);
+    BOOST_CHECK_EQUAL(float_minimum, -3.0);
+    BOOST_CHECK_EQUAL(float_maximum, 2.0);
+
+    // Only NaNs
+    BOOST_CHECK_EQUAL(value_range(floats, 1, float_minimum, float_maximum),
+                      1U);
+    BOOST_CHECK(std::isnan(float_minimum));
+    BOOST_CHECK(std::isnan(float_maximum));
+}
+
+
+BOOST_AUTO_TEST_CASE(test_bloom_filter)
+{
+    unsigned long long filter[bloom_filter_words] = {0};
+    for(Long64_t value = 100; value < 200; value += 10)
+    {
+        bloom_filter_insert(filter, value);
+    }
+
+    // No false negatives
+    for(Long64_t value = 100; value < 200; value += 10)
+    {
+        BOOST_CHECK(bloom_filter_may_contain(filter, value));
+    }
+
+    // Few false positives with ten values in a 1024 bit filter
+    unsigned n_false_positives = 0;
+    for(Long64_t value = 1000; value < 2000; value++)
+    {
+        n_false_positives += bloom_filter_may_contain(filter, value);
+    }
+    BOOST_CHECK_LT(n_false_positives, 50U);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_big_endian_columns)
+{
+    // Columns kept big-endian (as with --big-endian) still get statistics,
+    // in native byte order
+    struct Row
+    {
+        int x;
+        double y;
+    };
+    hid_t row_type = H5Tcreate(H5T_COMPOUND, sizeof(Row));
+    H5Tinsert(row_type, "x", offsetof(Row, x), H5T_STD_I32BE);
+    H5Tinsert(row_type, "y", offsetof(Row, y), H5T_NATIVE_DOUBLE);
+    Row rows[4];
+    for(int i = 0; i < 4; i++)
+    {
+        rows[i].x = (int)__builtin_bswap32((unsigned)(100 * i - 50));
+        rows[i].y = 0.5 * i;
+    }
+
+    TTree *tree = new TTree("StatisticsTree", "Testing Tree");
+    bool success = false;
+    block_observer observer;
+    root_finalizer finalizer;
+    boost::tie(success, observer, finalizer) = build_statistics(tree,
+                                                                row_type,
+                                                                4);
+    BOOST_REQUIRE(success);
+    BOOST_REQUIRE(observer((const char *)rows, 4));
+
+    // Write the statistics to an in-memory file and read them back
+    hid_t access = H5Pcreate(H5P_FILE_ACCESS);
+    H5Pset_fapl_core(access, 1024, 0);
+    hid_t file = H5Fcreate("statistics", H5F_ACC_TRUNC, H5P_DEFAULT, access);
+    H5Pclose(access);
+    BOOST_REQUIRE(file >= 0);
+    BOOST_REQUIRE(finalizer(file));
+    hid_t dataset = H5Dopen2(file, "StatisticsTree.statistics", H5P_DEFAULT);
+    BOOST_REQUIRE(dataset >= 0);
+    hid_t x_range = H5Tcreate(H5T_COMPOUND, 2 * sizeof(int));
+    H5Tinsert(x_range, "min", 0, H5T_NATIVE_INT);
+    H5Tinsert(x_range, "max", sizeof(int), H5T_NATIVE_INT);
+    hid_t read_type = H5Tcreate(H5T_COMPOUND, 2 * sizeof(int));
+    H5Tinsert(read_type, "x", 0, x_range);
+    int range[2] = {0, 0};
+    BOOST_REQUIRE(H5Dread(dataset,
+                          read_type,
+                          H5S_ALL,
+                          H5S_ALL,
+                          H5P_DEFAULT,
+                          range) >= 0);
+    BOOST_CHECK_EQUAL(range[0], -50);
+    BOOST_CHECK_EQUAL(range[1], 250);
+
+    // Clean up
+    H5Tclose(read_type);
+    H5Tclose(x_range);
+    H5Dclose(dataset);
+    H5Fclose(file);
+    H5Tclose(row_type);
+    delete tree;
+}
@@ -0,0 +1,142 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_tree_string_converter
+#include <boost/test/unit_test.hpp>
+
+
+// Standard includes
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// ROOT includes
+#include <TTree.h>
+
+// root2hdf5 includes
+#include "tree/leaf_converters/string_converter.h"
+#include "tree/leaf_converters/string_dictionary_converter.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::map_root;
+using namespace root2hdf5::tree::leaf_converters;
+
+
+BOOST_AUTO_TEST_CASE(test_string_dictionary_encoding)
+{
+    // First, create a TTree to experiment with
+    TTree *tree = new TTree("StringTree", "Testing Tree");
+
+    // Create a string branch with few unique values and one with only unique
+    // values
+    char label[16];
+    char name[16];
+    tree->Branch("label", label, "label/C");
+    tree->Branch("name", name, "name/C");
+    const char *labels[] = {"muon", "electron", "muon", "muon"};
+    for(int i = 0; i < 4; i++)
+    {
+        snprintf(label, sizeof(label), "%s", labels[i]);
+        snprintf(name, sizeof(name), "event_%d", i);
+        tree->Fill();
+    }
+
+    // Until the encodings are chosen, every string leaf is a plain string,
+    // and nothing is read to decide that
+    TLeaf *label_leaf = tree->GetLeaf("label");
+    TLeaf *name_leaf = tree->GetLeaf("name");
+    BOOST_CHECK_EQUAL(string_converter::kind_of_string_leaf(label_leaf),
+                      string_converter::c_string_leaf);
+    BOOST_CHECK(string_converter::can_handle(label_leaf));
+    BOOST_CHECK(!string_dictionary_converter::can_handle(label_leaf));
+
+    // Check which converter takes which once they are
+    BOOST_REQUIRE(string_converter::choose_string_encodings(tree));
+    BOOST_REQUIRE(string_dictionary_converter::can_handle(label_leaf));
+    BOOST_CHECK(!string_converter::can_handle(label_leaf));
+    BOOST_CHECK(!string_dictionary_converter::can_handle(name_leaf));
+    BOOST_CHECK(string_converter::can_handle(name_leaf));
+    BOOST_CHECK_EQUAL(
+        string_dictionary_converter::member_for_conversion_struct(label_leaf),
+        string("Int_t label;")
+    );
+    BOOST_CHECK_EQUAL(
+        string_dictionary_converter::dictionary_dataset_name(label_leaf),
+        string("StringTree.label.dictionary")
+    );
+
+    // Map the dictionary leaf and check the codes, which are assigned in
+    // order of first appearance
+    Int_t code = -1;
+    vector<root_converter> converters;
+    vector<root_finalizer> finalizers;
+    vector<root_resource_deallocator> deallocators;
+    BOOST_REQUIRE(string_dictionary_converter::map_leaf_and_build_converter(
+        label_leaf,
+        &code,
+        converters,
+        finalizers,
+        deallocators
+    ));
+    BOOST_REQUIRE_EQUAL(converters.size(), 1U);
+    BOOST_CHECK_EQUAL(finalizers.size(), 1U);
+    const Int_t expected_codes[] = {0, 1, 0, 0};
+    for(Long64_t entry = 0; entry < tree->GetEntries(); entry++)
+    {
+        tree->GetEntry(entry);
+        BOOST_REQUIRE(converters[0]());
+        BOOST_CHECK_EQUAL(code, expected_codes[entry]);
+    }
+    for(auto it = deallocators.rbegin(); it != deallocators.rend(); it++)
+    {
+        BOOST_CHECK((*it)());
+    }
+
+    // Clean up the tree
+    delete tree;
+}
+
+
+BOOST_AUTO_TEST_CASE(test_leaflist_siblings_keep_addresses)
+{
+    // Create a leaflist branch holding a string next to a number
+    TTree *tree = new TTree("LeaflistTree", "Testing Tree");
+    struct
+    {
+        Int_t n;
+        char label[16];
+    } record;
+    tree->Branch("record", &record, "n/I:label/C");
+    record.n = 7;
+    snprintf(record.label, sizeof(record.label), "%s", "muon");
+    tree->Fill();
+
+    // Map the string leaf, as conversion would, and unmap it again
+    TLeaf *n_leaf = tree->GetLeaf("n");
+    TLeaf *label_leaf = tree->GetLeaf("label");
+    Int_t n = 0;
+    n_leaf->SetAddress(&n);
+    char *label = NULL;
+    vector<root_converter> converters;
+    vector<root_finalizer> finalizers;
+    vector<root_resource_deallocator> deallocators;
+    BOOST_REQUIRE(string_converter::map_leaf_and_build_converter(
+        label_leaf,
+        &label,
+        converters,
+        finalizers,
+        deallocators
+    ));
+    for(auto it = deallocators.rbegin(); it != deallocators.rend(); it++)
+    {
+        BOOST_CHECK((*it)());
+    }
+
+    // The sibling leaf should still be mapped where it was
+    BOOST_CHECK(n_leaf->GetValuePointer() == &n);
+
+    // Clean up the tree
+    delete tree;
+}
@@ -12,6 +12,7 @@
 
 // root2hdf5 includes
 #include "tree/structure.h"
+#include "tree/leaf_converters.h"
 
 
 // Standard namespaces
@@ -19,6 +20,7 @@ using namespace std;
 
 // root2hdf5 namespaces
 using namespace root2hdf5::tree::structure;
+using namespace root2hdf5::tree::leaf_converters;
 
 
 struct ComplexBranch
@@ -57,3 +59,28 @@ BOOST_AUTO_TEST_CASE(test_walk_tree)
     // Clean up the tree
     delete tree;
 }
+
+
+BOOST_AUTO_TEST_CASE(test_struct_name_tracks_members)
+{
+    TTree *tree = new TTree("MembersTree", "Testing Tree");
+    int x;
+    tree->Branch("x", &x, "x/I");
+    string original_name = struct_type_name_for_tree(tree);
+    string original_signature = schema_signature_for_tree(tree);
+
+    // A converter which keeps the name of the scalar converter, but changes
+    // the member it generates, must not share the struct (and therefore the
+    // cached layout) of the original
+    leaf_converter *scalar = find_converter(tree->GetLeaf("x"));
+    BOOST_REQUIRE(scalar != NULL);
+    leaf_converter changed = *scalar;
+    changed.member_for_conversion_struct = [](TLeaf *leaf) -> string {
+        return string("Long64_t ") + leaf->GetName() + ";";
+    };
+    register_converter(changed);
+    BOOST_CHECK_EQUAL(schema_signature_for_tree(tree), original_signature);
+    BOOST_CHECK(struct_type_name_for_tree(tree) != original_name);
+
+    delete tree;
+}
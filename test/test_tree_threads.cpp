@@ -0,0 +1,105 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_tree_threads
+#include <boost/test/unit_test.hpp>
+
+
+// Boost includes
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+
+// ROOT includes
+#include <TFile.h>
+#include <TTree.h>
+#include <TTreeCacheUnzip.h>
+
+// root2hdf5 includes
+#include "options.h"
+#include "tree/threads.h"
+
+
+// Standard namespaces
+using namespace std;
+
+// Boost namespace aliases
+namespace fs = boost::filesystem;
+namespace po = boost::program_options;
+
+// root2hdf5 namespaces
+using namespace root2hdf5::tree::threads;
+
+
+BOOST_AUTO_TEST_CASE(test_single_threaded_by_default)
+{
+    // Without --read-threads, nothing should change
+    BOOST_CHECK_EQUAL(read_threads(), 0u);
+    BOOST_CHECK(enable_read_threads());
+
+    // Nor should the tree cache be touched
+    TTree *tree = new TTree("ThreadsTree", "Testing Tree");
+    int x = 0;
+    tree->Branch("x", &x, "x/I");
+    tree->Fill();
+    Long64_t cache_size = tree->GetCacheSize();
+    prefetch_clusters(tree);
+    BOOST_CHECK_EQUAL(tree->GetCacheSize(), cache_size);
+    delete tree;
+}
+
+
+BOOST_AUTO_TEST_CASE(test_prefetch_before_entry_list_cache)
+{
+    // Write a tree to read back through a cache
+    fs::path path = fs::temp_directory_path()
+                    / fs::unique_path("%%%%-%%%%-%%%%-%%%%.root");
+    TFile *file = TFile::Open(path.c_str(), "RECREATE");
+    BOOST_REQUIRE(file != NULL);
+    TTree *tree = new TTree("ThreadsTree", "Testing Tree");
+    int x = 0;
+    tree->Branch("x", &x, "x/I", 64);
+    for(x = 0; x < 100; x++)
+    {
+        tree->Fill();
+    }
+    file->Write();
+    file->Close();
+    delete file;
+    file = TFile::Open(path.c_str(), "READ");
+    BOOST_REQUIRE(file != NULL);
+    tree = (TTree *)file->Get("ThreadsTree");
+    BOOST_REQUIRE(tree != NULL);
+
+    // Ask for a thread pool, which ROOT may have been built without
+    root2hdf5::options::options.insert(
+        make_pair("read-threads",
+                  po::variable_value(boost::any(2u), false))
+    );
+    BOOST_CHECK_EQUAL(read_threads(), 2u);
+    bool threaded = enable_read_threads();
+
+    // Prefetching sets up a cache, which unzips in parallel given threads
+    prefetch_clusters(tree);
+    BOOST_CHECK(tree->GetCacheSize() > 0);
+    BOOST_REQUIRE(tree->GetReadCache(file) != NULL);
+    if(threaded)
+    {
+        BOOST_CHECK(dynamic_cast<TTreeCacheUnzip *>(tree->GetReadCache(file))
+                    != NULL);
+    }
+
+    // Configuring it afterwards for an entry list, as the conversion does,
+    // refines the same cache rather than replacing it
+    TTreeCache *cache = tree->GetReadCache(file);
+    tree->SetCacheSize();
+    tree->SetCacheEntryRange(10, 50);
+    BOOST_CHECK(tree->GetReadCache(file) == cache);
+    for(Long64_t entry = 10; entry < 50; entry++)
+    {
+        BOOST_REQUIRE(tree->GetEntry(entry) > 0);
+    }
+
+    // Clean up
+    root2hdf5::options::options.erase("read-threads");
+    file->Close();
+    delete file;
+    fs::remove(path);
+}
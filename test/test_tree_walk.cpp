@@ -79,3 +79,46 @@ BOOST_AUTO_TEST_CASE(test_walk_tree)
     // Clean up the tree
     delete tree;
 }
+
+
+BOOST_AUTO_TEST_CASE(test_walk_tree_with_friend)
+{
+    // Create a tree and a friend which shares its run branch
+    TTree *tree = new TTree("MainTree", "Testing Tree");
+    int run;
+    tree->Branch("run", &run, "run/I");
+    double x;
+    tree->Branch("x", &x, "x/D");
+    TTree *friend_tree = new TTree("FriendTree", "Testing Friend Tree");
+    int friend_run;
+    friend_tree->Branch("run", &friend_run, "run/I");
+    float score;
+    friend_tree->Branch("score", &score, "score/F");
+    tree->AddFriend(friend_tree);
+
+    // Walk, recording the leaves
+    vector<string> map;
+    walk_tree(
+        tree,
+        [](TBranch *branch) -> bool {
+            (void)branch;
+            return true;
+        },
+        [&map](TLeaf *leaf) -> bool {
+            map.push_back(leaf->GetName());
+            return true;
+        },
+        [](TBranch *branch) -> bool {
+            (void)branch;
+            return true;
+        }
+    );
+
+    // The friend's run branch is skipped in favor of the tree's own
+    const vector<string> expected = {"run", "x", "score"};
+    BOOST_REQUIRE(map == expected);
+
+    // Clean up the trees
+    delete tree;
+    delete friend_tree;
+}